@@ -14,6 +14,7 @@ SUBDIRS += \
     src/hal \
     src/algorithm \
     src/ui \
-    src/app
+    src/app \
+    tests
 
 
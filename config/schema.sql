@@ -20,6 +20,8 @@ CREATE TABLE IF NOT EXISTS batches (
     actual_count    INTEGER DEFAULT 0,
     ok_count        INTEGER DEFAULT 0,
     ng_count        INTEGER DEFAULT 0,
+    dropped_count   INTEGER DEFAULT 0,           -- 过载丢弃（未检测）帧数
+    late_count      INTEGER DEFAULT 0,           -- 超过节拍上限才完成的帧数
     yield_rate      REAL,
     status          TEXT DEFAULT 'running',      -- running/completed/paused
     operator_id     INTEGER,
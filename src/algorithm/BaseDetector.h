@@ -9,7 +9,8 @@
  * 创建日期：2025年12月03日
  * 摘要：检测器基类实现定义
  * 描述：检测器公共实现基类，提供参数管理、置信度过滤、结果构造等
- *       通用功能，具体检测器继承此类
+ *       通用功能，具体检测器继承此类。参数表在写入时编译为类型化快照，
+ *       detect() 只读取快照，可与 UI 修改参数并发
  *
  * 当前版本：1.0
  */
@@ -18,6 +19,9 @@
 #define BASEDETECTOR_H
 
 #include "IDefectDetector.h"
+#include "ParamSnapshot.h"
+#include <atomic>
+#include <mutex>
 
 // 检测器基类，提供通用实现
 class ALGORITHM_LIBRARY BaseDetector : public IDefectDetector {
@@ -36,15 +40,23 @@ public:
   }
   double confidenceThreshold() const override { return m_confidenceThreshold; }
 
-  void setParameters(const QVariantMap& params) override { m_params = params; }
-  QVariantMap parameters() const override { return m_params; }
+  // 写方：保存参数表并编译发布新快照，下一帧检测生效
+  void setParameters(const QVariantMap& params) override {
+    std::lock_guard<std::mutex> lock(m_paramsMutex);
+    m_params = params;
+    compileParameters(m_params);
+  }
+  QVariantMap parameters() const override {
+    std::lock_guard<std::mutex> lock(m_paramsMutex);
+    return m_params;
+  }
 
 protected:
-  // 辅助方法：创建成功结果
-  DetectionResult makeSuccessResult(const std::vector<DefectInfo>& defects, double timeMs) {
+  // 辅助方法：创建成功结果（缺陷列表按值传入，调用方 std::move 时不复制）
+  DetectionResult makeSuccessResult(std::vector<DefectInfo> defects, double timeMs) {
     DetectionResult result;
     result.success = true;
-    result.defects = defects;
+    result.defects = std::move(defects);
     result.processingTimeMs = timeMs;
     return result;
   }
@@ -57,26 +69,48 @@ protected:
     return result;
   }
 
-  // 辅助方法：过滤低置信度缺陷
-  std::vector<DefectInfo> filterByConfidence(const std::vector<DefectInfo>& defects) {
-    std::vector<DefectInfo> filtered;
-    for (const auto& d : defects) {
-      if (d.confidence >= m_confidenceThreshold) {
-        filtered.push_back(d);
-      }
-    }
-    return filtered;
+  // 辅助方法：创建取消结果（其他检测器已判定 NG，本检测器提前退出）
+  DetectionResult makeCancelledResult(double timeMs) {
+    DetectionResult result;
+    result.success = false;
+    result.cancelled = true;
+    result.errorMessage = "Cancelled";
+    result.processingTimeMs = timeMs;
+    return result;
   }
 
-  // 辅助方法：获取参数值
+  // 辅助方法：过滤低置信度缺陷（原地删除，保持原有顺序）
+  std::vector<DefectInfo> filterByConfidence(std::vector<DefectInfo> defects) {
+    const double threshold = m_confidenceThreshold;
+    defects.erase(std::remove_if(defects.begin(), defects.end(),
+                                 [threshold](const DefectInfo& d) { return d.confidence < threshold; }),
+                  defects.end());
+    return defects;
+  }
+
+  // 由参数表编译类型化参数并发布到检测器的 ParamSnapshot（在参数锁内调用，
+  // 写方之间有序）；无类型化参数的检测器无需重写
+  virtual void compileParameters(const QVariantMap& params) { Q_UNUSED(params) }
+
+  // 辅助方法：从参数表取值（供 compileParameters 使用）
+  template<typename T>
+  static T paramValue(const QVariantMap& params, const QString& key, const T& defaultValue) {
+    return params.value(key, defaultValue).template value<T>();
+  }
+
+  // 辅助方法：获取参数值（加锁读取参数表，仅用于初始化等非逐帧路径）
   template<typename T>
   T getParam(const QString& key, const T& defaultValue) const {
-    return m_params.value(key, defaultValue).template value<T>();
+    std::lock_guard<std::mutex> lock(m_paramsMutex);
+    return paramValue<T>(m_params, key, defaultValue);
   }
 
   bool m_initialized = false;
-  bool m_enabled = true;
-  double m_confidenceThreshold = 0.5;
+  std::atomic<bool> m_enabled{true};
+  std::atomic<double> m_confidenceThreshold{0.5};
+
+private:
+  mutable std::mutex m_paramsMutex;
   QVariantMap m_params;
 };
 
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * CancellationToken.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：协作式取消令牌
+ * 描述：同一帧的各检测器（及各分块）共享一个令牌，任一方请求取消后，
+ *       其余检测器在长循环的检查点上尽快退出；拷贝令牌共享同一取消状态
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <atomic>
+#include <memory>
+
+class CancellationToken {
+public:
+  CancellationToken() : m_flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+  // 请求取消（线程安全，可重复调用）
+  void cancel() const { m_flag->store(true, std::memory_order_relaxed); }
+
+  // 检查点：已请求取消时检测器应放弃剩余计算并返回
+  bool isCancelled() const { return m_flag->load(std::memory_order_relaxed); }
+
+private:
+  std::shared_ptr<std::atomic<bool>> m_flag;
+};
+
+#endif // CANCELLATIONTOKEN_H
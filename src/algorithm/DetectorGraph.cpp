@@ -0,0 +1,243 @@
+#include "DetectorGraph.h"
+#include "Logger.h"
+#include "PooledMatAllocator.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+int DetectorGraph::addNode(const QString& name, Task task, double estimatedCostMs) {
+  Node node;
+  node.name = name;
+  node.task = std::move(task);
+  node.costMs = std::max(0.0, estimatedCostMs);
+  m_nodes.push_back(std::move(node));
+  return static_cast<int>(m_nodes.size()) - 1;
+}
+
+void DetectorGraph::addDependency(int before, int after) {
+  if (before == after || before < 0 || after < 0 ||
+      before >= static_cast<int>(m_nodes.size()) || after >= static_cast<int>(m_nodes.size())) {
+    return;
+  }
+  auto& successors = m_nodes[before].successors;
+  if (std::find(successors.begin(), successors.end(), after) != successors.end()) {
+    return;
+  }
+  successors.push_back(after);
+  m_nodes[after].predecessors.push_back(before);
+}
+
+bool DetectorGraph::computePriorities() {
+  // Kahn 拓扑排序，同时检测环
+  std::vector<int> indegree(m_nodes.size());
+  std::vector<int> order;
+  order.reserve(m_nodes.size());
+  for (size_t i = 0; i < m_nodes.size(); ++i) {
+    indegree[i] = static_cast<int>(m_nodes[i].predecessors.size());
+    if (indegree[i] == 0) {
+      order.push_back(static_cast<int>(i));
+    }
+  }
+  for (size_t head = 0; head < order.size(); ++head) {
+    for (int next : m_nodes[order[head]].successors) {
+      if (--indegree[next] == 0) {
+        order.push_back(next);
+      }
+    }
+  }
+  if (order.size() != m_nodes.size()) {
+    return false;
+  }
+
+  // 逆拓扑序计算到汇点的最长预估耗时，作为调度优先级（关键路径优先）
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    Node& node = m_nodes[*it];
+    double downstream = 0.0;
+    for (int next : node.successors) {
+      downstream = std::max(downstream, m_nodes[next].priority);
+    }
+    node.priority = node.costMs + downstream;
+  }
+  return true;
+}
+
+bool DetectorGraph::run(int maxParallel) {
+  if (!computePriorities()) {
+    LOG_ERROR("DetectorGraph: Dependency cycle detected among {} nodes", m_nodes.size());
+    return false;
+  }
+
+  m_timings.assign(m_nodes.size(), NodeTiming());
+  for (size_t i = 0; i < m_nodes.size(); ++i) {
+    m_timings[i].name = m_nodes[i].name;
+    m_nodes[i].pending = static_cast<int>(m_nodes[i].predecessors.size());
+  }
+
+  // 协助线程作为任务组子任务提交到全局工作窃取线程池；
+  // 调用线程本身是池中工作线程时（如帧级任务内嵌套检测），等待期间只协助执行本组尚未启动的协助任务
+  TaskGroup helpers(globalThreadPool());
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_helpers = &helpers;
+  m_ready.clear();
+  m_remaining = m_nodes.size();
+  m_activeHelpers = 0;
+  m_startingHelpers = 0;
+  m_maxHelpers = std::max(0, maxParallel - 1);
+  m_callerIdle = false;
+  m_error = nullptr;
+  m_clock.start();
+
+  for (size_t i = 0; i < m_nodes.size(); ++i) {
+    if (m_nodes[i].pending == 0) {
+      m_ready.push_back(static_cast<int>(i));
+    }
+  }
+
+  // 调用线程始终参与执行：就绪节点只由已启动的线程领取，线程池繁忙时退化为串行，不会死锁
+  int id = popReadyLocked();
+  while (m_remaining > 0) {
+    if (id < 0) {
+      m_callerIdle = true;
+      m_cond.wait(lock);
+      m_callerIdle = false;
+      id = popReadyLocked();
+      continue;
+    }
+    const int spawn = dispatchLocked();
+    lock.unlock();
+    spawnHelpers(spawn);
+    execute(id);
+    lock.lock();
+    finishLocked(id);
+    id = popReadyLocked();
+  }
+  m_helpers = nullptr;
+  lock.unlock();
+
+  // 尚未启动的协助任务启动后发现无就绪节点即退出
+  helpers.wait();
+
+  lock.lock();
+  if (m_error) {
+    std::exception_ptr error = m_error;
+    m_error = nullptr;
+    std::rethrow_exception(error);
+  }
+  return true;
+}
+
+int DetectorGraph::popReadyLocked() {
+  if (m_ready.empty()) {
+    return -1;
+  }
+  auto best = std::max_element(m_ready.begin(), m_ready.end(), [this](int a, int b) {
+    if (m_nodes[a].priority != m_nodes[b].priority) {
+      return m_nodes[a].priority < m_nodes[b].priority;
+    }
+    return a > b;
+  });
+  int id = *best;
+  *best = m_ready.back();
+  m_ready.pop_back();
+  return id;
+}
+
+int DetectorGraph::dispatchLocked() {
+  // 为空闲的调用线程保留一个就绪节点；已提交但未启动的协助任务各自对应一个就绪节点
+  int count = 0;
+  while (m_activeHelpers < m_maxHelpers &&
+         m_ready.size() > (m_callerIdle ? 1u : 0u) + static_cast<size_t>(m_startingHelpers)) {
+    ++m_activeHelpers;
+    ++m_startingHelpers;
+    ++count;
+  }
+  return count;
+}
+
+void DetectorGraph::spawnHelpers(int count) {
+  // 在 m_mutex 之外提交：线程池未运行时任务组会在当前线程直接执行
+  // 协助线程沿用调用线程的 cv::Mat 池化设置（池化按线程启用）
+  const bool matPooling = PooledMatAllocator::isThreadEnabled();
+  for (int i = 0; i < count; ++i) {
+    m_helpers->run([this, matPooling] {
+      ScopedMatPooling pooling(matPooling);
+      helperLoop();
+    });
+  }
+}
+
+void DetectorGraph::execute(int id) {
+  NodeTiming& timing = m_timings[id];
+  timing.startMs = m_clock.nsecsElapsed() / 1e6;
+  try {
+    m_nodes[id].task();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_error) {
+      m_error = std::current_exception();
+    }
+  }
+  timing.endMs = m_clock.nsecsElapsed() / 1e6;
+}
+
+void DetectorGraph::finishLocked(int id) {
+  m_remaining--;
+  for (int next : m_nodes[id].successors) {
+    if (--m_nodes[next].pending == 0) {
+      m_ready.push_back(next);
+    }
+  }
+  m_cond.notify_all();
+}
+
+void DetectorGraph::helperLoop() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  --m_startingHelpers;
+  int id = popReadyLocked();
+  while (id >= 0) {
+    const int spawn = dispatchLocked();
+    lock.unlock();
+    spawnHelpers(spawn);
+    execute(id);
+    lock.lock();
+    finishLocked(id);
+    id = popReadyLocked();
+  }
+  --m_activeHelpers;
+}
+
+std::vector<int> DetectorGraph::criticalPath() const {
+  std::vector<int> path;
+  if (m_timings.size() != m_nodes.size() || m_nodes.empty()) {
+    return path;
+  }
+
+  // 从最晚完成的节点开始，沿最晚完成的前驱回溯
+  auto latest = [this](const std::vector<int>& candidates) {
+    int best = -1;
+    for (int id : candidates) {
+      if (best < 0 || m_timings[id].endMs > m_timings[best].endMs) {
+        best = id;
+      }
+    }
+    return best;
+  };
+
+  std::vector<int> all(m_nodes.size());
+  for (size_t i = 0; i < all.size(); ++i) {
+    all[i] = static_cast<int>(i);
+  }
+  for (int id = latest(all); id >= 0; id = latest(m_nodes[id].predecessors)) {
+    path.push_back(id);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+double DetectorGraph::criticalPathMs() const {
+  double total = 0.0;
+  for (int id : criticalPath()) {
+    total += m_timings[id].durationMs();
+  }
+  return total;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * DetectorGraph.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：检测任务依赖图执行器
+ * 描述：将检测器及其共享中间产物（灰度、模糊、梯度等）建模为有向无环图，
+ *       无依赖关系的节点并行执行，按实测耗时估算的关键路径优先调度，
+ *       执行后回溯本帧实际关键路径用于调优
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef DETECTORGRAPH_H
+#define DETECTORGRAPH_H
+
+#include "algorithm_global.h"
+#include <QElapsedTimer>
+#include <QString>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class TaskGroup;
+
+class ALGORITHM_LIBRARY DetectorGraph {
+public:
+  using Task = std::function<void()>;
+
+  // 节点执行记录（相对 run() 开始时刻，毫秒）
+  struct NodeTiming {
+    QString name;
+    double startMs = 0.0;
+    double endMs = 0.0;
+    double durationMs() const { return endMs - startMs; }
+  };
+
+  DetectorGraph() = default;
+  DetectorGraph(const DetectorGraph&) = delete;
+  DetectorGraph& operator=(const DetectorGraph&) = delete;
+
+  // 添加节点，estimatedCostMs 为调度用的预估耗时，返回节点编号
+  int addNode(const QString& name, Task task, double estimatedCostMs);
+
+  // 声明依赖：before 完成后 after 才能开始
+  void addDependency(int before, int after);
+
+  size_t nodeCount() const { return m_nodes.size(); }
+
+  // 执行整个图（阻塞），调用线程也参与执行，额外并发由全局工作窃取线程池提供
+  // maxParallel: 最大并发节点数（含调用线程）；存在环时不执行并返回 false
+  // 节点抛出的首个异常在所有可执行节点结束后重新抛出
+  bool run(int maxParallel);
+
+  // 最近一次执行的各节点耗时（按节点编号）
+  const std::vector<NodeTiming>& timings() const { return m_timings; }
+
+  // 最近一次执行的实际关键路径（从源节点到最晚完成节点）
+  std::vector<int> criticalPath() const;
+
+  // 关键路径上各节点执行耗时之和
+  double criticalPathMs() const;
+
+private:
+  struct Node {
+    QString name;
+    Task task;
+    double costMs = 0.0;
+    double priority = 0.0;             // 到汇点的最长预估耗时（含自身）
+    std::vector<int> successors;
+    std::vector<int> predecessors;
+    int pending = 0;                   // 尚未完成的前驱数
+  };
+
+  bool computePriorities();
+  int popReadyLocked();
+  int dispatchLocked();               // 预留需新增的协助任务数，解锁后由 spawnHelpers 提交
+  void spawnHelpers(int count);
+  void execute(int id);
+  void finishLocked(int id);
+  void helperLoop();
+
+  std::vector<Node> m_nodes;
+  std::vector<NodeTiming> m_timings;
+
+  // 执行期状态
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::vector<int> m_ready;
+  size_t m_remaining = 0;
+  int m_activeHelpers = 0;            // 已提交且未退出的协助任务
+  int m_startingHelpers = 0;          // 已提交但尚未启动的协助任务
+  int m_maxHelpers = 0;
+  TaskGroup* m_helpers = nullptr;
+  bool m_callerIdle = false;
+  std::exception_ptr m_error;
+  QElapsedTimer m_clock;
+};
+
+#endif // DETECTORGRAPH_H
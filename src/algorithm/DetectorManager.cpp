@@ -1,16 +1,166 @@
 #include "DetectorManager.h"
 #include "DetectorFactory.h"
+#include "DetectorGraph.h"
 #include "detectors/ScratchDetector.h"
 #include "detectors/CrackDetector.h"
 #include "detectors/ForeignDetector.h"
 #include "detectors/DimensionDetector.h"
+#include "preprocess/ROIManager.h"
 #include "config/ConfigManager.h"
 #include "Logger.h"
+#include "ThreadBudget.h"
 #include <QElapsedTimer>
 #include <QDebug>
-#include <QtConcurrent/QtConcurrent>
-#include <QFuture>
-#include <QFutureWatcher>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+namespace {
+
+// 未实测节点的预估耗时（毫秒）
+constexpr double DEFAULT_PRODUCT_COST_MS = 1.0;
+constexpr double DEFAULT_DETECTOR_COST_MS = 10.0;
+
+// 实测耗时指数平滑系数
+constexpr double COST_SMOOTHING = 0.2;
+
+// 并行方式自动选择：每种方式至少实测的帧数，及重新探测落选方式的间隔帧数
+constexpr int STRATEGY_WARMUP_FRAMES = 5;
+constexpr int STRATEGY_REPROBE_INTERVAL = 200;
+
+const char* strategyName(DetectorManager::ParallelStrategy strategy) {
+  switch (strategy) {
+    case DetectorManager::ParallelStrategy::Auto:          return "auto";
+    case DetectorManager::ParallelStrategy::InterDetector: return "inter";
+    case DetectorManager::ParallelStrategy::IntraDetector: return "intra";
+  }
+  return "unknown";
+}
+
+QString productNodeName(const FrameContext::Request& request) {
+  switch (request.product) {
+    case FrameContext::Product::Gray:      return "frame.gray";
+    case FrameContext::Product::Gaussian:  return QString("frame.gaussian%1").arg(request.param);
+    case FrameContext::Product::Median:    return QString("frame.median%1").arg(request.param);
+    case FrameContext::Product::Lab:       return "frame.lab";
+    case FrameContext::Product::GradientX: return "frame.gradX";
+    case FrameContext::Product::GradientY: return "frame.gradY";
+    case FrameContext::Product::Pyramid:   return QString("frame.pyramid%1").arg(request.param);
+  }
+  return "frame.unknown";
+}
+
+// 因提前退出未执行的检测器结果
+DetectionResult cancelledResult() {
+  DetectionResult result;
+  result.cancelled = true;
+  result.errorMessage = "Cancelled";
+  return result;
+}
+
+// 检测结果中是否有缺陷满足提前退出条件
+bool reachesEarlyExit(const DetectionResult& result, const DetectorManager::EarlyExitPredicate& predicate) {
+  return predicate && result.success &&
+         std::any_of(result.defects.begin(), result.defects.end(), predicate);
+}
+
+// 将检测器结果中的缺陷（至多 limit 个）移入合并结果，检测器结果只保留状态与耗时
+void takeDefects(DetectorManager::CombinedResult& result, const QString& name,
+                 DetectionResult& detResult, size_t limit) {
+  if (detResult.defects.size() > limit) {
+    LOG_WARN("DetectorManager: {} produced {} defects, truncated to {}",
+             name.toStdString(), detResult.defects.size(), limit);
+    detResult.defects.resize(limit);
+  }
+  result.allDefects.insert(result.allDefects.end(), std::make_move_iterator(detResult.defects.begin()),
+                           std::make_move_iterator(detResult.defects.end()));
+  result.defectSources.insert(result.defectSources.end(), detResult.defects.size(), name);
+  detResult.defects.clear();
+}
+
+// 分块检测中的单个缺陷（已映射到整图坐标）
+struct TileDefect {
+  DefectInfo defect;
+  QString source;
+  size_t tile = 0;
+};
+
+// 缺陷是否靠近所在分块的内部边（非图像边缘），此类缺陷可能被接缝切开或在相邻分块重复检出
+bool nearSeam(const cv::Rect& bbox, const cv::Rect& tile, const cv::Size& imageSize, int band) {
+  return (tile.x > 0 && bbox.x < tile.x + band) ||
+         (tile.y > 0 && bbox.y < tile.y + band) ||
+         (tile.br().x < imageSize.width && bbox.br().x > tile.br().x - band) ||
+         (tile.br().y < imageSize.height && bbox.br().y > tile.br().y - band);
+}
+
+// 合并接缝处来自不同分块、同类且相交的缺陷，其余缺陷原样保留
+// sources 输出与结果一一对应的检测器名称
+std::vector<DefectInfo> mergeSeamDefects(std::vector<TileDefect>& items,
+                                         const std::vector<cv::Rect>& tiles,
+                                         const cv::Size& imageSize, int overlap,
+                                         std::vector<QString>& sources) {
+  const int band = overlap + 2;
+  std::vector<size_t> parent(items.size());
+  for (size_t i = 0; i < parent.size(); ++i) {
+    parent[i] = i;
+  }
+  std::function<size_t(size_t)> root = [&](size_t i) {
+    return parent[i] == i ? i : (parent[i] = root(parent[i]));
+  };
+
+  std::vector<size_t> candidates;
+  for (size_t i = 0; i < items.size(); ++i) {
+    // 整件检测器的缺陷不来自分块（tile == tiles.size()），不参与接缝合并
+    if (items[i].tile < tiles.size() && nearSeam(items[i].defect.bbox, tiles[items[i].tile], imageSize, band)) {
+      candidates.push_back(i);
+    }
+  }
+  for (size_t a = 0; a < candidates.size(); ++a) {
+    const TileDefect& first = items[candidates[a]];
+    // 外扩 1 像素，使被接缝恰好切开的两段也视为相交
+    cv::Rect grown(first.defect.bbox.x - 1, first.defect.bbox.y - 1,
+                   first.defect.bbox.width + 2, first.defect.bbox.height + 2);
+    for (size_t b = a + 1; b < candidates.size(); ++b) {
+      const TileDefect& second = items[candidates[b]];
+      if (first.tile != second.tile && first.defect.classId == second.defect.classId &&
+          (grown & second.defect.bbox).area() > 0) {
+        parent[root(candidates[b])] = root(candidates[a]);
+      }
+    }
+  }
+
+  std::map<size_t, std::vector<size_t>> groups;
+  for (size_t i = 0; i < items.size(); ++i) {
+    groups[root(i)].push_back(i);
+  }
+
+  std::vector<DefectInfo> merged;
+  merged.reserve(groups.size());
+  sources.clear();
+  sources.reserve(groups.size());
+  for (auto& [key, members] : groups) {
+    // 以置信度最高者为主，框取并集，置信度/严重度取最大，缺失属性由其余成员补全
+    std::sort(members.begin(), members.end(), [&items](size_t a, size_t b) {
+      return items[a].defect.confidence > items[b].defect.confidence;
+    });
+    DefectInfo defect = std::move(items[members.front()].defect);
+    for (size_t k = 1; k < members.size(); ++k) {
+      DefectInfo& other = items[members[k]].defect;
+      defect.bbox |= other.bbox;
+      defect.contour.insert(defect.contour.end(), other.contour.begin(), other.contour.end());
+      defect.severity = std::max(defect.severity, other.severity);
+      defect.features.mergeMissing(other.features);
+    }
+    if (members.size() > 1) {
+      defect.features.set(DefectFeatures::SeamMerged, static_cast<double>(members.size()));
+    }
+    merged.push_back(std::move(defect));
+    sources.push_back(items[members.front()].source);
+  }
+  return merged;
+}
+
+} // namespace
 
 DetectorManager::DetectorManager(QObject* parent) : QObject(parent) {
 }
@@ -127,6 +277,7 @@ void DetectorManager::loadFromConfig() {
     params["minLength"] = cfg.minLength;
     params["maxWidth"] = cfg.maxWidth;
     params["contrastThreshold"] = cfg.contrastThreshold;
+    params["pyramidLevels"] = cfg.pyramidLevels;
     d->setParameters(params);
   }
 
@@ -139,6 +290,9 @@ void DetectorManager::loadFromConfig() {
     params["minArea"] = cfg.minArea;
     params["morphKernelSize"] = cfg.morphKernelSize;
     params["binaryThreshold"] = cfg.binaryThreshold;
+    params["gaborOrientations"] = cfg.gaborOrientations;
+    params["gaborMethod"] = cfg.gaborMethod;
+    params["skeletonMethod"] = cfg.skeletonMethod;
     d->setParameters(params);
   }
 
@@ -179,6 +333,7 @@ void DetectorManager::saveToConfig() {
     config.scratch.minLength = params.value("minLength", 10).toInt();
     config.scratch.maxWidth = params.value("maxWidth", 5).toInt();
     config.scratch.contrastThreshold = params.value("contrastThreshold", 30).toInt();
+    config.scratch.pyramidLevels = params.value("pyramidLevels", 2).toInt();
   }
 
   // 裂纹检测器
@@ -189,6 +344,9 @@ void DetectorManager::saveToConfig() {
     config.crack.minArea = params.value("minArea", 20).toInt();
     config.crack.morphKernelSize = params.value("morphKernelSize", 3).toInt();
     config.crack.binaryThreshold = params.value("binaryThreshold", 128).toInt();
+    config.crack.gaborOrientations = params.value("gaborOrientations", 4).toInt();
+    config.crack.gaborMethod = params.value("gaborMethod", "auto").toString();
+    config.crack.skeletonMethod = params.value("skeletonMethod", "thinning").toString();
   }
 
   // 异物检测器
@@ -215,53 +373,58 @@ void DetectorManager::saveToConfig() {
 }
 
 DetectorManager::CombinedResult DetectorManager::detectAll(const cv::Mat& image) {
+  FrameContext ctx(image);
+  return detectAll(ctx);
+}
+
+DetectorManager::CombinedResult DetectorManager::detectAll(const FrameContext& ctx) {
   CombinedResult result;
   QElapsedTimer timer;
   timer.start();
 
   emit detectionStarted();
 
-  if (image.empty()) {
+  if (ctx.empty()) {
     result.success = false;
     result.errorMessage = "Empty input image";
     emit detectionFinished(result);
     return result;
   }
 
-  // 执行所有启用的检测器
+  // 执行所有启用的检测器（检测器依次执行，由检测器内部并行使用本帧配额）
   const size_t MAX_DEFECTS_PER_DETECTOR = 100;
+  const EarlyExitPredicate earlyExit = earlyExitPredicate();
+  ThreadBudget::instance().applyOpenCV();
   
   for (auto& pair : m_detectors) {
     if (!pair.second->isEnabled()) {
       continue;
     }
 
-    DetectionResult detResult = pair.second->detect(image);
-    result.detectorResults[pair.first] = detResult;
+    DetectionResult detResult = result.earlyExit ? cancelledResult() : pair.second->detect(ctx);
+    if (!result.earlyExit && reachesEarlyExit(detResult, earlyExit)) {
+      result.earlyExit = true;
+      result.earlyExitDetector = pair.first;
+    }
+    emit detectorResult(pair.first, detResult);
 
-    if (detResult.success) {
+    if (detResult.cancelled) {
+      // 提前退出后未执行，不视为失败
+    } else if (detResult.success) {
       // 限制每个检测器的缺陷数量
-      size_t count = std::min(detResult.defects.size(), MAX_DEFECTS_PER_DETECTOR);
-      for (size_t i = 0; i < count; ++i) {
-        result.allDefects.push_back(detResult.defects[i]);
-      }
-      if (detResult.defects.size() > MAX_DEFECTS_PER_DETECTOR) {
-        LOG_WARN("DetectorManager: {} produced {} defects, truncated to {}", 
-                 pair.first.toStdString(), detResult.defects.size(), MAX_DEFECTS_PER_DETECTOR);
-      }
+      takeDefects(result, pair.first, detResult, MAX_DEFECTS_PER_DETECTOR);
     } else {
       LOG_WARN("DetectorManager: Detector {} failed: {}", 
                pair.first.toStdString(), detResult.errorMessage.toStdString());
     }
-
-    emit detectorResult(pair.first, detResult);
+    result.detectorResults[pair.first] = std::move(detResult);
   }
 
   result.totalTimeMs = timer.elapsed();
   emit detectionFinished(result);
 
-  LOG_DEBUG("DetectorManager: Detection completed in {:.2f}ms, found {} defects",
-            result.totalTimeMs, result.allDefects.size());
+  LOG_DEBUG("DetectorManager: Detection completed in {:.2f}ms, found {} defects, {} shared image products",
+            result.totalTimeMs, result.allDefects.size(), ctx.computedCount());
 
   return result;
 }
@@ -278,14 +441,137 @@ DetectionResult DetectorManager::detectWith(const QString& name, const cv::Mat&
   return detector->detect(image);
 }
 
+void DetectorManager::setEarlyExit(EarlyExitPredicate predicate) {
+  QMutexLocker locker(&m_earlyExitMutex);
+  m_earlyExit = std::move(predicate);
+}
+
+bool DetectorManager::isEarlyExitEnabled() const {
+  QMutexLocker locker(&m_earlyExitMutex);
+  return static_cast<bool>(m_earlyExit);
+}
+
+DetectorManager::EarlyExitPredicate DetectorManager::earlyExitPredicate() const {
+  QMutexLocker locker(&m_earlyExitMutex);
+  return m_earlyExit;
+}
+
+DetectorManager::ParallelStrategy DetectorManager::parallelStrategyFromString(const QString& name) {
+  if (name.compare("inter", Qt::CaseInsensitive) == 0) return ParallelStrategy::InterDetector;
+  if (name.compare("intra", Qt::CaseInsensitive) == 0) return ParallelStrategy::IntraDetector;
+  return ParallelStrategy::Auto;
+}
+
+void DetectorManager::setParallelStrategy(ParallelStrategy strategy) {
+  QMutexLocker locker(&m_strategyMutex);
+  m_strategy = strategy;
+  m_interStats = StrategyStats();
+  m_intraStats = StrategyStats();
+  m_framesSinceProbe = 0;
+  LOG_INFO("DetectorManager: Parallel strategy set to {}", strategyName(strategy));
+}
+
+DetectorManager::ParallelStrategy DetectorManager::parallelStrategy() const {
+  QMutexLocker locker(&m_strategyMutex);
+  return m_strategy;
+}
+
+DetectorManager::ParallelStrategy DetectorManager::activeStrategy() const {
+  QMutexLocker locker(&m_strategyMutex);
+  return m_strategy == ParallelStrategy::Auto ? m_preferred : m_strategy;
+}
+
+DetectorManager::ParallelStrategy DetectorManager::selectStrategy() {
+  QMutexLocker locker(&m_strategyMutex);
+  if (m_strategy != ParallelStrategy::Auto) {
+    return m_strategy;
+  }
+
+  // 先各实测若干帧，此后使用较快者；每隔一段时间让落选方式重新实测，以跟上负载变化
+  if (m_interStats.samples < STRATEGY_WARMUP_FRAMES) {
+    return ParallelStrategy::InterDetector;
+  }
+  if (m_intraStats.samples < STRATEGY_WARMUP_FRAMES) {
+    return ParallelStrategy::IntraDetector;
+  }
+  if (++m_framesSinceProbe >= STRATEGY_REPROBE_INTERVAL) {
+    m_framesSinceProbe = 0;
+    if (m_preferred == ParallelStrategy::InterDetector) {
+      m_intraStats.samples = 0;
+      return ParallelStrategy::IntraDetector;
+    }
+    m_interStats.samples = 0;
+    return ParallelStrategy::InterDetector;
+  }
+  return m_preferred;
+}
+
+void DetectorManager::recordStrategy(ParallelStrategy strategy, double timeMs, int pixels) {
+  if (pixels <= 0) {
+    return;
+  }
+  const double msPerMegapixel = timeMs * 1e6 / pixels;
+
+  QMutexLocker locker(&m_strategyMutex);
+  if (m_strategy != ParallelStrategy::Auto) {
+    return;
+  }
+  StrategyStats& stats = strategy == ParallelStrategy::IntraDetector ? m_intraStats : m_interStats;
+  if (stats.samples == 0) {
+    stats.msPerMegapixel = msPerMegapixel;
+  } else {
+    stats.msPerMegapixel += COST_SMOOTHING * (msPerMegapixel - stats.msPerMegapixel);
+  }
+  ++stats.samples;
+
+  if (m_interStats.samples < STRATEGY_WARMUP_FRAMES || m_intraStats.samples < STRATEGY_WARMUP_FRAMES) {
+    return;
+  }
+  const ParallelStrategy faster = m_intraStats.msPerMegapixel < m_interStats.msPerMegapixel
+      ? ParallelStrategy::IntraDetector : ParallelStrategy::InterDetector;
+  if (faster != m_preferred) {
+    m_preferred = faster;
+    LOG_INFO("DetectorManager: Switched to {}-detector parallelism (inter {:.2f}ms/MP, intra {:.2f}ms/MP)",
+             strategyName(faster), m_interStats.msPerMegapixel, m_intraStats.msPerMegapixel);
+  }
+}
+
+double DetectorManager::estimatedCostMs(const QString& node, double fallback) const {
+  QMutexLocker locker(&m_costMutex);
+  auto it = m_nodeCostMs.find(node);
+  return it != m_nodeCostMs.end() ? it->second : fallback;
+}
+
+void DetectorManager::recordNodeCosts(const DetectorGraph& graph) {
+  QMutexLocker locker(&m_costMutex);
+  for (const auto& timing : graph.timings()) {
+    auto it = m_nodeCostMs.find(timing.name);
+    if (it == m_nodeCostMs.end()) {
+      m_nodeCostMs[timing.name] = timing.durationMs();
+    } else {
+      it->second += COST_SMOOTHING * (timing.durationMs() - it->second);
+    }
+  }
+}
+
+std::map<QString, double> DetectorManager::nodeCostEstimates() const {
+  QMutexLocker locker(&m_costMutex);
+  return m_nodeCostMs;
+}
+
 DetectorManager::CombinedResult DetectorManager::detectAllParallel(const cv::Mat& image) {
+  FrameContext ctx(image);
+  return detectAllParallel(ctx);
+}
+
+DetectorManager::CombinedResult DetectorManager::detectAllParallel(const FrameContext& ctx) {
   CombinedResult result;
   QElapsedTimer timer;
   timer.start();
 
   emit detectionStarted();
 
-  if (image.empty()) {
+  if (ctx.empty()) {
     result.success = false;
     result.errorMessage = "Empty input image";
     emit detectionFinished(result);
@@ -306,50 +592,387 @@ DetectorManager::CombinedResult DetectorManager::detectAllParallel(const cv::Mat
     return result;
   }
 
-  // 并行执行所有检测器
+  // 构建依赖图：共享中间产物与检测器均为节点，按关键路径优先并行执行
   const size_t MAX_DEFECTS_PER_DETECTOR = 100;
-  
-  QList<QFuture<std::pair<QString, DetectionResult>>> futures;
-  for (auto& pair : enabledDetectors) {
-    QString name = pair.first;
-    DetectorPtr detector = pair.second;
-    
-    QFuture<std::pair<QString, DetectionResult>> future = 
-      QtConcurrent::run([name, detector, &image]() {
-        return std::make_pair(name, detector->detect(image));
-      });
-    futures.append(future);
-  }
-
-  // 等待所有检测完成并合并结果
-  for (auto& future : futures) {
-    future.waitForFinished();
-    auto [name, detResult] = future.result();
-    
-    result.detectorResults[name] = detResult;
-
-    if (detResult.success) {
-      size_t count = std::min(detResult.defects.size(), MAX_DEFECTS_PER_DETECTOR);
-      for (size_t i = 0; i < count; ++i) {
-        result.allDefects.push_back(detResult.defects[i]);
+
+  DetectorGraph graph;
+  std::map<FrameContext::Request, int> productNodes;
+  std::function<int(const FrameContext::Request&)> productNode =
+      [&](const FrameContext::Request& request) {
+    auto it = productNodes.find(request);
+    if (it != productNodes.end()) {
+      return it->second;
+    }
+    QString nodeName = productNodeName(request);
+    int id = graph.addNode(nodeName, [&ctx, request]() {
+      if (!ctx.isCancelled()) {
+        ctx.prefetch(request);
       }
-      if (detResult.defects.size() > MAX_DEFECTS_PER_DETECTOR) {
-        LOG_WARN("DetectorManager: {} produced {} defects, truncated to {}", 
-                 name.toStdString(), detResult.defects.size(), MAX_DEFECTS_PER_DETECTOR);
+    },
+                           estimatedCostMs(nodeName, DEFAULT_PRODUCT_COST_MS));
+    productNodes[request] = id;
+    FrameContext::Request parent;
+    if (FrameContext::upstream(request, parent)) {
+      graph.addDependency(productNode(parent), id);
+    }
+    return id;
+  };
+
+  // 提前退出：首个报告致命缺陷的检测器取消本帧上下文，其余检测器在检查点退出
+  const EarlyExitPredicate earlyExit = earlyExitPredicate();
+  std::atomic<int> exitIndex{-1};
+
+  std::vector<DetectionResult> detResults(enabledDetectors.size());
+  for (size_t i = 0; i < enabledDetectors.size(); ++i) {
+    const QString& name = enabledDetectors[i].first;
+    DetectorPtr detector = enabledDetectors[i].second;
+    DetectionResult* slot = &detResults[i];
+    const int index = static_cast<int>(i);
+    int id = graph.addNode(name, [detector, slot, index, &ctx, &earlyExit, &exitIndex]() {
+      if (ctx.isCancelled()) {
+        *slot = cancelledResult();
+        return;
+      }
+      *slot = detector->detect(ctx);
+      int expected = -1;
+      if (reachesEarlyExit(*slot, earlyExit) && exitIndex.compare_exchange_strong(expected, index)) {
+        ctx.cancel();
       }
+    }, estimatedCostMs(name, DEFAULT_DETECTOR_COST_MS));
+    for (const auto& request : detector->frameProducts()) {
+      graph.addDependency(productNode(request), id);
+    }
+  }
+
+  // 任务间并行：图节点并发执行；任务内并行：调用线程依次执行节点，由检测器内部并行占满本帧配额
+  // 两种方式下检测器内部并行均提交到同一全局线程池，空闲工作线程窃取执行，不会超额订阅
+  const ParallelStrategy strategy = selectStrategy();
+  ThreadBudget& budget = ThreadBudget::instance();
+  QElapsedTimer graphTimer;
+  graphTimer.start();
+  budget.applyOpenCV();
+  if (strategy == ParallelStrategy::IntraDetector) {
+    graph.run(1);
+  } else {
+    graph.run(budget.perFrameParallelism());
+  }
+  const double graphMs = graphTimer.nsecsElapsed() / 1e6;
+
+  if (exitIndex.load() < 0) {
+    // 被取消的节点耗时不代表真实开销，不计入统计；
+    // 节点耗时用于并行调度的关键路径估计，只按任务间并行方式统计
+    if (strategy != ParallelStrategy::IntraDetector) {
+      recordNodeCosts(graph);
+    }
+    recordStrategy(strategy, graphMs, ctx.image().cols * ctx.image().rows);
+  } else {
+    result.earlyExit = true;
+    result.earlyExitDetector = enabledDetectors[exitIndex.load()].first;
+  }
+
+  for (int id : graph.criticalPath()) {
+    result.criticalPath.push_back(graph.timings()[id].name);
+  }
+  result.criticalPathMs = graph.criticalPathMs();
+
+  // 按检测器名称顺序合并结果
+  for (size_t index = 0; index < enabledDetectors.size(); ++index) {
+    const QString& name = enabledDetectors[index].first;
+    DetectionResult& detResult = detResults[index];
+    emit detectorResult(name, detResult);
+
+    if (detResult.cancelled) {
+      // 提前退出时被取消，不视为失败
+    } else if (detResult.success) {
+      takeDefects(result, name, detResult, MAX_DEFECTS_PER_DETECTOR);
     } else {
       LOG_WARN("DetectorManager: Detector {} failed: {}", 
                name.toStdString(), detResult.errorMessage.toStdString());
     }
+    result.detectorResults[name] = std::move(detResult);
+  }
 
-    emit detectorResult(name, detResult);
+  result.totalTimeMs = timer.elapsed();
+  emit detectionFinished(result);
+
+  if (result.earlyExit) {
+    LOG_DEBUG("DetectorManager: Early exit after {} reported a critical defect, {:.2f}ms, {} defects",
+              result.earlyExitDetector.toStdString(), result.totalTimeMs, result.allDefects.size());
+  } else {
+    LOG_DEBUG("DetectorManager: Parallel detection completed in {:.2f}ms, found {} defects, {} shared image products, "
+              "critical path {:.2f}ms [{}]",
+              result.totalTimeMs, result.allDefects.size(), ctx.computedCount(),
+              result.criticalPathMs, result.criticalPath.join(" -> ").toStdString());
+  }
+
+  return result;
+}
+
+std::vector<cv::Rect> DetectorManager::tileGrid(const cv::Size& imageSize, const TileOptions& options) {
+  const int tileSize = std::max(1, options.tileSize);
+  const int step = std::max(1, tileSize - std::max(0, options.overlap));
+
+  auto starts = [tileSize, step](int length) {
+    std::vector<int> positions;
+    if (length <= tileSize) {
+      positions.push_back(0);
+      return positions;
+    }
+    for (int pos = 0; ; pos += step) {
+      if (pos + tileSize >= length) {
+        positions.push_back(length - tileSize);
+        break;
+      }
+      positions.push_back(pos);
+    }
+    return positions;
+  };
+
+  std::vector<cv::Rect> tiles;
+  for (int y : starts(imageSize.height)) {
+    for (int x : starts(imageSize.width)) {
+      tiles.emplace_back(x, y, std::min(tileSize, imageSize.width),
+                         std::min(tileSize, imageSize.height));
+    }
   }
+  return tiles;
+}
+
+DetectorManager::CombinedResult DetectorManager::detectRegions(const cv::Mat& image,
+                                                               const std::vector<cv::Rect>& regions,
+                                                               const cv::Mat& mask,
+                                                               std::vector<size_t>* defectRegions) {
+  CombinedResult result;
+
+  std::vector<std::pair<QString, DetectorPtr>> enabledDetectors;
+  for (auto& pair : m_detectors) {
+    if (pair.second->isEnabled()) {
+      enabledDetectors.push_back(pair);
+    }
+  }
+
+  // 每个区域一个节点：区域内共享帧上下文并依次执行可分块的检测器，区域之间并行；
+  // 整件测量类检测器另起一个节点，在全部区域的外接矩形上只执行一次
+  const size_t MAX_DEFECTS_PER_DETECTOR = 100;
+  const size_t detectorCount = enabledDetectors.size();
+  std::vector<DetectionResult> regionResults(regions.size() * detectorCount);
+  std::vector<DetectionResult> wholeResults(detectorCount);
+  std::vector<char> tileable(detectorCount);
+  size_t wholeCount = 0;
+  for (size_t d = 0; d < detectorCount; ++d) {
+    tileable[d] = enabledDetectors[d].second->supportsTiling();
+    wholeCount += !tileable[d];
+  }
+  cv::Rect bounds;
+  for (const cv::Rect& region : regions) {
+    bounds = bounds.empty() ? region : (bounds | region);
+  }
+
+  // 各区域共享取消令牌：任一区域出现致命缺陷即取消所有区域
+  const EarlyExitPredicate earlyExit = earlyExitPredicate();
+  CancellationToken cancel;
+  std::atomic<int> exitIndex{-1};
+
+  DetectorGraph graph;
+  for (size_t r = 0; r < regions.size(); ++r) {
+    const cv::Rect region = regions[r];
+    DetectionResult* slots = regionResults.data() + r * detectorCount;
+    graph.addNode(QString("region%1").arg(r),
+                  [&image, &mask, &enabledDetectors, &tileable, &earlyExit, &cancel, &exitIndex, region, slots]() {
+      FrameContext ctx(image(region), mask.empty() ? cv::Mat() : mask(region));
+      ctx.setCancellationToken(cancel);
+      for (size_t d = 0; d < enabledDetectors.size(); ++d) {
+        if (!tileable[d]) {
+          continue;
+        }
+        if (ctx.isCancelled()) {
+          slots[d] = cancelledResult();
+          continue;
+        }
+        slots[d] = enabledDetectors[d].second->detect(ctx);
+        int expected = -1;
+        if (reachesEarlyExit(slots[d], earlyExit) &&
+            exitIndex.compare_exchange_strong(expected, static_cast<int>(d))) {
+          ctx.cancel();
+        }
+      }
+    }, DEFAULT_DETECTOR_COST_MS * (detectorCount - wholeCount) * region.area() / std::max(1, image.size().area()));
+  }
+  if (wholeCount > 0) {
+    DetectionResult* slots = wholeResults.data();
+    graph.addNode("whole",
+                  [&image, &mask, &enabledDetectors, &tileable, &earlyExit, &cancel, &exitIndex, bounds, slots]() {
+      FrameContext ctx(image(bounds), mask.empty() ? cv::Mat() : mask(bounds));
+      ctx.setCancellationToken(cancel);
+      for (size_t d = 0; d < enabledDetectors.size(); ++d) {
+        if (tileable[d]) {
+          continue;
+        }
+        if (ctx.isCancelled()) {
+          slots[d] = cancelledResult();
+          continue;
+        }
+        slots[d] = enabledDetectors[d].second->detect(ctx);
+        int expected = -1;
+        if (reachesEarlyExit(slots[d], earlyExit) &&
+            exitIndex.compare_exchange_strong(expected, static_cast<int>(d))) {
+          ctx.cancel();
+        }
+      }
+    }, DEFAULT_DETECTOR_COST_MS * wholeCount * bounds.area() / std::max(1, image.size().area()));
+  }
+  // 区域数通常多于核数，固定按任务间并行执行
+  ThreadBudget& budget = ThreadBudget::instance();
+  budget.applyOpenCV();
+  graph.run(budget.perFrameParallelism());
+  if (exitIndex.load() >= 0) {
+    result.earlyExit = true;
+    result.earlyExitDetector = enabledDetectors[exitIndex.load()].first;
+  }
+
+  for (int id : graph.criticalPath()) {
+    result.criticalPath.push_back(graph.timings()[id].name);
+  }
+  result.criticalPathMs = graph.criticalPathMs();
+
+  // 映射回整图坐标并按检测器汇总
+  for (size_t d = 0; d < detectorCount; ++d) {
+    const QString& name = enabledDetectors[d].first;
+    DetectionResult summary;
+    summary.success = true;
+    // 可分块检测器逐区域汇总；整件检测器只有外接矩形上的一个结果
+    const size_t regionCount = tileable[d] ? regions.size() : 1;
+    for (size_t i = 0; i < regionCount; ++i) {
+      const size_t r = tileable[d] ? i : regions.size();
+      DetectionResult& detResult = tileable[d] ? regionResults[r * detectorCount + d] : wholeResults[d];
+      summary.processingTimeMs += detResult.processingTimeMs;
+      if (detResult.cancelled) {
+        summary.cancelled = true;
+        continue;
+      }
+      if (!detResult.success) {
+        summary.success = false;
+        summary.errorMessage = detResult.errorMessage;
+        continue;
+      }
+      if (detResult.defects.size() > MAX_DEFECTS_PER_DETECTOR) {
+        LOG_WARN("DetectorManager: {} produced {} defects in region {}, truncated to {}",
+                 name.toStdString(), detResult.defects.size(), r, MAX_DEFECTS_PER_DETECTOR);
+        detResult.defects.resize(MAX_DEFECTS_PER_DETECTOR);
+      }
+      const cv::Point offset = tileable[d] ? regions[r].tl() : bounds.tl();
+      for (auto& defect : detResult.defects) {
+        defect.bbox += offset;
+        for (auto& pt : defect.contour) {
+          pt += offset;
+        }
+        summary.defects.push_back(std::move(defect));
+        if (defectRegions) {
+          defectRegions->push_back(r);
+        }
+      }
+    }
+
+    if (!summary.success) {
+      LOG_WARN("DetectorManager: Detector {} failed: {}",
+               name.toStdString(), summary.errorMessage.toStdString());
+    }
+    emit detectorResult(name, summary);
+    // 各区域已按上限截断，此处只移入
+    takeDefects(result, name, summary, summary.defects.size());
+    result.detectorResults[name] = std::move(summary);
+  }
+  return result;
+}
+
+DetectorManager::CombinedResult DetectorManager::detectTiled(const cv::Mat& image,
+                                                             const TileOptions& options,
+                                                             const ROIMask* roi) {
+  // 有 ROI 时只对各检测区域分块，否则对整图分块
+  std::vector<cv::Rect> tiles;
+  if (roi) {
+    for (const auto& rect : roi->rects) {
+      for (auto tile : tileGrid(rect.size(), options)) {
+        tiles.push_back(tile + rect.tl());
+      }
+    }
+  } else {
+    tiles = tileGrid(image.size(), options);
+  }
+  if (image.empty() || tiles.size() <= 1) {
+    return roi ? detectInROI(image, *roi) : detectAllParallel(image);
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  emit detectionStarted();
+
+  std::vector<size_t> defectTiles;
+  CombinedResult result = detectRegions(image, tiles, roi ? roi->mask : cv::Mat(), &defectTiles);
+
+  std::vector<TileDefect> tileDefects;
+  tileDefects.reserve(result.allDefects.size());
+  for (size_t i = 0; i < result.allDefects.size(); ++i) {
+    tileDefects.push_back({std::move(result.allDefects[i]), std::move(result.defectSources[i]), defectTiles[i]});
+  }
+  const size_t rawCount = tileDefects.size();
+  result.allDefects = mergeSeamDefects(tileDefects, tiles, image.size(), options.overlap,
+                                       result.defectSources);
 
   result.totalTimeMs = timer.elapsed();
   emit detectionFinished(result);
 
-  LOG_DEBUG("DetectorManager: Parallel detection completed in {:.2f}ms, found {} defects",
-            result.totalTimeMs, result.allDefects.size());
+  LOG_DEBUG("DetectorManager: Tiled detection on {}x{} ({} tiles of {}px, overlap {}px) completed in {:.2f}ms, "
+            "{} defects ({} before seam merge), slowest tile {:.2f}ms",
+            image.cols, image.rows, tiles.size(), options.tileSize, options.overlap,
+            result.totalTimeMs, result.allDefects.size(), rawCount, result.criticalPathMs);
+
+  return result;
+}
+
+DetectorManager::CombinedResult DetectorManager::detectInROI(const cv::Mat& image, const ROIMask& roi) {
+  if (image.empty() || roi.mask.size() != image.size()) {
+    LOG_WARN("DetectorManager: ROI mask size mismatch, detecting full frame");
+    return detectAllParallel(image);
+  }
+
+  // 单个检测区域：在其外接矩形上按依赖图并行执行各检测器
+  if (roi.rects.size() == 1) {
+    const cv::Rect rect = roi.rects.front();
+    FrameContext ctx(image(rect), roi.mask(rect));
+    CombinedResult result = detectAllParallel(ctx);
+    for (auto& defect : result.allDefects) {
+      defect.bbox += rect.tl();
+      for (auto& pt : defect.contour) {
+        pt += rect.tl();
+      }
+    }
+    return result;
+  }
+
+  // 多个检测区域：各区域并行，区域外像素完全不参与计算
+  QElapsedTimer timer;
+  timer.start();
+  emit detectionStarted();
+
+  CombinedResult result = detectRegions(image, roi.rects, roi.mask, nullptr);
+
+  result.totalTimeMs = timer.elapsed();
+  emit detectionFinished(result);
 
+  LOG_DEBUG("DetectorManager: ROI detection on {} regions ({:.1f}% of frame) completed in {:.2f}ms, found {} defects",
+            roi.rects.size(), roi.coverage * 100.0, result.totalTimeMs, result.allDefects.size());
   return result;
 }
+
+DetectionResult DetectorManager::detectWith(const QString& name, const FrameContext& ctx) {
+  auto detector = getDetector(name);
+  if (!detector) {
+    DetectionResult result;
+    result.success = false;
+    result.errorMessage = QString("Detector not found: %1").arg(name);
+    return result;
+  }
+
+  return detector->detect(ctx);
+}
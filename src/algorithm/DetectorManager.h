@@ -23,9 +23,13 @@
 #include <QString>
 #include <QVariantMap>
 #include <QMutex>
+#include <functional>
 #include <vector>
 #include <map>
 
+class DetectorGraph;
+struct ROIMask;
+
 // 检测管理器：管理多个检测器的执行
 class ALGORITHM_LIBRARY DetectorManager : public QObject {
   Q_OBJECT
@@ -60,27 +64,79 @@ public:
   void saveToConfig();
 
   // 执行所有启用的检测器
+  // 缺陷只保存一份：各检测器的缺陷移入 allDefects，detectorResults 中只保留状态与耗时
+  // （defects 为空），检测器结果信号在移出前发出，仍带完整缺陷列表
   struct CombinedResult {
     bool success = true;
     QString errorMessage;
     std::vector<DefectInfo> allDefects;
+    std::vector<QString> defectSources;   // 与 allDefects 一一对应，检出该缺陷的检测器名称
     double totalTimeMs = 0.0;
     std::map<QString, DetectionResult> detectorResults;
+    QStringList criticalPath;       // 本帧实际关键路径（仅并行检测）
+    double criticalPathMs = 0.0;    // 关键路径上节点耗时之和
+    bool earlyExit = false;         // 因致命缺陷提前退出（其余检测器已取消，结果不完整）
+    QString earlyExitDetector;      // 触发提前退出的检测器
   };
   
   // 串行执行所有检测器
   CombinedResult detectAll(const cv::Mat& image);
+  CombinedResult detectAll(const FrameContext& ctx);
   
-  // 并行执行所有检测器（多线程）
+  // 并行执行所有检测器（按依赖图调度，共享中间产物先行计算）
   CombinedResult detectAllParallel(const cv::Mat& image);
+  CombinedResult detectAllParallel(const FrameContext& ctx);
+
+  // 分块检测选项
+  struct TileOptions {
+    int tileSize = 1024;   // 分块边长（像素）
+    int overlap = 64;      // 相邻分块重叠宽度（像素），应大于最大缺陷宽度
+  };
+
+  // 全分辨率分块并行检测：各分块在全部核上并行执行所有检测器，
+  // 结果映射回整图坐标并合并接缝处的重复缺陷；图像不大于一个分块时等同 detectAllParallel
+  // roi 非空时只对 ROI 各检测区域分块
+  CombinedResult detectTiled(const cv::Mat& image, const TileOptions& options,
+                             const ROIMask* roi = nullptr);
+
+  // ROI 检测：只在 ROI 紧致外接矩形内执行检测器，检测器据掩膜跳过区域外像素，
+  // 结果为整图坐标
+  CombinedResult detectInROI(const cv::Mat& image, const ROIMask& roi);
+
+  // 计算分块区域（末行/末列分块贴齐图像边缘，保证分块尺寸一致）
+  static std::vector<cv::Rect> tileGrid(const cv::Size& imageSize, const TileOptions& options);
 
   // 执行单个检测器
   DetectionResult detectWith(const QString& name, const cv::Mat& image);
+  DetectionResult detectWith(const QString& name, const FrameContext& ctx);
   
+  // 提前退出判定：返回 true 表示该缺陷已足以判定本帧 NG
+  using EarlyExitPredicate = std::function<bool(const DefectInfo&)>;
+
+  // 设置后，任一检测器报告满足条件的缺陷即取消本帧其余检测器（协作式，经帧上下文的取消令牌）；
+  // 传入空函数关闭提前退出。判定函数会在检测线程中并发调用
+  void setEarlyExit(EarlyExitPredicate predicate);
+  bool isEarlyExitEnabled() const;
+
   // 设置是否使用并行检测
   void setParallelEnabled(bool enabled) { m_parallelEnabled = enabled; }
   bool isParallelEnabled() const { return m_parallelEnabled; }
 
+  // 并行检测的并行方式（线程总数均受 ThreadBudget 核数预算约束）
+  enum class ParallelStrategy {
+    Auto,           // 按实测每百万像素耗时在两者间选择，并定期重新探测
+    InterDetector,  // 检测器之间并行
+    IntraDetector   // 检测器依次执行，检测器内部并行
+  };
+  static ParallelStrategy parallelStrategyFromString(const QString& name);
+  void setParallelStrategy(ParallelStrategy strategy);
+  ParallelStrategy parallelStrategy() const;
+  // 当前实际采用的并行方式（Auto 时为实测较快者）
+  ParallelStrategy activeStrategy() const;
+
+  // 各调度节点（检测器/中间产物）的平滑实测耗时，用于关键路径调优
+  std::map<QString, double> nodeCostEstimates() const;
+
 signals:
   void detectorAdded(const QString& name);
   void detectorRemoved(const QString& name);
@@ -90,11 +146,37 @@ signals:
 
 private:
   void registerBuiltinDetectors();
+  double estimatedCostMs(const QString& node, double fallback) const;
+  void recordNodeCosts(const DetectorGraph& graph);
+  EarlyExitPredicate earlyExitPredicate() const;
+  ParallelStrategy selectStrategy();
+  void recordStrategy(ParallelStrategy strategy, double timeMs, int pixels);
+
+  // 各区域并行执行可分块的检测器，不可分块的检测器在全部区域的外接矩形上执行一次；
+  // 结果映射回整图坐标（defectRegions 记录每个缺陷所属区域，外接矩形上的缺陷记为 regions.size()）
+  CombinedResult detectRegions(const cv::Mat& image, const std::vector<cv::Rect>& regions,
+                               const cv::Mat& mask, std::vector<size_t>* defectRegions);
 
   std::map<QString, DetectorPtr> m_detectors;
   bool m_initialized = false;
   bool m_parallelEnabled = true;  // 默认启用并行检测
   mutable QMutex m_resultMutex;   // 保护并行结果合并
+  mutable QMutex m_costMutex;     // 保护节点耗时统计
+  std::map<QString, double> m_nodeCostMs;
+  mutable QMutex m_earlyExitMutex;
+  EarlyExitPredicate m_earlyExit;
+
+  // 并行方式自动选择：两种方式各自的平滑耗时（毫秒/百万像素）
+  struct StrategyStats {
+    double msPerMegapixel = 0.0;
+    int samples = 0;
+  };
+  mutable QMutex m_strategyMutex;
+  ParallelStrategy m_strategy = ParallelStrategy::Auto;
+  ParallelStrategy m_preferred = ParallelStrategy::InterDetector;
+  StrategyStats m_interStats;
+  StrategyStats m_intraStats;
+  int m_framesSinceProbe = 0;
 };
 
 #endif // DETECTORMANAGER_H
@@ -0,0 +1,115 @@
+#include "FrameArena.h"
+#include <cstdint>
+#include <new>
+
+namespace {
+
+// 进程级标准块缓存：帧上下文销毁时归还，下一帧复用
+// 上限按同时在途帧数 × 分块数估计，超出部分直接释放
+constexpr std::size_t MAX_CACHED_BLOCKS = 64;
+
+constexpr std::align_val_t BLOCK_ALIGNMENT{alignof(std::max_align_t)};
+
+struct BlockCache {
+  ~BlockCache() {
+    for (char* block : blocks) {
+      ::operator delete(block, BLOCK_ALIGNMENT);
+    }
+  }
+
+  std::mutex mutex;
+  std::vector<char*> blocks;
+};
+
+BlockCache& blockCache() {
+  static BlockCache cache;
+  return cache;
+}
+
+char* acquireStandardBlock() {
+  BlockCache& cache = blockCache();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (!cache.blocks.empty()) {
+      char* block = cache.blocks.back();
+      cache.blocks.pop_back();
+      return block;
+    }
+  }
+  return static_cast<char*>(::operator new(FrameArena::BLOCK_SIZE, BLOCK_ALIGNMENT));
+}
+
+void releaseBlock(char* data, std::size_t size) {
+  if (size == FrameArena::BLOCK_SIZE) {
+    BlockCache& cache = blockCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.blocks.size() < MAX_CACHED_BLOCKS) {
+      cache.blocks.push_back(data);
+      return;
+    }
+  }
+  ::operator delete(data, BLOCK_ALIGNMENT);
+}
+
+} // namespace
+
+FrameArena::~FrameArena() {
+  releaseBlocks();
+}
+
+void FrameArena::reset() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  releaseBlocks();
+}
+
+std::size_t FrameArena::bytesAllocated() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_bytesAllocated;
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (!m_blocks.empty()) {
+    Block& block = m_blocks.back();
+    const auto base = reinterpret_cast<std::uintptr_t>(block.data);
+    const std::size_t offset = ((base + block.used + alignment - 1) & ~(alignment - 1)) - base;
+    if (offset + bytes <= block.size) {
+      m_bytesAllocated += offset + bytes - block.used;
+      block.used = offset + bytes;
+      return block.data + offset;
+    }
+  }
+
+  // 当前块不足：常规请求取标准块，超大请求单独分配（归还时直接释放）
+  Block block;
+  const std::size_t padded = bytes + alignment;
+  if (padded <= BLOCK_SIZE) {
+    block.data = acquireStandardBlock();
+    block.size = BLOCK_SIZE;
+  } else {
+    block.data = static_cast<char*>(::operator new(padded, BLOCK_ALIGNMENT));
+    block.size = padded;
+  }
+
+  const auto base = reinterpret_cast<std::uintptr_t>(block.data);
+  const std::size_t offset = ((base + alignment - 1) & ~(alignment - 1)) - base;
+  block.used = offset + bytes;
+  m_bytesAllocated += block.used;
+
+  // 超大块放在前面，保持最后一块为可继续分配的标准块
+  if (block.size != BLOCK_SIZE && !m_blocks.empty()) {
+    m_blocks.insert(m_blocks.end() - 1, block);
+    return block.data + offset;
+  }
+  m_blocks.push_back(block);
+  return block.data + offset;
+}
+
+void FrameArena::releaseBlocks() {
+  for (const Block& block : m_blocks) {
+    releaseBlock(block.data, block.size);
+  }
+  m_blocks.clear();
+  m_bytesAllocated = 0;
+}
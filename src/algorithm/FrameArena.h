@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * FrameArena.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：单帧内存池
+ * 描述：单调递增的 std::pmr 内存资源，供检测器存放本帧的候选缺陷等临时数据；
+ *       释放为空操作，随帧上下文销毁（或 reset）一次性归还。内存块来自进程级
+ *       缓存，稳态下逐帧不再向系统申请内存
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include "algorithm_global.h"
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+// 线程安全：同一帧的多个检测器可并发分配（分配粒度为整个 vector 扩容，锁竞争可忽略）
+class ALGORITHM_LIBRARY FrameArena : public std::pmr::memory_resource {
+public:
+  static constexpr std::size_t BLOCK_SIZE = 256 * 1024;
+
+  FrameArena() = default;
+  ~FrameArena() override;
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  // 归还全部内存块，之前分配的内存全部失效
+  void reset();
+
+  // 本帧已分配字节数（含对齐填充）
+  std::size_t bytesAllocated() const;
+
+private:
+  struct Block {
+    char* data = nullptr;
+    std::size_t size = 0;
+    std::size_t used = 0;
+  };
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  void releaseBlocks();
+
+  mutable std::mutex m_mutex;
+  std::vector<Block> m_blocks;
+  std::size_t m_bytesAllocated = 0;
+};
+
+#endif // FRAMEARENA_H
@@ -0,0 +1,151 @@
+#include "FrameContext.h"
+#include <opencv2/imgproc.hpp>
+
+FrameContext::FrameContext(const cv::Mat& image, const cv::Mat& mask)
+    : m_image(image) {
+  if (!mask.empty() && mask.size() == image.size() && mask.type() == CV_8UC1) {
+    m_mask = mask;
+  }
+}
+
+FrameContext::~FrameContext() = default;
+
+template <typename Compute>
+const cv::Mat& FrameContext::product(Product kind, int param, Compute&& compute) const {
+  Slot* slot = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& entry = m_slots[Key(kind, param)];
+    if (!entry) {
+      entry = std::make_unique<Slot>();
+    }
+    slot = entry.get();
+  }
+
+  // 计算期间不持有 m_mutex，依赖其他产物（如模糊依赖灰度）时不会死锁
+  std::call_once(slot->once, [&] {
+    slot->value = compute();
+    m_computed.fetch_add(1);
+  });
+  return slot->value;
+}
+
+const cv::Mat& FrameContext::gray() const {
+  return product(Product::Gray, 0, [this] {
+    if (m_image.channels() == 1) {
+      return m_image;
+    }
+    cv::Mat gray;
+    cv::cvtColor(m_image, gray,
+                 m_image.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    return gray;
+  });
+}
+
+const cv::Mat& FrameContext::gaussian(int ksize) const {
+  ksize |= 1;
+  return product(Product::Gaussian, ksize, [this, ksize] {
+    cv::Mat blurred;
+    cv::GaussianBlur(gray(), blurred, cv::Size(ksize, ksize), 0);
+    return blurred;
+  });
+}
+
+const cv::Mat& FrameContext::median(int ksize) const {
+  ksize |= 1;
+  return product(Product::Median, ksize, [this, ksize] {
+    cv::Mat blurred;
+    cv::medianBlur(gray(), blurred, ksize);
+    return blurred;
+  });
+}
+
+const cv::Mat& FrameContext::lab() const {
+  return product(Product::Lab, 0, [this] {
+    cv::Mat lab;
+    if (m_image.channels() == 3) {
+      cv::cvtColor(m_image, lab, cv::COLOR_BGR2Lab);
+    }
+    return lab;
+  });
+}
+
+const cv::Mat& FrameContext::gradientX() const {
+  return product(Product::GradientX, 0, [this] {
+    cv::Mat grad;
+    cv::Sobel(gray(), grad, CV_64F, 1, 0, 3);
+    return grad;
+  });
+}
+
+const cv::Mat& FrameContext::gradientY() const {
+  return product(Product::GradientY, 0, [this] {
+    cv::Mat grad;
+    cv::Sobel(gray(), grad, CV_64F, 0, 1, 3);
+    return grad;
+  });
+}
+
+const cv::Mat& FrameContext::pyramid(int level) const {
+  if (level <= 0) {
+    return gray();
+  }
+  return product(Product::Pyramid, level, [this, level] {
+    cv::Mat down;
+    cv::pyrDown(pyramid(level - 1), down);
+    return down;
+  });
+}
+
+void FrameContext::prefetch(const Request& request) const {
+  switch (request.product) {
+    case Product::Gray:      gray(); break;
+    case Product::Gaussian:  gaussian(request.param); break;
+    case Product::Median:    median(request.param); break;
+    case Product::Lab:       lab(); break;
+    case Product::GradientX: gradientX(); break;
+    case Product::GradientY: gradientY(); break;
+    case Product::Pyramid:   pyramid(request.param); break;
+  }
+}
+
+bool FrameContext::upstream(const Request& request, Request& parent) {
+  switch (request.product) {
+    case Product::Gray:
+    case Product::Lab:
+      return false;
+    case Product::Pyramid:
+      if (request.param <= 0) {
+        return false;
+      }
+      parent = Request{request.param > 1 ? Product::Pyramid : Product::Gray,
+                       request.param > 1 ? request.param - 1 : 0};
+      return true;
+    default:
+      parent = Request{Product::Gray, 0};
+      return true;
+  }
+}
+
+void FrameContext::applyMask(cv::Mat& binary) const {
+  if (m_mask.empty() || binary.empty()) {
+    return;
+  }
+  if (binary.size() == m_mask.size()) {
+    cv::bitwise_and(binary, m_mask, binary);
+  } else {
+    cv::Mat resized;
+    cv::resize(m_mask, resized, binary.size(), 0, 0, cv::INTER_NEAREST);
+    cv::bitwise_and(binary, resized, binary);
+  }
+}
+
+bool FrameContext::inMask(const cv::Rect& bbox, double scale) const {
+  if (m_mask.empty()) {
+    return true;
+  }
+  cv::Point center(cvRound((bbox.x + bbox.width * 0.5) / scale),
+                   cvRound((bbox.y + bbox.height * 0.5) / scale));
+  return center.x >= 0 && center.y >= 0 && center.x < m_mask.cols && center.y < m_mask.rows &&
+         m_mask.at<uchar>(center) != 0;
+}
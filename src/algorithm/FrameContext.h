@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * FrameContext.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：单帧检测上下文
+ * 描述：持有一帧输入图像，按需惰性计算灰度、模糊、Lab、梯度、金字塔等
+ *       中间产物并缓存，多个检测器并发请求同一产物时只计算一次；
+ *       同时提供本帧内存池，供检测器存放候选缺陷
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef FRAMECONTEXT_H
+#define FRAMECONTEXT_H
+
+#include "algorithm_global.h"
+#include "CancellationToken.h"
+#include "FrameArena.h"
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+// 单帧上下文（线程安全，生命周期覆盖该帧所有检测器的执行）
+// 返回的引用在上下文销毁前有效，调用方不得修改其内容
+class ALGORITHM_LIBRARY FrameContext {
+public:
+  // 中间产物类型（供调度器声明依赖并提前计算）
+  enum class Product { Gray, Gaussian, Median, Lab, GradientX, GradientY, Pyramid };
+
+  // 产物请求：param 为滤波核大小或金字塔层级，其余产物为 0
+  struct Request {
+    Product product = Product::Gray;
+    int param = 0;
+
+    bool operator<(const Request& other) const {
+      return std::make_pair(product, param) < std::make_pair(other.product, other.param);
+    }
+  };
+
+  // mask: 可选检测掩膜（CV_8U，与 image 同尺寸，非零为检测区域），为空表示整图检测
+  explicit FrameContext(const cv::Mat& image, const cv::Mat& mask = cv::Mat());
+  ~FrameContext();
+
+  FrameContext(const FrameContext&) = delete;
+  FrameContext& operator=(const FrameContext&) = delete;
+
+  // 原始输入图像
+  const cv::Mat& image() const { return m_image; }
+  bool empty() const { return m_image.empty(); }
+  int channels() const { return m_image.channels(); }
+
+  // 检测掩膜（ROI 外的像素不应参与阈值化与轮廓提取）
+  const cv::Mat& mask() const { return m_mask; }
+  bool hasMask() const { return !m_mask.empty(); }
+
+  // 将二值图中掩膜外的像素清零，尺寸不同时（如多尺度检测）按最近邻缩放掩膜
+  void applyMask(cv::Mat& binary) const;
+
+  // 缺陷中心是否位于检测区域内（bbox 为 scale 缩放后的坐标），无掩膜时恒为 true
+  bool inMask(const cv::Rect& bbox, double scale = 1.0) const;
+
+  // 协作式取消：同一帧的多个上下文（如各分块）可共享同一令牌
+  void setCancellationToken(const CancellationToken& token) { m_cancel = token; }
+  const CancellationToken& cancellationToken() const { return m_cancel; }
+  void cancel() const { m_cancel.cancel(); }
+  bool isCancelled() const { return m_cancel.isCancelled(); }
+
+  // 灰度图（CV_8U），单通道输入直接共享
+  const cv::Mat& gray() const;
+
+  // 灰度图高斯模糊（ksize x ksize，sigma 由 ksize 推导）
+  const cv::Mat& gaussian(int ksize) const;
+
+  // 灰度图中值滤波
+  const cv::Mat& median(int ksize) const;
+
+  // Lab 颜色空间（仅 3 通道输入，否则返回空 Mat）
+  const cv::Mat& lab() const;
+
+  // 灰度图 Sobel 梯度（3x3，CV_64F）
+  const cv::Mat& gradientX() const;
+  const cv::Mat& gradientY() const;
+
+  // 灰度图像金字塔，level 0 为灰度图本身，每级 pyrDown 一次
+  const cv::Mat& pyramid(int level) const;
+
+  // 计算指定产物（已计算时直接返回）
+  void prefetch(const Request& request) const;
+
+  // 指定产物直接依赖的上游产物（如模糊依赖灰度），无依赖时返回 false
+  static bool upstream(const Request& request, Request& parent);
+
+  // 本帧内存池：存放候选缺陷等只在本帧检测期间使用的临时数据，随上下文销毁归还
+  std::pmr::memory_resource* arena() const { return &m_arena; }
+
+  // 已计算的产物数量（用于验证复用情况）
+  int computedCount() const { return m_computed.load(); }
+
+private:
+  using Key = std::pair<Product, int>;
+
+  struct Slot {
+    std::once_flag once;
+    cv::Mat value;
+  };
+
+  // 查找或创建产物槽位，首次请求时执行计算，并发请求等待同一次计算结果
+  template <typename Compute>
+  const cv::Mat& product(Product kind, int param, Compute&& compute) const;
+
+  cv::Mat m_image;
+  cv::Mat m_mask;
+  CancellationToken m_cancel;
+  mutable std::mutex m_mutex;
+  mutable std::map<Key, std::unique_ptr<Slot>> m_slots;
+  mutable std::atomic<int> m_computed{0};
+  mutable FrameArena m_arena;
+};
+
+#endif // FRAMECONTEXT_H
@@ -18,6 +18,8 @@
 #define IDEFECTDETECTOR_H
 
 #include "algorithm_global.h"
+#include "FrameContext.h"
+#include "Types.h"
 #include <QString>
 #include <QVariantMap>
 #include <vector>
@@ -26,19 +28,7 @@
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
 
-// 缺陷信息结构
-struct DefectInfo {
-  cv::Rect bbox;              // 边界框
-  double confidence = 0.0;    // 置信度 [0, 1]
-  double severity = 0.0;      // 严重度 [0, 1]
-  int classId = 0;            // 类别ID
-  QString className;          // 类别名称
-  QString description;        // 描述信息
-  std::vector<cv::Point> contour;  // 轮廓点（可选）
-  
-  // 额外属性（如长度、面积等）
-  QVariantMap attributes;
-};
+// 缺陷信息结构 DefectInfo 定义于 common/Types.h，检测结果可原样交给 UI 与数据库
 
 // 检测结果结构
 struct DetectionResult {
@@ -46,6 +36,7 @@ struct DetectionResult {
   QString errorMessage;           // 错误信息
   std::vector<DefectInfo> defects; // 检测到的缺陷列表
   double processingTimeMs = 0.0;  // 处理耗时
+  bool cancelled = false;         // 因提前退出被取消（结果不完整，不视为检测失败）
   cv::Mat debugImage;             // 调试图像（可选）
 };
 
@@ -72,6 +63,17 @@ public:
   // 执行检测
   virtual DetectionResult detect(const cv::Mat& image) = 0;
 
+  // 基于共享帧上下文执行检测，可复用其他检测器已计算的灰度/模糊/梯度等中间产物
+  // 默认实现退化为直接检测原图，内置检测器重写此方法
+  virtual DetectionResult detect(const FrameContext& ctx) { return detect(ctx.image()); }
+
+  // 声明检测时会用到的帧上下文中间产物，调度器据此提前并行计算共享产物
+  virtual std::vector<FrameContext::Request> frameProducts() const { return {}; }
+
+  // 能否在图像分块上独立检测。整件测量类检测器（如尺寸测量）需要看到完整工件，
+  // 返回 false 时分块/多 ROI 模式只在整个检测范围上执行一次
+  virtual bool supportsTiling() const { return true; }
+
   // 参数管理
   virtual void setParameters(const QVariantMap& params) = 0;
   virtual QVariantMap parameters() const = 0;
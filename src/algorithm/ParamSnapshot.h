@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * ParamSnapshot.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：检测参数快照
+ * 描述：RCU 方式发布的不可变参数结构。写方（UI、配置加载）编译出新的参数结构后
+ *       原子替换当前指针；读方（检测线程）每帧取一次指针，全程无锁、不复制。
+ *       旧快照在确认没有读方持有后释放（由写方或最后离开的读方回收）
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef PARAMSNAPSHOT_H
+#define PARAMSNAPSHOT_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class ParamSnapshot {
+public:
+  // 读方持有的快照：存活期间所指参数不会被释放
+  class Reader {
+  public:
+    Reader(Reader&& other) noexcept : m_owner(other.m_owner), m_value(other.m_value) {
+      other.m_owner = nullptr;
+    }
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+    Reader& operator=(Reader&&) = delete;
+
+    ~Reader() {
+      if (m_owner && m_owner->m_readers.fetch_sub(1, std::memory_order_release) == 1 &&
+          m_owner->m_hasRetired.load(std::memory_order_relaxed)) {
+        m_owner->tryReclaim();
+      }
+    }
+
+    const T& operator*() const { return *m_value; }
+    const T* operator->() const { return m_value; }
+    const T* get() const { return m_value; }
+
+  private:
+    friend class ParamSnapshot;
+
+    // 先登记再取指针：写方在替换指针后看到读方计数为 0，即可确认之后的读方只会取到新快照
+    explicit Reader(const ParamSnapshot* owner) : m_owner(owner) {
+      owner->m_readers.fetch_add(1, std::memory_order_seq_cst);
+      m_value = owner->m_current.load(std::memory_order_seq_cst);
+    }
+
+    const ParamSnapshot* m_owner;
+    const T* m_value = nullptr;
+  };
+
+  ParamSnapshot() : ParamSnapshot(T{}) {}
+  explicit ParamSnapshot(T initial) : m_current(new T(std::move(initial))) {}
+
+  ~ParamSnapshot() { delete m_current.load(std::memory_order_relaxed); }
+
+  ParamSnapshot(const ParamSnapshot&) = delete;
+  ParamSnapshot& operator=(const ParamSnapshot&) = delete;
+
+  // 读取当前快照（可从任意线程调用，无锁）
+  Reader read() const { return Reader(this); }
+
+  // 发布新快照（写方之间互斥），下一次 read() 起生效
+  void publish(T value) {
+    std::unique_ptr<const T> next(new T(std::move(value)));
+
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    m_retired.emplace_back(m_current.exchange(next.release(), std::memory_order_seq_cst));
+    m_hasRetired.store(true, std::memory_order_relaxed);
+    reclaimLocked();
+  }
+
+  // 等待释放的旧快照数（调试用）
+  std::size_t retiredCount() const {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    return m_retired.size();
+  }
+
+private:
+  // 没有读方在途时，已替换的旧快照不可能再被访问；否则留给最后离开的读方或下一次发布
+  void reclaimLocked() const {
+    if (m_readers.load(std::memory_order_seq_cst) == 0) {
+      m_retired.clear();
+      m_hasRetired.store(false, std::memory_order_relaxed);
+    }
+  }
+
+  // 读方回收不等待：写方正在发布时由写方负责
+  void tryReclaim() const {
+    std::unique_lock<std::mutex> lock(m_writeMutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+      reclaimLocked();
+    }
+  }
+
+  std::atomic<const T*> m_current;
+  mutable std::atomic<int> m_readers{0};
+  mutable std::atomic<bool> m_hasRetired{false};
+
+  mutable std::mutex m_writeMutex;
+  mutable std::vector<std::unique_ptr<const T>> m_retired;
+};
+
+#endif // PARAMSNAPSHOT_H
@@ -9,7 +9,7 @@ include($$PWD/../../config/config.pri)
 TEMPLATE = lib
 TARGET = algorithm
 
-QT += core concurrent
+QT += core
 QT -= gui
 
 DEFINES += ALGORITHM_LIBRARY_BUILD
@@ -24,9 +24,14 @@ INCLUDEPATH += $$PWD/../../config
 HEADERS += \
     algorithm_pch.h \
     BaseDetector.h \
+    CancellationToken.h \
     DetectorFactory.h \
+    DetectorGraph.h \
     DetectorManager.h \
+    FrameArena.h \
+    FrameContext.h \
     IDefectDetector.h \
+    ParamSnapshot.h \
     algorithm_global.h \
     detectors/CrackDetector.h \
     detectors/DimensionDetector.h \
@@ -42,6 +47,7 @@ HEADERS += \
     postprocess/DefectMerger.h \
     postprocess/NMSFilter.h \
     preprocess/Calibration.h \
+    preprocess/GaborFilterBank.h \
     preprocess/ImagePreprocessor.h \
     preprocess/PreprocessCache.h \
     preprocess/ROIManager.h \
@@ -51,7 +57,10 @@ HEADERS += \
 # ------------------ 源文件 ------------------
 SOURCES += \
     DetectorFactory.cpp \
+    DetectorGraph.cpp \
     DetectorManager.cpp \
+    FrameArena.cpp \
+    FrameContext.cpp \
     detectors/CrackDetector.cpp \
     detectors/DimensionDetector.cpp \
     detectors/ForeignDetector.cpp \
@@ -61,8 +70,10 @@ SOURCES += \
     dnn/YoloDetector.cpp \
     plugin/PluginManager.cpp \
     postprocess/NMSFilter.cpp \
+    preprocess/GaborFilterBank.cpp \
     preprocess/ImagePreprocessor.cpp \
     preprocess/PreprocessCache.cpp \
+    preprocess/ROIManager.cpp \
     scoring/DefectScorer.cpp
 
 # OpenCV 链接（MinGW）
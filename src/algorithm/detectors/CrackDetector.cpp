@@ -18,60 +18,164 @@
 #include "CrackDetector.h"
 #include "../postprocess/NMSFilter.h"
 #include "../common/Logger.h"
+#include "../common/ParallelFor.h"
 #include <QElapsedTimer>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace {
+
+// 3×3 邻域编码：从正上方起顺时针 P2..P9 依次对应 bit0..bit7
+//   P9 P2 P3
+//   P8 P1 P4
+//   P7 P6 P5
+constexpr uchar NB_N = 1 << 0, NB_NE = 1 << 1, NB_E = 1 << 2, NB_SE = 1 << 3;
+constexpr uchar NB_S = 1 << 4, NB_SW = 1 << 5, NB_W = 1 << 6, NB_NW = 1 << 7;
+constexpr uchar NB_ORTHOGONAL = NB_N | NB_E | NB_S | NB_W;
+constexpr uchar NB_DIAGONAL = NB_NE | NB_SE | NB_SW | NB_NW;
+
+// 非零即前景（0/1 与 0/255 图像通用）；调用方保证 x-1、x+1 可访问
+inline uchar neighborhoodCode(const uchar* up, const uchar* mid, const uchar* down, int x) {
+  return static_cast<uchar>((up[x] ? NB_N : 0) | (up[x + 1] ? NB_NE : 0) | (mid[x + 1] ? NB_E : 0) |
+                            (down[x + 1] ? NB_SE : 0) | (down[x] ? NB_S : 0) | (down[x - 1] ? NB_SW : 0) |
+                            (mid[x - 1] ? NB_W : 0) | (up[x - 1] ? NB_NW : 0));
+}
+
+// Zhang-Suen 删除条件查找表，pass 0/1 对应两个子迭代
+const std::array<uchar, 256>& thinningTable(int pass) {
+  static const std::array<std::array<uchar, 256>, 2> tables = [] {
+    std::array<std::array<uchar, 256>, 2> t{};
+    for (int code = 0; code < 256; ++code) {
+      int p[9];
+      for (int i = 0; i < 8; ++i) {
+        p[i] = (code >> i) & 1;   // p[0..7] = P2..P9
+      }
+      p[8] = p[0];
+      
+      const int b = p[0] + p[1] + p[2] + p[3] + p[4] + p[5] + p[6] + p[7];
+      int a = 0;
+      for (int i = 0; i < 8; ++i) {
+        a += (p[i] == 0 && p[i + 1] == 1);
+      }
+      const int p2 = p[0], p4 = p[2], p6 = p[4], p8 = p[6];
+      const bool base = b >= 2 && b <= 6 && a == 1;
+      t[0][code] = base && p2 * p4 * p6 == 0 && p4 * p6 * p8 == 0;
+      t[1][code] = base && p2 * p4 * p8 == 0 && p2 * p6 * p8 == 0;
+    }
+    return t;
+  }();
+  return tables[pass];
+}
+
+// 骨架像素分类表：交叉数与长度贡献（纯对角连接 √2/2，纯正交 0.5，混合或孤立 0.75）
+// 交叉数为 P2..P9 循环一周 0→1 的次数：1 为端点，3 以上为分支点。
+// 细化结果在拐角处存在阶梯状像素（邻居数为 3 但只有一条通路），按邻居数判定会误计为分支
+struct SkeletonPixelTable {
+  std::array<uchar, 256> crossings{};
+  std::array<double, 256> length{};
+};
+
+const SkeletonPixelTable& skeletonPixelTable() {
+  static const SkeletonPixelTable table = [] {
+    SkeletonPixelTable t;
+    for (int code = 0; code < 256; ++code) {
+      int crossings = 0;
+      for (int i = 0; i < 8; ++i) {
+        crossings += !((code >> i) & 1) && ((code >> ((i + 1) % 8)) & 1);
+      }
+      t.crossings[code] = static_cast<uchar>(crossings);
+      
+      const bool diagonal = (code & NB_DIAGONAL) != 0;
+      const bool orthogonal = (code & NB_ORTHOGONAL) != 0;
+      if (diagonal && !orthogonal) {
+        t.length[code] = std::sqrt(2.0) / 2.0;
+      } else if (!diagonal && orthogonal) {
+        t.length[code] = 0.5;
+      } else {
+        t.length[code] = 0.75;
+      }
+    }
+    return t;
+  }();
+  return table;
+}
+
+} // namespace
 
 CrackDetector::CrackDetector() {
   m_confidenceThreshold = 0.5;
 }
 
 bool CrackDetector::initialize() {
-  updateParameters();
+  // 预先生成 Gabor 滤波器组（之后仅在方向数变化时重建）
+  if (!m_paramSnapshot.read()->gaborBank) {
+    setParameters(parameters());
+  }
   m_initialized = true;
   return true;
 }
 
 void CrackDetector::release() {
+  // 各卷积路径累计耗时，供选择 gaborMethod 参考
+  if (const auto bank = m_paramSnapshot.read()->gaborBank) {
+    for (auto method : {GaborFilterBank::Method::Direct, GaborFilterBank::Method::Separable,
+                        GaborFilterBank::Method::Dft}) {
+      const GaborFilterBank::PathTiming timing = bank->timing(method);
+      if (timing.calls > 0) {
+        LOG_INFO("CrackDetector - Gabor path {}: {} calls, avg {:.2f}ms",
+                 GaborFilterBank::methodName(method), timing.calls, timing.averageMs());
+      }
+    }
+  }
   m_initialized = false;
 }
 
-void CrackDetector::updateParameters() {
-  m_threshold = getParam<int>("threshold", 80);
-  m_minArea = getParam<int>("minArea", 20);
-  m_morphKernelSize = getParam<int>("morphKernelSize", 3);
-  m_binaryThreshold = getParam<int>("binaryThreshold", 128);
-  m_useGabor = getParam<bool>("useGabor", true);
+void CrackDetector::compileParameters(const QVariantMap& params) {
+  Params compiled;
+  compiled.threshold = paramValue<int>(params, "threshold", 80);
+  compiled.minArea = paramValue<int>(params, "minArea", 20);
+  compiled.morphKernelSize = paramValue<int>(params, "morphKernelSize", 3);
+  compiled.binaryThreshold = paramValue<int>(params, "binaryThreshold", 128);
+  compiled.useGabor = paramValue<bool>(params, "useGabor", true);
+  compiled.gaborOrientations = qBound(1, paramValue<int>(params, "gaborOrientations", 4), 16);
+  compiled.gaborMethod = GaborFilterBank::methodFromName(paramValue<QString>(params, "gaborMethod", "auto"));
+  compiled.morphologicalSkeleton =
+      paramValue<QString>(params, "skeletonMethod", "thinning").compare("morphological", Qt::CaseInsensitive) == 0;
+
+  // 滤波器组只依赖方向数（其余 Gabor 参数固定），方向数不变则沿用当前快照中的实例
+  const auto current = m_paramSnapshot.read();
+  if (current->gaborBank && current->gaborBank->orientationCount() == compiled.gaborOrientations) {
+    compiled.gaborBank = current->gaborBank;
+  } else {
+    GaborFilterBank::Config bankConfig;
+    bankConfig.orientations = compiled.gaborOrientations;
+    compiled.gaborBank = std::make_shared<const GaborFilterBank>(bankConfig);
+  }
+  m_paramSnapshot.publish(std::move(compiled));
 }
 
-cv::Mat CrackDetector::applyGaborFilter(const cv::Mat& gray) {
-  // 多方向 Gabor 滤波器，增强线性特征
-  std::vector<double> orientations = {0, 45, 90, 135};  // 4个方向
-  int kernelSize = 21;
-  double sigma = 4.0;
-  double lambda = 10.0;
-  double gamma = 0.5;
-  double psi = 0;
-  
-  cv::Mat result = cv::Mat::zeros(gray.size(), CV_32F);
-  
-  for (double theta : orientations) {
-    double thetaRad = theta * CV_PI / 180.0;
-    
-    // 创建 Gabor 核
-    cv::Mat gaborKernel = cv::getGaborKernel(
-        cv::Size(kernelSize, kernelSize),
-        sigma, thetaRad, lambda, gamma, psi, CV_32F
-    );
-    
-    // 应用滤波
-    cv::Mat filtered;
-    cv::filter2D(gray, filtered, CV_32F, gaborKernel);
-    
-    // 取绝对值并累加最大响应
-    cv::Mat absFiltered = cv::abs(filtered);
-    result = cv::max(result, absFiltered);
+cv::Mat CrackDetector::applyGaborFilter(const cv::Mat& gray, const Params& params) {
+  // 多方向 Gabor 滤波器，增强线性特征（各方向响应绝对值取最大）
+  std::shared_ptr<const GaborFilterBank> bank = params.gaborBank;
+  if (!bank) {
+    // 未调用 initialize() 时临时生成
+    GaborFilterBank::Config bankConfig;
+    bankConfig.orientations = params.gaborOrientations;
+    bank = std::make_shared<const GaborFilterBank>(bankConfig);
   }
   
+  QElapsedTimer timer;
+  timer.start();
+  GaborFilterBank::Method used = GaborFilterBank::Method::Auto;
+  cv::Mat result = bank->maxResponse(gray, params.gaborMethod, &used);
+  LOG_DEBUG("CrackDetector::applyGaborFilter - path={}, orientations={}, {}x{}, time:{:.2f}ms",
+            GaborFilterBank::methodName(used), bank->orientationCount(), gray.cols, gray.rows,
+            timer.nsecsElapsed() / 1e6);
+  
   // 归一化到 0-255
   cv::normalize(result, result, 0, 255, cv::NORM_MINMAX);
   cv::Mat output;
@@ -80,122 +184,236 @@ cv::Mat CrackDetector::applyGaborFilter(const cv::Mat& gray) {
   return output;
 }
 
-cv::Mat CrackDetector::skeletonize(const cv::Mat& binary) {
-  // Zhang-Suen 骨架化算法实现
-  cv::Mat img = binary.clone();
-  img /= 255;  // 归一化到 0-1
+cv::Mat CrackDetector::skeletonize(const cv::Mat& binary, const CancellationToken& cancel) {
+  CV_Assert(binary.type() == CV_8UC1);
   
-  cv::Mat skeleton = cv::Mat::zeros(img.size(), CV_8UC1);
-  cv::Mat temp;
-  cv::Mat eroded;
+  // Zhang-Suen 细化：两个子迭代交替执行，每个子迭代内所有删除都依据子迭代开始时的图像判定。
+  // 3×3 邻域编码为 8 位后查表；每行只重算邻域发生过变化的列区间（脏区间），按行并行
+  const std::array<uchar, 256>* tables[2] = {&thinningTable(0), &thinningTable(1)};
   
-  // 形态学骨架化
-  cv::Mat element = cv::getStructuringElement(cv::MORPH_CROSS, cv::Size(3, 3));
+  // 0/1 图像，四周补一圈 0，邻域访问不做边界判断
+  cv::Mat img;
+  cv::copyMakeBorder(binary, img, 1, 1, 1, 1, cv::BORDER_CONSTANT, 0);
+  cv::threshold(img, img, 0, 1, cv::THRESH_BINARY);
   
-  bool done = false;
-  do {
-    cv::erode(img, eroded, element);
-    cv::dilate(eroded, temp, element);
-    cv::subtract(img, temp, temp);
-    cv::bitwise_or(skeleton, temp, skeleton);
-    eroded.copyTo(img);
-    
-    done = (cv::countNonZero(img) == 0);
-  } while (!done);
+  const int rows = binary.rows;
+  const int cols = binary.cols;
+  cv::Mat next(img.size(), CV_8UC1);
   
-  skeleton *= 255;  // 恢复到 0-255
-  return skeleton;
-}
-
-int CrackDetector::countBranchPoints(const cv::Mat& skeleton, const cv::Rect& roi) {
-  // 提取 ROI 区域
-  cv::Mat region = skeleton(roi);
+  // 列区间 [lo, hi]（补边坐标），lo > hi 表示空
+  struct Span {
+    int lo;
+    int hi;
+    bool empty() const { return lo > hi; }
+  };
+  const Span emptySpan{cols + 1, 0};
   
-  int branchPoints = 0;
+  // dirty[k][y]: 第 y 行自上次执行子迭代 k 以来邻域有变化的列区间；changed[y]: 本子迭代删除的列区间
+  std::vector<Span> dirty[2] = {std::vector<Span>(rows + 2, Span{1, cols}),
+                                std::vector<Span>(rows + 2, Span{1, cols})};
+  dirty[0][0] = dirty[1][0] = dirty[0][rows + 1] = dirty[1][rows + 1] = emptySpan;
+  std::vector<Span> changed(rows + 2, emptySpan);
+  std::vector<int> activeRows;
+  activeRows.reserve(rows);
   
-  // 遍历骨架点，计算8邻域连接数
-  for (int y = 1; y < region.rows - 1; ++y) {
-    for (int x = 1; x < region.cols - 1; ++x) {
-      if (region.at<uchar>(y, x) == 0) continue;
-      
-      // 计算8邻域中的骨架点数量
-      int neighbors = 0;
-      for (int dy = -1; dy <= 1; ++dy) {
-        for (int dx = -1; dx <= 1; ++dx) {
-          if (dx == 0 && dy == 0) continue;
-          if (region.at<uchar>(y + dy, x + dx) > 0) {
-            neighbors++;
+  for (int pass = 0, idlePasses = 0; idlePasses < 2; pass ^= 1) {
+    if (cancel.isCancelled()) {
+      return cv::Mat();
+    }
+    
+    activeRows.clear();
+    for (int y = 1; y <= rows; ++y) {
+      if (!dirty[pass][y].empty()) {
+        activeRows.push_back(y);
+      }
+    }
+    
+    // 判定阶段只读 img 与脏区间，只写 next、changed 的对应行
+    const std::array<uchar, 256>& table = *tables[pass];
+    std::vector<Span>& spans = dirty[pass];
+    parallelFor(0, static_cast<int>(activeRows.size()), [&](int first, int last) {
+      for (int i = first; i < last; ++i) {
+        const int y = activeRows[i];
+        const uchar* up = img.ptr<uchar>(y - 1);
+        const uchar* mid = img.ptr<uchar>(y);
+        const uchar* down = img.ptr<uchar>(y + 1);
+        uchar* dst = next.ptr<uchar>(y);
+        Span rowChanged = emptySpan;
+        const int hi = spans[y].hi;
+        for (int x = spans[y].lo; x <= hi; ++x) {
+          // 骨架图稀疏：整 8 字节为背景时跳过
+          if (x + 8 <= hi + 1) {
+            std::uint64_t word;
+            std::memcpy(&word, mid + x, sizeof(word));
+            if (word == 0) {
+              std::memset(dst + x, 0, 8);
+              x += 7;
+              continue;
+            }
           }
+          uchar value = mid[x];
+          if (value && table[neighborhoodCode(up, mid, down, x)]) {
+            value = 0;
+            rowChanged.lo = std::min(rowChanged.lo, x);
+            rowChanged.hi = x;
+          }
+          dst[x] = value;
         }
+        changed[y] = rowChanged;
       }
-      
-      // 3个以上邻居表示分支点
-      if (neighbors >= 3) {
-        branchPoints++;
+    });
+    
+    // 提交阶段：删除区间写回，并把上下相邻行的对应区间标记为两个子迭代的脏区间
+    for (int y : activeRows) {
+      spans[y] = emptySpan;
+    }
+    bool anyChanged = false;
+    for (int y : activeRows) {
+      const Span span = changed[y];
+      if (span.empty()) {
+        continue;
+      }
+      anyChanged = true;
+      std::memcpy(img.ptr<uchar>(y) + span.lo, next.ptr<uchar>(y) + span.lo, span.hi - span.lo + 1);
+      const int lo = std::max(1, span.lo - 1);
+      const int hi = std::min(cols, span.hi + 1);
+      for (int k = 0; k < 2; ++k) {
+        for (int yy = std::max(1, y - 1); yy <= std::min(rows, y + 1); ++yy) {
+          dirty[k][yy].lo = std::min(dirty[k][yy].lo, lo);
+          dirty[k][yy].hi = std::max(dirty[k][yy].hi, hi);
+        }
       }
     }
+    // 连续两个子迭代都没有删除即收敛
+    idlePasses = anyChanged ? 0 : idlePasses + 1;
   }
   
-  return branchPoints;
+  cv::Mat skeleton;
+  img(cv::Rect(1, 1, cols, rows)).convertTo(skeleton, CV_8U, 255);
+  return skeleton;
 }
 
-double CrackDetector::measureSkeletonLength(const cv::Mat& skeleton, const cv::Rect& roi) {
-  // 提取 ROI 区域
-  cv::Mat region = skeleton(roi);
+std::vector<CrackDetector::SkeletonStats> CrackDetector::measureSkeletons(const cv::Mat& skeleton,
+                                                                         const cv::Mat& labels, int numLabels) {
+  CV_Assert(skeleton.type() == CV_8UC1 && labels.type() == CV_32SC1 && labels.size() == skeleton.size());
   
-  // 统计骨架像素数量
-  int pixelCount = cv::countNonZero(region);
+  // 单次遍历：按邻域编码同时得到交叉数（端点/分支点）与长度贡献，按连通域累加。
+  // 8 连通标记下邻居必属同一连通域，统计不受外接矩形内其他连通域影响
+  const SkeletonPixelTable& table = skeletonPixelTable();
+  std::vector<SkeletonStats> result(numLabels);
   
-  // 考虑对角线连接（对角线距离为 sqrt(2)）
-  double length = 0;
+  cv::Mat padded;
+  cv::copyMakeBorder(skeleton, padded, 1, 1, 1, 1, cv::BORDER_CONSTANT, 0);
   
-  for (int y = 1; y < region.rows - 1; ++y) {
-    for (int x = 1; x < region.cols - 1; ++x) {
-      if (region.at<uchar>(y, x) == 0) continue;
-      
-      // 检查8邻域连接方向
-      bool hasDiagonal = false;
-      bool hasOrthogonal = false;
+  for (int y = 0; y < skeleton.rows; ++y) {
+    const uchar* up = padded.ptr<uchar>(y);
+    const uchar* mid = padded.ptr<uchar>(y + 1);
+    const uchar* down = padded.ptr<uchar>(y + 2);
+    const int* labelRow = labels.ptr<int>(y);
+    for (int x = 0; x < skeleton.cols; ++x) {
+      if (mid[x + 1] == 0) continue;
+      const int label = labelRow[x];
+      if (label <= 0 || label >= numLabels) continue;
       
-      // 对角线方向
-      if (region.at<uchar>(y-1, x-1) > 0 || region.at<uchar>(y-1, x+1) > 0 ||
-          region.at<uchar>(y+1, x-1) > 0 || region.at<uchar>(y+1, x+1) > 0) {
-        hasDiagonal = true;
-      }
-      // 正交方向
-      if (region.at<uchar>(y-1, x) > 0 || region.at<uchar>(y+1, x) > 0 ||
-          region.at<uchar>(y, x-1) > 0 || region.at<uchar>(y, x+1) > 0) {
-        hasOrthogonal = true;
-      }
-      
-      // 估算贡献长度
-      if (hasDiagonal && !hasOrthogonal) {
-        length += std::sqrt(2.0) / 2.0;
-      } else if (!hasDiagonal && hasOrthogonal) {
-        length += 0.5;
-      } else {
-        length += 0.75;  // 混合情况
+      const uchar code = neighborhoodCode(up, mid, down, x + 1);
+      const int crossings = table.crossings[code];
+      SkeletonStats& stats = result[label];
+      stats.pixels++;
+      stats.length += table.length[code];
+      if (crossings == 1) {
+        stats.endPoints++;
+      } else if (crossings >= 3) {
+        stats.branchPoints++;
       }
     }
   }
   
-  // 简化：直接使用像素数作为长度估计
-  return std::max(length, static_cast<double>(pixelCount) * 0.8);
+  // 与像素数估计取大（短斜线段的逐点估计偏小）
+  for (SkeletonStats& stats : result) {
+    stats.length = std::max(stats.length, stats.pixels * 0.8);
+  }
+  return result;
 }
 
-cv::Mat CrackDetector::preprocessImage(const cv::Mat& input) {
-  cv::Mat gray, enhanced, blurred, binary;
+cv::Mat CrackDetector::skeletonizeMorphological(const cv::Mat& binary, const CancellationToken& cancel) {
+  cv::Mat img = binary.clone();
+  img /= 255;  // 归一化到 0-1
+  
+  cv::Mat skeleton = cv::Mat::zeros(img.size(), CV_8UC1);
+  cv::Mat temp;
+  cv::Mat eroded;
+  const cv::Mat element = cv::getStructuringElement(cv::MORPH_CROSS, cv::Size(3, 3));
+  
+  // 每轮：骨架 |= 图像 - 开运算(图像)，图像 = 腐蚀(图像)，直到图像为空
+  do {
+    if (cancel.isCancelled()) {
+      return cv::Mat();
+    }
+    cv::erode(img, eroded, element);
+    cv::dilate(eroded, temp, element);
+    cv::subtract(img, temp, temp);
+    cv::bitwise_or(skeleton, temp, skeleton);
+    eroded.copyTo(img);
+  } while (cv::countNonZero(img) > 0);
+  
+  skeleton *= 255;  // 恢复到 0-255
+  return skeleton;
+}
 
-  // 转灰度
-  if (input.channels() == 3) {
-    cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
-  } else {
-    gray = input.clone();
+std::vector<CrackDetector::SkeletonStats> CrackDetector::measureSkeletonsByBox(const cv::Mat& skeleton,
+                                                                              const cv::Mat& componentStats,
+                                                                              int numLabels) {
+  CV_Assert(skeleton.type() == CV_8UC1 && componentStats.type() == CV_32SC1 && componentStats.rows >= numLabels);
+  std::vector<SkeletonStats> result(numLabels);
+  
+  for (int i = 1; i < numLabels; ++i) {
+    const cv::Rect bbox = cv::Rect(componentStats.at<int>(i, cv::CC_STAT_LEFT), componentStats.at<int>(i, cv::CC_STAT_TOP),
+                                   componentStats.at<int>(i, cv::CC_STAT_WIDTH),
+                                   componentStats.at<int>(i, cv::CC_STAT_HEIGHT)) &
+                          cv::Rect(0, 0, skeleton.cols, skeleton.rows);
+    if (bbox.empty()) continue;
+    const cv::Mat region = skeleton(bbox);
+    SkeletonStats& stats = result[i];
+    stats.pixels = cv::countNonZero(region);
+    
+    // 外接矩形内逐点扫描（边框一圈不计）：邻居数 >= 3 计为分支点，按对角/正交连接累加长度
+    double length = 0.0;
+    for (int y = 1; y < region.rows - 1; ++y) {
+      const uchar* up = region.ptr<uchar>(y - 1);
+      const uchar* mid = region.ptr<uchar>(y);
+      const uchar* down = region.ptr<uchar>(y + 1);
+      for (int x = 1; x < region.cols - 1; ++x) {
+        if (mid[x] == 0) continue;
+        const bool diagonal = up[x - 1] || up[x + 1] || down[x - 1] || down[x + 1];
+        const bool orthogonal = up[x] || down[x] || mid[x - 1] || mid[x + 1];
+        const int neighbors = (up[x - 1] > 0) + (up[x] > 0) + (up[x + 1] > 0) + (mid[x - 1] > 0) +
+                              (mid[x + 1] > 0) + (down[x - 1] > 0) + (down[x] > 0) + (down[x + 1] > 0);
+        if (neighbors >= 3) {
+          stats.branchPoints++;
+        }
+        if (diagonal && !orthogonal) {
+          length += std::sqrt(2.0) / 2.0;
+        } else if (!diagonal && orthogonal) {
+          length += 0.5;
+        } else {
+          length += 0.75;  // 混合或孤立
+        }
+      }
+    }
+    stats.length = std::max(length, stats.pixels * 0.8);
   }
+  return result;
+}
+
+cv::Mat CrackDetector::preprocessImage(const FrameContext& ctx, const Params& params) {
+  cv::Mat enhanced, blurred, binary;
+
+  // 灰度图由帧上下文共享，只读使用
+  const cv::Mat& gray = ctx.gray();
 
   // Gabor 滤波增强线性特征
-  if (m_useGabor) {
-    enhanced = applyGaborFilter(gray);
+  if (params.useGabor) {
+    enhanced = applyGaborFilter(gray, params);
   } else {
     // CLAHE 增强对比度
     cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE(2.0, cv::Size(8, 8));
@@ -211,7 +429,7 @@ cv::Mat CrackDetector::preprocessImage(const cv::Mat& input) {
                         cv::THRESH_BINARY_INV, 11, 2);
 
   // 形态学操作：闭运算填充小孔
-  int kernelSize = m_morphKernelSize | 1;
+  int kernelSize = params.morphKernelSize | 1;
   cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, 
                                               cv::Size(kernelSize, kernelSize));
   cv::morphologyEx(binary, binary, cv::MORPH_CLOSE, kernel);
@@ -220,46 +438,62 @@ cv::Mat CrackDetector::preprocessImage(const cv::Mat& input) {
 }
 
 DetectionResult CrackDetector::detect(const cv::Mat& image) {
+  FrameContext ctx(image);
+  return detect(ctx);
+}
+
+DetectionResult CrackDetector::detect(const FrameContext& ctx) {
   QElapsedTimer timer;
   timer.start();
 
+  const cv::Mat& image = ctx.image();
   if (image.empty()) {
     LOG_ERROR("CrackDetector::detect - Input image is empty");
     return makeErrorResult("Empty input image");
   }
 
-  updateParameters();
+  // 本帧参数快照（参数修改从下一帧生效）
+  const auto params = m_paramSnapshot.read();
   
   LOG_DEBUG("CrackDetector::detect - Input: {}x{}, params: threshold={}, minArea={}, morphKernel={}, useGabor={}",
-            image.cols, image.rows, m_threshold, m_minArea, m_morphKernelSize, m_useGabor);
+            image.cols, image.rows, params->threshold, params->minArea, params->morphKernelSize, params->useGabor);
 
   // 预处理
-  cv::Mat binary = preprocessImage(image);
+  cv::Mat binary = preprocessImage(ctx, *params);
+
+  // ROI 外像素不参与骨架化与轮廓提取
+  ctx.applyMask(binary);
   
-  // 骨架化
-  cv::Mat skeleton = skeletonize(binary);
+  // 骨架化（细化轮数约为裂纹半宽，每个子迭代检查取消）
+  cv::Mat skeleton = params->morphologicalSkeleton ? skeletonizeMorphological(binary, ctx.cancellationToken())
+                                                   : skeletonize(binary, ctx.cancellationToken());
+  if (ctx.isCancelled()) {
+    return makeCancelledResult(timer.elapsed());
+  }
 
   // 查找裂纹（使用轮廓方法）
-  std::vector<DefectInfo> contourDefects = findCracks(binary, image);
+  std::vector<DefectInfo> contourDefects = findCracks(binary, image, *params);
   
   // 骨架分析（补充方法）
-  std::vector<DefectInfo> skeletonDefects = analyzeSkeleton(skeleton, binary, image);
+  std::vector<DefectInfo> skeletonDefects = analyzeSkeleton(skeleton, binary, image, *params);
   
   // 合并结果
-  std::vector<DefectInfo> allDefects;
-  allDefects.insert(allDefects.end(), contourDefects.begin(), contourDefects.end());
-  allDefects.insert(allDefects.end(), skeletonDefects.begin(), skeletonDefects.end());
+  const size_t contourCount = contourDefects.size();
+  const size_t skeletonCount = skeletonDefects.size();
+  std::vector<DefectInfo> allDefects = std::move(contourDefects);
+  allDefects.insert(allDefects.end(), std::make_move_iterator(skeletonDefects.begin()),
+                    std::make_move_iterator(skeletonDefects.end()));
   
   // 使用 NMSFilter 去重
   size_t beforeNMS = allDefects.size();
   NMSFilter nmsFilter;
   nmsFilter.setIoUThreshold(0.5);
   nmsFilter.setConfidenceThreshold(0.0);
-  allDefects = nmsFilter.filter(allDefects);
+  allDefects = nmsFilter.filter(std::move(allDefects));
 
   // 过滤低置信度
   size_t beforeFilter = allDefects.size();
-  allDefects = filterByConfidence(allDefects);
+  allDefects = filterByConfidence(std::move(allDefects));
 
   double timeMs = timer.elapsed();
   
@@ -267,28 +501,32 @@ DetectionResult CrackDetector::detect(const cv::Mat& image) {
   double totalArea = 0, maxComplexity = 0, totalLength = 0;
   int totalBranches = 0;
   for (const auto& d : allDefects) {
-    if (d.attributes.contains("area")) totalArea += d.attributes.value("area").toDouble();
-    if (d.attributes.contains("complexity")) maxComplexity = std::max(maxComplexity, d.attributes.value("complexity").toDouble());
-    if (d.attributes.contains("skeletonLength")) totalLength += d.attributes.value("skeletonLength").toDouble();
-    if (d.attributes.contains("branchPoints")) totalBranches += d.attributes.value("branchPoints").toInt();
+    totalArea += d.features.get(DefectFeatures::Area);
+    maxComplexity = std::max(maxComplexity, d.features.get(DefectFeatures::Complexity));
+    totalLength += d.features.get(DefectFeatures::SkeletonLength);
+    totalBranches += static_cast<int>(d.features.get(DefectFeatures::BranchPoints));
   }
   
   LOG_INFO("CrackDetector::detect - Result: {} cracks (contour:{}, skeleton:{}), NMS:{}->{}, filter:{}->{}, totalArea={:.0f}px, totalLength={:.0f}px, branches={}, time:{:.1f}ms",
-           allDefects.size(), contourDefects.size(), skeletonDefects.size(),
+           allDefects.size(), contourCount, skeletonCount,
            beforeNMS, beforeFilter, beforeFilter, allDefects.size(),
            totalArea, totalLength, totalBranches, timeMs);
   
-  return makeSuccessResult(allDefects, timeMs);
+  return makeSuccessResult(std::move(allDefects), timeMs);
 }
 
 std::vector<DefectInfo> CrackDetector::analyzeSkeleton(const cv::Mat& skeleton, 
                                                         const cv::Mat& binary,
-                                                        const cv::Mat& /*original*/) {
+                                                        const cv::Mat& /*original*/,
+                                                        const Params& params) {
   std::vector<DefectInfo> defects;
   
   // 在骨架上查找连通域
   cv::Mat labels, stats, centroids;
-  int numLabels = cv::connectedComponentsWithStats(skeleton, labels, stats, centroids);
+  int numLabels = cv::connectedComponentsWithStats(skeleton, labels, stats, centroids, 8, CV_32S);
+  const std::vector<SkeletonStats> componentStats = params.morphologicalSkeleton
+      ? measureSkeletonsByBox(skeleton, stats, numLabels)
+      : measureSkeletons(skeleton, labels, numLabels);
   
   for (int i = 1; i < numLabels; ++i) {  // 跳过背景
     int x = stats.at<int>(i, cv::CC_STAT_LEFT);
@@ -305,12 +543,12 @@ std::vector<DefectInfo> CrackDetector::analyzeSkeleton(const cv::Mat& skeleton,
     bbox &= cv::Rect(0, 0, skeleton.cols, skeleton.rows);
     if (bbox.empty()) continue;
     
-    // 测量骨架长度
-    double skeletonLength = measureSkeletonLength(skeleton, bbox);
-    if (skeletonLength < m_minArea / 2) continue;
+    // 骨架长度与分支点（单次遍历预先统计）
+    const SkeletonStats& skeletonStats = componentStats[i];
+    double skeletonLength = skeletonStats.length;
+    if (skeletonLength < params.minArea / 2) continue;
     
-    // 计算分支点数量
-    int branchPoints = countBranchPoints(skeleton, bbox);
+    int branchPoints = skeletonStats.branchPoints;
     
     // 获取对应的二值区域面积
     cv::Mat binaryROI = binary(bbox);
@@ -337,19 +575,21 @@ std::vector<DefectInfo> CrackDetector::analyzeSkeleton(const cv::Mat& skeleton,
     defect.severity = calculateSeverity(area, skeletonLength, branchPoints);
     
     // 附加属性
-    defect.attributes["area"] = area;
-    defect.attributes["skeletonLength"] = skeletonLength;
-    defect.attributes["branchPoints"] = branchPoints;
-    defect.attributes["complexity"] = complexity;
-    defect.attributes["method"] = "skeleton";
-
-    defects.push_back(defect);
+    defect.features.method = DetectionMethod::Skeleton;
+    defect.features.set(DefectFeatures::Area, area);
+    defect.features.set(DefectFeatures::SkeletonLength, skeletonLength);
+    defect.features.set(DefectFeatures::BranchPoints, branchPoints);
+    defect.features.set(DefectFeatures::EndPoints, skeletonStats.endPoints);
+    defect.features.set(DefectFeatures::Complexity, complexity);
+
+    defects.push_back(std::move(defect));
   }
   
   return defects;
 }
 
-std::vector<DefectInfo> CrackDetector::findCracks(const cv::Mat& binary, const cv::Mat& /*original*/) {
+std::vector<DefectInfo> CrackDetector::findCracks(const cv::Mat& binary, const cv::Mat& /*original*/,
+                                                   const Params& params) {
   std::vector<DefectInfo> defects;
 
   // 查找轮廓
@@ -365,7 +605,7 @@ std::vector<DefectInfo> CrackDetector::findCracks(const cv::Mat& binary, const c
     }
 
     double area = cv::contourArea(contour);
-    if (area < m_minArea) {
+    if (area < params.minArea) {
       continue;
     }
 
@@ -401,14 +641,14 @@ std::vector<DefectInfo> CrackDetector::findCracks(const cv::Mat& binary, const c
     defect.severity = calculateSeverity(area, length, 0);
     
     // 附加属性
-    defect.attributes["area"] = area;
-    defect.attributes["perimeter"] = perimeter;
-    defect.attributes["complexity"] = complexity;
-    defect.attributes["length"] = length;
-    defect.attributes["width"] = width;
-    defect.attributes["method"] = "contour";
-
-    defects.push_back(defect);
+    defect.features.method = DetectionMethod::Contour;
+    defect.features.set(DefectFeatures::Area, area);
+    defect.features.set(DefectFeatures::Perimeter, perimeter);
+    defect.features.set(DefectFeatures::Complexity, complexity);
+    defect.features.set(DefectFeatures::Length, length);
+    defect.features.set(DefectFeatures::Width, width);
+
+    defects.push_back(std::move(defect));
   }
 
   return defects;
@@ -18,6 +18,8 @@
 #define CRACKDETECTOR_H
 
 #include "../BaseDetector.h"
+#include "../preprocess/GaborFilterBank.h"
+#include <memory>
 
 // 裂纹检测器：使用二值化+形态学+连通域分析
 class ALGORITHM_LIBRARY CrackDetector : public BaseDetector {
@@ -32,24 +34,57 @@ public:
   bool initialize() override;
   void release() override;
   DetectionResult detect(const cv::Mat& image) override;
+  DetectionResult detect(const FrameContext& ctx) override;
+  std::vector<FrameContext::Request> frameProducts() const override {
+    return {{FrameContext::Product::Gray, 0}};
+  }
+
+  // 骨架上单个连通域的统计
+  struct SkeletonStats {
+    int pixels = 0;
+    int branchPoints = 0;   // 细化：8 邻域交叉数 >= 3；形态学（旧版）：8 邻域骨架点数 >= 3
+    int endPoints = 0;      // 细化：8 邻域交叉数 == 1；形态学（旧版）不统计
+    double length = 0.0;    // 按对角/正交连接估计的长度（像素）
+  };
+
+  // 骨架化内核（无状态，供回归测试直接调用）
+  // 默认（skeletonMethod = thinning）：Zhang-Suen 查表细化（按行并行，只重算变化过的邻域），
+  // 每个子迭代检查取消令牌，取消时返回空 Mat
+  static cv::Mat skeletonize(const cv::Mat& binary, const CancellationToken& cancel);
+  // 单次遍历统计各连通域（labels 为 8 连通 CV_32S 标记）的长度、分支点与端点，下标即标签
+  static std::vector<SkeletonStats> measureSkeletons(const cv::Mat& skeleton, const cv::Mat& labels, int numLabels);
+
+  // 旧版（skeletonMethod = morphological）：形态学骨架（反复腐蚀/开运算求差），
+  // 统计按各连通域外接矩形逐点扫描（矩形内其他连通域的像素一并计入，边框一圈不计）。
+  // 与细化结果不逐像素一致：骨架更碎、分支点按邻居数计，保留用于对照与回退
+  static cv::Mat skeletonizeMorphological(const cv::Mat& binary, const CancellationToken& cancel);
+  static std::vector<SkeletonStats> measureSkeletonsByBox(const cv::Mat& skeleton, const cv::Mat& componentStats,
+                                                          int numLabels);
+
+protected:
+  void compileParameters(const QVariantMap& params) override;
 
 private:
-  // 参数
-  int m_threshold = 80;          // 检测阈值 [0-100]
-  int m_minArea = 20;            // 最小面积（像素²）
-  int m_morphKernelSize = 3;     // 形态学核大小
-  int m_binaryThreshold = 128;   // 二值化阈值
-  bool m_useGabor = true;        // 是否使用 Gabor 滤波
+  // 类型化参数（编译自参数表，detect() 每帧读取一次快照）
+  struct Params {
+    int threshold = 80;          // 检测阈值 [0-100]
+    int minArea = 20;            // 最小面积（像素²）
+    int morphKernelSize = 3;     // 形态学核大小
+    int binaryThreshold = 128;   // 二值化阈值
+    bool useGabor = true;        // 是否使用 Gabor 滤波
+    int gaborOrientations = 4;   // Gabor 方向数
+    GaborFilterBank::Method gaborMethod = GaborFilterBank::Method::Auto;
+    bool morphologicalSkeleton = false;  // 使用旧版形态学骨架与逐框统计
+    std::shared_ptr<const GaborFilterBank> gaborBank;  // 方向数不变时跨参数版本复用
+  };
+  ParamSnapshot<Params> m_paramSnapshot;
 
   // 内部方法
-  void updateParameters();
-  cv::Mat preprocessImage(const cv::Mat& input);
-  cv::Mat applyGaborFilter(const cv::Mat& gray);
-  cv::Mat skeletonize(const cv::Mat& binary);
-  std::vector<DefectInfo> findCracks(const cv::Mat& binary, const cv::Mat& original);
-  std::vector<DefectInfo> analyzeSkeleton(const cv::Mat& skeleton, const cv::Mat& binary, const cv::Mat& original);
-  int countBranchPoints(const cv::Mat& skeleton, const cv::Rect& roi);
-  double measureSkeletonLength(const cv::Mat& skeleton, const cv::Rect& roi);
+  cv::Mat preprocessImage(const FrameContext& ctx, const Params& params);
+  cv::Mat applyGaborFilter(const cv::Mat& gray, const Params& params);
+  std::vector<DefectInfo> findCracks(const cv::Mat& binary, const cv::Mat& original, const Params& params);
+  std::vector<DefectInfo> analyzeSkeleton(const cv::Mat& skeleton, const cv::Mat& binary, const cv::Mat& original,
+                                          const Params& params);
   bool isValidCrack(const std::vector<cv::Point>& contour);
   double calculateSeverity(double area, double length, int branchCount);
 };
@@ -26,7 +26,6 @@ DimensionDetector::DimensionDetector() {
 }
 
 bool DimensionDetector::initialize() {
-  updateParameters();
   m_initialized = true;
   return true;
 }
@@ -35,31 +34,26 @@ void DimensionDetector::release() {
   m_initialized = false;
 }
 
-void DimensionDetector::updateParameters() {
-  m_tolerance = getParam<double>("tolerance", 0.5);
-  m_calibration = getParam<double>("calibration", 0.1);
-  m_targetWidth = getParam<double>("targetWidth", 100.0);
-  m_targetHeight = getParam<double>("targetHeight", 100.0);
-  m_useSubpixel = getParam<bool>("useSubpixel", true);
-  m_ransacIterations = getParam<int>("ransacIterations", 100);
+void DimensionDetector::compileParameters(const QVariantMap& params) {
+  Params compiled;
+  compiled.tolerance = paramValue<double>(params, "tolerance", 0.5);
+  compiled.calibration = paramValue<double>(params, "calibration", 0.1);
+  compiled.targetWidth = paramValue<double>(params, "targetWidth", 100.0);
+  compiled.targetHeight = paramValue<double>(params, "targetHeight", 100.0);
+  compiled.useSubpixel = paramValue<bool>(params, "useSubpixel", true);
+  compiled.ransacIterations = paramValue<int>(params, "ransacIterations", 100);
+  m_paramSnapshot.publish(compiled);
 }
 
-double DimensionDetector::pixelToMm(double pixels) const {
-  return pixels * m_calibration;
+double DimensionDetector::pixelToMm(double pixels, const Params& params) {
+  return pixels * params.calibration;
 }
 
-cv::Mat DimensionDetector::preprocessImage(const cv::Mat& input) {
-  cv::Mat gray, blurred, binary;
+cv::Mat DimensionDetector::preprocessImage(const FrameContext& ctx) {
+  cv::Mat binary;
 
-  // 转灰度
-  if (input.channels() == 3) {
-    cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
-  } else {
-    gray = input.clone();
-  }
-
-  // 高斯模糊
-  cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
+  // 灰度 + 5x5 高斯模糊（由帧上下文缓存）
+  const cv::Mat& blurred = ctx.gaussian(5);
 
   // Otsu 自动阈值二值化
   cv::threshold(blurred, binary, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
@@ -71,9 +65,11 @@ cv::Mat DimensionDetector::preprocessImage(const cv::Mat& input) {
   return binary;
 }
 
-std::vector<cv::Point2f> DimensionDetector::detectSubpixelEdges(const cv::Mat& gray, 
-                                                                  const cv::Mat& binary) {
+std::vector<cv::Point2f> DimensionDetector::detectSubpixelEdges(const FrameContext& ctx, 
+                                                                  const cv::Mat& binary,
+                                                                  const Params& params) {
   std::vector<cv::Point2f> subpixelEdges;
+  const cv::Mat& gray = ctx.gray();
   
   // Canny 边缘检测
   cv::Mat edges;
@@ -83,7 +79,7 @@ std::vector<cv::Point2f> DimensionDetector::detectSubpixelEdges(const cv::Mat& g
   std::vector<cv::Point> edgePoints;
   cv::findNonZero(edges, edgePoints);
   
-  if (!m_useSubpixel) {
+  if (!params.useSubpixel) {
     // 不使用亚像素，直接转换
     for (const auto& pt : edgePoints) {
       subpixelEdges.push_back(cv::Point2f(pt.x, pt.y));
@@ -91,10 +87,9 @@ std::vector<cv::Point2f> DimensionDetector::detectSubpixelEdges(const cv::Mat& g
     return subpixelEdges;
   }
   
-  // 亚像素精化：使用梯度插值
-  cv::Mat gradX, gradY;
-  cv::Sobel(gray, gradX, CV_64F, 1, 0, 3);
-  cv::Sobel(gray, gradY, CV_64F, 0, 1, 3);
+  // 亚像素精化：使用梯度插值（Sobel 梯度由帧上下文按需计算并缓存）
+  const cv::Mat& gradX = ctx.gradientX();
+  const cv::Mat& gradY = ctx.gradientY();
   
   for (const auto& pt : edgePoints) {
     if (pt.x < 1 || pt.x >= gray.cols - 1 || pt.y < 1 || pt.y >= gray.rows - 1) {
@@ -140,7 +135,7 @@ std::vector<cv::Point2f> DimensionDetector::detectSubpixelEdges(const cv::Mat& g
 }
 
 cv::Vec4f DimensionDetector::fitLineRANSAC(const std::vector<cv::Point2f>& points, 
-                                            double threshold) {
+                                            double threshold, int iterations) {
   if (points.size() < 2) {
     return cv::Vec4f(0, 0, 0, 0);
   }
@@ -159,7 +154,7 @@ cv::Vec4f DimensionDetector::fitLineRANSAC(const std::vector<cv::Point2f>& point
   cv::Vec4f bestLine(0, 0, 0, 0);
   int bestInliers = 0;
   
-  for (int iter = 0; iter < m_ransacIterations; ++iter) {
+  for (int iter = 0; iter < iterations; ++iter) {
     // 随机选择两个点
     int idx1 = dis(gen);
     int idx2 = dis(gen);
@@ -233,7 +228,7 @@ double DimensionDetector::measureLineDistance(const cv::Vec4f& line1, const cv::
 }
 
 DimensionDetector::MeasurementResult DimensionDetector::measureWidth(
-    const std::vector<cv::Point2f>& edges, const cv::Rect& bbox) {
+    const std::vector<cv::Point2f>& edges, const cv::Rect& bbox, const Params& params) {
   MeasurementResult result;
   result.type = "width";
   
@@ -258,21 +253,21 @@ DimensionDetector::MeasurementResult DimensionDetector::measureWidth(
   }
   
   // RANSAC 拟合左右边缘
-  cv::Vec4f leftLine = fitLineRANSAC(leftEdges, 2.0);
-  cv::Vec4f rightLine = fitLineRANSAC(rightEdges, 2.0);
+  cv::Vec4f leftLine = fitLineRANSAC(leftEdges, 2.0, params.ransacIterations);
+  cv::Vec4f rightLine = fitLineRANSAC(rightEdges, 2.0, params.ransacIterations);
   
   // 测量距离
   double distPixels = measureLineDistance(leftLine, rightLine);
-  result.value = pixelToMm(distPixels);
-  result.deviation = std::abs(result.value - m_targetWidth);
-  result.withinTolerance = result.deviation <= m_tolerance;
+  result.value = pixelToMm(distPixels, params);
+  result.deviation = std::abs(result.value - params.targetWidth);
+  result.withinTolerance = result.deviation <= params.tolerance;
   result.confidence = std::min(1.0, (leftEdges.size() + rightEdges.size()) / 100.0);
   
   return result;
 }
 
 DimensionDetector::MeasurementResult DimensionDetector::measureHeight(
-    const std::vector<cv::Point2f>& edges, const cv::Rect& bbox) {
+    const std::vector<cv::Point2f>& edges, const cv::Rect& bbox, const Params& params) {
   MeasurementResult result;
   result.type = "height";
   
@@ -297,14 +292,14 @@ DimensionDetector::MeasurementResult DimensionDetector::measureHeight(
   }
   
   // RANSAC 拟合上下边缘
-  cv::Vec4f topLine = fitLineRANSAC(topEdges, 2.0);
-  cv::Vec4f bottomLine = fitLineRANSAC(bottomEdges, 2.0);
+  cv::Vec4f topLine = fitLineRANSAC(topEdges, 2.0, params.ransacIterations);
+  cv::Vec4f bottomLine = fitLineRANSAC(bottomEdges, 2.0, params.ransacIterations);
   
   // 测量距离
   double distPixels = measureLineDistance(topLine, bottomLine);
-  result.value = pixelToMm(distPixels);
-  result.deviation = std::abs(result.value - m_targetHeight);
-  result.withinTolerance = result.deviation <= m_tolerance;
+  result.value = pixelToMm(distPixels, params);
+  result.deviation = std::abs(result.value - params.targetHeight);
+  result.withinTolerance = result.deviation <= params.tolerance;
   result.confidence = std::min(1.0, (topEdges.size() + bottomEdges.size()) / 100.0);
   
   return result;
@@ -356,31 +351,47 @@ DimensionDetector::MeasurementResult DimensionDetector::measureParallelism(
   return result;
 }
 
+std::vector<FrameContext::Request> DimensionDetector::frameProducts() const {
+  std::vector<FrameContext::Request> products = {{FrameContext::Product::Gaussian, 5}};
+  // 亚像素精化才需要梯度
+  if (m_paramSnapshot.read()->useSubpixel) {
+    products.push_back({FrameContext::Product::GradientX, 0});
+    products.push_back({FrameContext::Product::GradientY, 0});
+  }
+  return products;
+}
+
 DetectionResult DimensionDetector::detect(const cv::Mat& image) {
+  FrameContext ctx(image);
+  return detect(ctx);
+}
+
+DetectionResult DimensionDetector::detect(const FrameContext& ctx) {
   QElapsedTimer timer;
   timer.start();
 
+  const cv::Mat& image = ctx.image();
   if (image.empty()) {
     LOG_ERROR("DimensionDetector::detect - Input image is empty");
     return makeErrorResult("Empty input image");
   }
 
-  updateParameters();
+  // 本帧参数快照（参数修改从下一帧生效）
+  const auto params = m_paramSnapshot.read();
   
   LOG_DEBUG("DimensionDetector::detect - Input: {}x{}, target: {:.2f}x{:.2f}mm, tolerance: {:.2f}mm, calibration: {:.4f}mm/px, subpixel: {}",
-            image.cols, image.rows, m_targetWidth, m_targetHeight, m_tolerance, m_calibration, m_useSubpixel);
+            image.cols, image.rows, params->targetWidth, params->targetHeight, params->tolerance,
+            params->calibration, params->useSubpixel);
 
   // 预处理
-  cv::Mat binary = preprocessImage(image);
-  cv::Mat gray;
-  if (image.channels() == 3) {
-    cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
-  } else {
-    gray = image.clone();
+  cv::Mat binary = preprocessImage(ctx);
+  ctx.applyMask(binary);
+  if (ctx.isCancelled()) {
+    return makeCancelledResult(timer.elapsed());
   }
 
   // 测量尺寸
-  std::vector<DefectInfo> defects = measureDimensions(binary, gray);
+  std::vector<DefectInfo> defects = measureDimensions(binary, ctx, *params);
 
   double timeMs = timer.elapsed();
   
@@ -390,19 +401,20 @@ DetectionResult DimensionDetector::detect(const cv::Mat& image) {
   } else {
     for (const auto& d : defects) {
       LOG_WARN("DimensionDetector::detect - NG {}: actual={:.3f}mm, deviation={:.3f}mm (tolerance={:.2f}mm), severity={:.2f}",
-               d.attributes.value("measureType").toString().toStdString(),
-               d.attributes.value("actualValue").toDouble(),
-               d.attributes.value("deviation").toDouble(),
-               m_tolerance, d.severity);
+               DefectFeatures::measureTypeName(d.features.measureType),
+               d.features.get(DefectFeatures::ActualValue),
+               d.features.get(DefectFeatures::Deviation),
+               params->tolerance, d.severity);
     }
     LOG_INFO("DimensionDetector::detect - Result: {} dimension errors, time:{:.1f}ms", defects.size(), timeMs);
   }
   
-  return makeSuccessResult(defects, timeMs);
+  return makeSuccessResult(std::move(defects), timeMs);
 }
 
 std::vector<DefectInfo> DimensionDetector::measureDimensions(const cv::Mat& binary, 
-                                                               const cv::Mat& gray) {
+                                                               const FrameContext& ctx,
+                                                               const Params& params) {
   std::vector<DefectInfo> defects;
 
   // 查找轮廓
@@ -428,12 +440,12 @@ std::vector<DefectInfo> DimensionDetector::measureDimensions(const cv::Mat& bina
   cv::Rect bbox = cv::boundingRect(mainContour);
   
   // 检测亚像素边缘
-  std::vector<cv::Point2f> subpixelEdges = detectSubpixelEdges(gray, binary);
+  std::vector<cv::Point2f> subpixelEdges = detectSubpixelEdges(ctx, binary, params);
   
   LOG_DEBUG("DimensionDetector - Found {} subpixel edge points", subpixelEdges.size());
 
   // 1. 测量宽度
-  MeasurementResult widthResult = measureWidth(subpixelEdges, bbox);
+  MeasurementResult widthResult = measureWidth(subpixelEdges, bbox, params);
   if (widthResult.confidence > 0.3 && !widthResult.withinTolerance) {
     DefectInfo defect;
     defect.bbox = bbox;
@@ -442,24 +454,24 @@ std::vector<DefectInfo> DimensionDetector::measureDimensions(const cv::Mat& bina
     defect.className = "Dimension";
     defect.description = QString("Width deviation: %1mm (target: %2mm, actual: %3mm)")
                            .arg(widthResult.deviation, 0, 'f', 3)
-                           .arg(m_targetWidth, 0, 'f', 2)
+                           .arg(params.targetWidth, 0, 'f', 2)
                            .arg(widthResult.value, 0, 'f', 3);
     
     defect.confidence = widthResult.confidence;
-    defect.severity = calculateSeverity(widthResult.deviation, m_tolerance);
+    defect.severity = calculateSeverity(widthResult.deviation, params.tolerance);
     
-    defect.attributes["measureType"] = "width";
-    defect.attributes["targetValue"] = m_targetWidth;
-    defect.attributes["actualValue"] = widthResult.value;
-    defect.attributes["deviation"] = widthResult.deviation;
-    defect.attributes["tolerance"] = m_tolerance;
-    defect.attributes["subpixelPrecision"] = m_useSubpixel;
-
-    defects.push_back(defect);
+    defect.features.measureType = MeasureType::Width;
+    defect.features.subpixelPrecision = params.useSubpixel;
+    defect.features.set(DefectFeatures::TargetValue, params.targetWidth);
+    defect.features.set(DefectFeatures::ActualValue, widthResult.value);
+    defect.features.set(DefectFeatures::Deviation, widthResult.deviation);
+    defect.features.set(DefectFeatures::Tolerance, params.tolerance);
+
+    defects.push_back(std::move(defect));
   }
 
   // 2. 测量高度
-  MeasurementResult heightResult = measureHeight(subpixelEdges, bbox);
+  MeasurementResult heightResult = measureHeight(subpixelEdges, bbox, params);
   if (heightResult.confidence > 0.3 && !heightResult.withinTolerance) {
     DefectInfo defect;
     defect.bbox = bbox;
@@ -468,20 +480,20 @@ std::vector<DefectInfo> DimensionDetector::measureDimensions(const cv::Mat& bina
     defect.className = "Dimension";
     defect.description = QString("Height deviation: %1mm (target: %2mm, actual: %3mm)")
                            .arg(heightResult.deviation, 0, 'f', 3)
-                           .arg(m_targetHeight, 0, 'f', 2)
+                           .arg(params.targetHeight, 0, 'f', 2)
                            .arg(heightResult.value, 0, 'f', 3);
     
     defect.confidence = heightResult.confidence;
-    defect.severity = calculateSeverity(heightResult.deviation, m_tolerance);
+    defect.severity = calculateSeverity(heightResult.deviation, params.tolerance);
     
-    defect.attributes["measureType"] = "height";
-    defect.attributes["targetValue"] = m_targetHeight;
-    defect.attributes["actualValue"] = heightResult.value;
-    defect.attributes["deviation"] = heightResult.deviation;
-    defect.attributes["tolerance"] = m_tolerance;
-    defect.attributes["subpixelPrecision"] = m_useSubpixel;
-
-    defects.push_back(defect);
+    defect.features.measureType = MeasureType::Height;
+    defect.features.subpixelPrecision = params.useSubpixel;
+    defect.features.set(DefectFeatures::TargetValue, params.targetHeight);
+    defect.features.set(DefectFeatures::ActualValue, heightResult.value);
+    defect.features.set(DefectFeatures::Deviation, heightResult.deviation);
+    defect.features.set(DefectFeatures::Tolerance, params.tolerance);
+
+    defects.push_back(std::move(defect));
   }
 
   // 3. 测量圆度（可选）
@@ -489,7 +501,7 @@ std::vector<DefectInfo> DimensionDetector::measureDimensions(const cv::Mat& bina
   if (circularityResult.confidence > 0.5) {
     // 存储圆度信息到属性（即使在公差内也记录）
     if (!defects.empty()) {
-      defects.back().attributes["circularity"] = circularityResult.value;
+      defects.back().features.set(DefectFeatures::Circularity, circularityResult.value);
     }
     
     // 如果圆度偏差太大，作为缺陷报告
@@ -506,12 +518,12 @@ std::vector<DefectInfo> DimensionDetector::measureDimensions(const cv::Mat& bina
       defect.confidence = circularityResult.confidence;
       defect.severity = std::min(1.0, circularityResult.deviation * 2);
       
-      defect.attributes["measureType"] = "circularity";
-      defect.attributes["targetValue"] = 1.0;
-      defect.attributes["actualValue"] = circularityResult.value;
-      defect.attributes["deviation"] = circularityResult.deviation;
+      defect.features.measureType = MeasureType::Circularity;
+      defect.features.set(DefectFeatures::TargetValue, 1.0);
+      defect.features.set(DefectFeatures::ActualValue, circularityResult.value);
+      defect.features.set(DefectFeatures::Deviation, circularityResult.deviation);
 
-      defects.push_back(defect);
+      defects.push_back(std::move(defect));
     }
   }
 
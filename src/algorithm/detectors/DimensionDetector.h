@@ -32,6 +32,10 @@ public:
   bool initialize() override;
   void release() override;
   DetectionResult detect(const cv::Mat& image) override;
+  DetectionResult detect(const FrameContext& ctx) override;
+  std::vector<FrameContext::Request> frameProducts() const override;
+  // 测量整件外轮廓，分块后每块的最大轮廓不是工件本身
+  bool supportsTiling() const override { return false; }
 
   // 测量结果结构
   struct MeasurementResult {
@@ -42,27 +46,32 @@ public:
     QString type;                 // 测量类型
   };
 
+protected:
+  void compileParameters(const QVariantMap& params) override;
+
 private:
-  // 参数
-  double m_tolerance = 0.5;       // 公差（mm）
-  double m_calibration = 0.1;     // 标定系数（mm/pixel）
-  double m_targetWidth = 100.0;   // 目标宽度（mm）
-  double m_targetHeight = 100.0;  // 目标高度（mm）
-  bool m_useSubpixel = true;      // 是否使用亚像素精度
-  int m_ransacIterations = 100;   // RANSAC 迭代次数
+  // 类型化参数（编译自参数表，detect() 每帧读取一次快照）
+  struct Params {
+    double tolerance = 0.5;       // 公差（mm）
+    double calibration = 0.1;     // 标定系数（mm/pixel）
+    double targetWidth = 100.0;   // 目标宽度（mm）
+    double targetHeight = 100.0;  // 目标高度（mm）
+    bool useSubpixel = true;      // 是否使用亚像素精度
+    int ransacIterations = 100;   // RANSAC 迭代次数
+  };
+  ParamSnapshot<Params> m_paramSnapshot;
 
   // 内部方法
-  void updateParameters();
-  cv::Mat preprocessImage(const cv::Mat& input);
-  std::vector<cv::Point2f> detectSubpixelEdges(const cv::Mat& gray, const cv::Mat& binary);
-  cv::Vec4f fitLineRANSAC(const std::vector<cv::Point2f>& points, double threshold);
+  cv::Mat preprocessImage(const FrameContext& ctx);
+  std::vector<cv::Point2f> detectSubpixelEdges(const FrameContext& ctx, const cv::Mat& binary, const Params& params);
+  cv::Vec4f fitLineRANSAC(const std::vector<cv::Point2f>& points, double threshold, int iterations);
   double measureLineDistance(const cv::Vec4f& line1, const cv::Vec4f& line2);
-  MeasurementResult measureWidth(const std::vector<cv::Point2f>& edges, const cv::Rect& bbox);
-  MeasurementResult measureHeight(const std::vector<cv::Point2f>& edges, const cv::Rect& bbox);
+  MeasurementResult measureWidth(const std::vector<cv::Point2f>& edges, const cv::Rect& bbox, const Params& params);
+  MeasurementResult measureHeight(const std::vector<cv::Point2f>& edges, const cv::Rect& bbox, const Params& params);
   MeasurementResult measureCircularity(const std::vector<cv::Point>& contour);
   MeasurementResult measureParallelism(const cv::Vec4f& line1, const cv::Vec4f& line2);
-  std::vector<DefectInfo> measureDimensions(const cv::Mat& binary, const cv::Mat& original);
-  double pixelToMm(double pixels) const;
+  std::vector<DefectInfo> measureDimensions(const cv::Mat& binary, const FrameContext& ctx, const Params& params);
+  static double pixelToMm(double pixels, const Params& params);
   double calculateSeverity(double deviation, double tolerance);
 };
 
@@ -18,15 +18,18 @@
 #include "ForeignDetector.h"
 #include "../postprocess/NMSFilter.h"
 #include "../common/Logger.h"
+#include "../common/ParallelFor.h"
 #include <QElapsedTimer>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
 #include <cmath>
+#include <iterator>
 
 ForeignDetector::ForeignDetector() {
   m_confidenceThreshold = 0.5;
 }
 
 bool ForeignDetector::initialize() {
-  updateParameters();
   m_initialized = true;
   return true;
 }
@@ -35,46 +38,44 @@ void ForeignDetector::release() {
   m_initialized = false;
 }
 
-void ForeignDetector::updateParameters() {
-  m_minArea = getParam<int>("minArea", 5);
-  m_contrast = getParam<double>("contrast", 0.3);
-  m_colorThreshold = getParam<int>("colorThreshold", 50);
+void ForeignDetector::compileParameters(const QVariantMap& params) {
+  Params compiled;
+  compiled.minArea = paramValue<int>(params, "minArea", 5);
+  compiled.contrast = paramValue<double>(params, "contrast", 0.3);
+  compiled.colorThreshold = paramValue<int>(params, "colorThreshold", 50);
+  m_paramSnapshot.publish(compiled);
 }
 
-cv::Mat ForeignDetector::preprocessImage(const cv::Mat& input) {
-  cv::Mat gray, blurred;
-
-  // 转灰度
-  if (input.channels() == 3) {
-    cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
-  } else {
-    gray = input.clone();
-  }
-
-  // 中值滤波（去除椒盐噪声，保留边缘）
-  cv::medianBlur(gray, blurred, 5);
-
-  return blurred;
+const cv::Mat& ForeignDetector::preprocessImage(const FrameContext& ctx) {
+  // 灰度 + 中值滤波（去除椒盐噪声，保留边缘）
+  return ctx.median(5);
 }
 
 DetectionResult ForeignDetector::detect(const cv::Mat& image) {
+  FrameContext ctx(image);
+  return detect(ctx);
+}
+
+DetectionResult ForeignDetector::detect(const FrameContext& ctx) {
   QElapsedTimer timer;
   timer.start();
 
+  const cv::Mat& image = ctx.image();
   if (image.empty()) {
     LOG_ERROR("ForeignDetector::detect - Input image is empty");
     return makeErrorResult("Empty input image");
   }
 
-  updateParameters();
+  // 本帧参数快照（参数修改从下一帧生效）
+  const auto params = m_paramSnapshot.read();
   
   LOG_DEBUG("ForeignDetector::detect - Input: {}x{}, channels={}, params: minArea={}, contrast={:.2f}",
-            image.cols, image.rows, image.channels(), m_minArea, m_contrast);
+            image.cols, image.rows, image.channels(), params->minArea, params->contrast);
 
   std::vector<DefectInfo> allDefects;
 
   // 1. 灰度异物检测（Top-hat/Black-hat）
-  cv::Mat preprocessed = preprocessImage(image);
+  const cv::Mat& preprocessed = preprocessImage(ctx);
   cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(15, 15));
   
   cv::Mat tophat, blackhat;
@@ -84,40 +85,51 @@ DetectionResult ForeignDetector::detect(const cv::Mat& image) {
   cv::Mat combined;
   cv::add(tophat, blackhat, combined);
 
-  int threshold = static_cast<int>(255 * m_contrast);
+  int threshold = static_cast<int>(255 * params->contrast);
   cv::Mat binary;
   cv::threshold(combined, binary, threshold, 255, cv::THRESH_BINARY);
 
   cv::Mat smallKernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3));
   cv::morphologyEx(binary, binary, cv::MORPH_OPEN, smallKernel);
+  ctx.applyMask(binary);
 
-  auto grayDefects = findForeignObjects(binary, image);
+  auto grayDefects = findForeignObjects(binary, ctx.gray(), ctx.mask(), *params);
   size_t grayCount = grayDefects.size();
-  allDefects.insert(allDefects.end(), grayDefects.begin(), grayDefects.end());
+  allDefects.insert(allDefects.end(), std::make_move_iterator(grayDefects.begin()),
+                    std::make_move_iterator(grayDefects.end()));
+
+  if (ctx.isCancelled()) {
+    return makeCancelledResult(timer.elapsed());
+  }
 
   // 2. 颜色异物检测（仅对彩色图像）
   size_t colorCount = 0;
   if (image.channels() == 3) {
-    auto colorDefects = detectColorAnomalies(image);
+    auto colorDefects = detectColorAnomalies(ctx.lab(), ctx.mask(), *params);
     colorCount = colorDefects.size();
-    allDefects.insert(allDefects.end(), colorDefects.begin(), colorDefects.end());
+    allDefects.insert(allDefects.end(), std::make_move_iterator(colorDefects.begin()),
+                      std::make_move_iterator(colorDefects.end()));
   }
 
   // 3. LBP 纹理异物检测
-  auto textureDefects = detectTextureAnomalies(preprocessed);
+  auto textureDefects = detectTextureAnomalies(preprocessed, ctx.mask(), *params, ctx.cancellationToken());
+  if (ctx.isCancelled()) {
+    return makeCancelledResult(timer.elapsed());
+  }
   size_t textureCount = textureDefects.size();
-  allDefects.insert(allDefects.end(), textureDefects.begin(), textureDefects.end());
+  allDefects.insert(allDefects.end(), std::make_move_iterator(textureDefects.begin()),
+                    std::make_move_iterator(textureDefects.end()));
 
   // 使用统一的 NMSFilter 去重
   size_t beforeNMS = allDefects.size();
   NMSFilter nmsFilter;
   nmsFilter.setIoUThreshold(0.5);
   nmsFilter.setConfidenceThreshold(0.0);
-  allDefects = nmsFilter.filter(allDefects);
+  allDefects = nmsFilter.filter(std::move(allDefects));
 
   // 过滤低置信度
   size_t beforeFilter = allDefects.size();
-  allDefects = filterByConfidence(allDefects);
+  allDefects = filterByConfidence(std::move(allDefects));
 
   double timeMs = timer.elapsed();
   
@@ -125,65 +137,69 @@ DetectionResult ForeignDetector::detect(const cv::Mat& image) {
   double maxContrast = 0;
   double totalArea = 0;
   for (const auto& d : allDefects) {
-    if (d.attributes.contains("contrast")) maxContrast = std::max(maxContrast, d.attributes.value("contrast").toDouble());
-    if (d.attributes.contains("area")) totalArea += d.attributes.value("area").toDouble();
+    maxContrast = std::max(maxContrast, d.features.get(DefectFeatures::Contrast));
+    totalArea += d.features.get(DefectFeatures::Area);
   }
   
   LOG_INFO("ForeignDetector::detect - Result: {} foreign (gray:{}, color:{}, texture:{}), NMS:{}->{}, filter:{}->{}, totalArea={:.0f}px, maxContrast={:.2f}, time:{:.1f}ms",
            allDefects.size(), grayCount, colorCount, textureCount, beforeNMS, beforeFilter, beforeFilter, allDefects.size(),
            totalArea, maxContrast, timeMs);
   
-  return makeSuccessResult(allDefects, timeMs);
+  return makeSuccessResult(std::move(allDefects), timeMs);
 }
 
-std::vector<DefectInfo> ForeignDetector::detectTextureAnomalies(const cv::Mat& gray) {
+std::vector<DefectInfo> ForeignDetector::detectTextureAnomalies(const cv::Mat& gray, const cv::Mat& mask,
+                                                                const Params& params,
+                                                                const CancellationToken& cancel) {
   std::vector<DefectInfo> defects;
   
   // 计算 LBP (Local Binary Pattern) 纹理特征
-  int radius = 1;
-  int neighbors = 8;
-  
-  cv::Mat lbp = cv::Mat::zeros(gray.size(), CV_8UC1);
-  
-  for (int y = radius; y < gray.rows - radius; ++y) {
-    for (int x = radius; x < gray.cols - radius; ++x) {
-      uchar center = gray.at<uchar>(y, x);
-      uchar code = 0;
-      
-      // 8 邻域 LBP
-      code |= (gray.at<uchar>(y-1, x-1) >= center) << 7;
-      code |= (gray.at<uchar>(y-1, x) >= center) << 6;
-      code |= (gray.at<uchar>(y-1, x+1) >= center) << 5;
-      code |= (gray.at<uchar>(y, x+1) >= center) << 4;
-      code |= (gray.at<uchar>(y+1, x+1) >= center) << 3;
-      code |= (gray.at<uchar>(y+1, x) >= center) << 2;
-      code |= (gray.at<uchar>(y+1, x-1) >= center) << 1;
-      code |= (gray.at<uchar>(y, x-1) >= center) << 0;
-      
-      lbp.at<uchar>(y, x) = code;
-    }
+  const cv::Mat lbp = computeLBP(gray, cancel);
+  if (lbp.empty()) {
+    return defects;
   }
   
   // 计算局部 LBP 直方图并检测异常
-  int blockSize = 32;
-  cv::Mat lbpMean, lbpStd;
+  const int blockSize = 32;
+  const double blockArea = static_cast<double>(blockSize) * blockSize;
   
   // 计算全局 LBP 直方图统计
   cv::Scalar globalMean, globalStd;
-  cv::meanStdDev(lbp, globalMean, globalStd);
+  cv::meanStdDev(lbp, globalMean, globalStd, mask);
+  
+  // 块以半块步长排布：先一次遍历求出每个 cell（半块边长）的和与平方和，
+  // 每个块取 2×2 个 cell 相加，O(1) 得到均值/标准差
+  const int cellSize = blockSize / 2;
+  cv::Mat cellSum, cellSqSum;
+  computeCellSums(lbp, cellSize, cellSum, cellSqSum);
   
   // 滑动窗口检测局部纹理异常
   for (int y = 0; y < gray.rows - blockSize; y += blockSize / 2) {
+    if (cancel.isCancelled()) {
+      return defects;
+    }
+    const int cy = y / cellSize;
+    const int* sumTop = cellSum.ptr<int>(cy);
+    const int* sumBottom = cellSum.ptr<int>(cy + 1);
+    const int* sqTop = cellSqSum.ptr<int>(cy);
+    const int* sqBottom = cellSqSum.ptr<int>(cy + 1);
     for (int x = 0; x < gray.cols - blockSize; x += blockSize / 2) {
       cv::Rect roi(x, y, blockSize, blockSize);
-      cv::Mat block = lbp(roi);
+      // 跳过中心位于检测区域外的块
+      if (!mask.empty() && mask.at<uchar>(y + blockSize / 2, x + blockSize / 2) == 0) {
+        continue;
+      }
+      const int cx = x / cellSize;
+      const double sum = static_cast<double>(sumTop[cx]) + sumTop[cx + 1] + sumBottom[cx] + sumBottom[cx + 1];
+      const double sqSum = static_cast<double>(sqTop[cx]) + sqTop[cx + 1] + sqBottom[cx] + sqBottom[cx + 1];
       
-      cv::Scalar localMean, localStd;
-      cv::meanStdDev(block, localMean, localStd);
+      // 与 cv::meanStdDev 一致：总体标准差
+      const double localMean = sum / blockArea;
+      const double localStd = std::sqrt(std::max(0.0, sqSum / blockArea - localMean * localMean));
       
       // 检查纹理偏差
-      double meanDiff = std::abs(localMean[0] - globalMean[0]);
-      double stdDiff = std::abs(localStd[0] - globalStd[0]);
+      double meanDiff = std::abs(localMean - globalMean[0]);
+      double stdDiff = std::abs(localStd - globalStd[0]);
       
       // 纹理异常判断
       double anomalyScore = meanDiff / (globalStd[0] + 1.0) + stdDiff / (globalStd[0] + 1.0);
@@ -199,7 +215,7 @@ std::vector<DefectInfo> ForeignDetector::detectTextureAnomalies(const cv::Mat& g
         
         for (const auto& contour : contours) {
           double area = cv::contourArea(contour);
-          if (area < m_minArea || area > blockSize * blockSize * 0.8) continue;
+          if (area < params.minArea || area > blockSize * blockSize * 0.8) continue;
           
           DefectInfo defect;
           cv::Rect bbox = cv::boundingRect(contour);
@@ -216,14 +232,14 @@ std::vector<DefectInfo> ForeignDetector::detectTextureAnomalies(const cv::Mat& g
           defect.className = "Foreign";
           defect.confidence = std::min(1.0, anomalyScore / 5.0);
           defect.severity = std::min(1.0, area / 200.0);
-          defect.attributes["area"] = area;
-          defect.attributes["method"] = "LBP";
-          defect.attributes["textureAnomaly"] = anomalyScore;
+          defect.features.method = DetectionMethod::LBP;
+          defect.features.set(DefectFeatures::Area, area);
+          defect.features.set(DefectFeatures::TextureAnomaly, anomalyScore);
           
           // 分析形状特征
           analyzeShapeFeatures(defect, defect.contour);
           
-          defects.push_back(defect);
+          defects.push_back(std::move(defect));
         }
       }
     }
@@ -232,6 +248,105 @@ std::vector<DefectInfo> ForeignDetector::detectTextureAnomalies(const cv::Mat& g
   return defects;
 }
 
+cv::Mat ForeignDetector::computeLBP(const cv::Mat& gray, const CancellationToken& cancel) {
+  CV_Assert(gray.type() == CV_8UC1);
+  
+  // 边界一圈保持 0，与逐像素实现一致
+  cv::Mat lbp = cv::Mat::zeros(gray.size(), CV_8UC1);
+  if (gray.rows < 3 || gray.cols < 3) {
+    return lbp;
+  }
+  
+  const int cols = gray.cols;
+  
+  // 按行分条并行；每条开始前检查取消令牌
+  parallelFor(1, gray.rows - 1, [&](int first, int last) {
+    if (cancel.isCancelled()) {
+      return;
+    }
+    for (int y = first; y < last; ++y) {
+      const uchar* up = gray.ptr<uchar>(y - 1);
+      const uchar* mid = gray.ptr<uchar>(y);
+      const uchar* down = gray.ptr<uchar>(y + 1);
+      uchar* dst = lbp.ptr<uchar>(y);
+      
+      int x = 1;
+#if CV_SIMD
+      // 每个通道一个像素：8 个邻域各比较一次（>= 得到 0xFF 掩码），与对应位相与后合并
+      const int lanes = cv::v_uint8::nlanes;
+      const cv::v_uint8 bit7 = cv::vx_setall_u8(1 << 7), bit6 = cv::vx_setall_u8(1 << 6);
+      const cv::v_uint8 bit5 = cv::vx_setall_u8(1 << 5), bit4 = cv::vx_setall_u8(1 << 4);
+      const cv::v_uint8 bit3 = cv::vx_setall_u8(1 << 3), bit2 = cv::vx_setall_u8(1 << 2);
+      const cv::v_uint8 bit1 = cv::vx_setall_u8(1 << 1), bit0 = cv::vx_setall_u8(1);
+      for (; x <= cols - 1 - lanes; x += lanes) {
+        const cv::v_uint8 center = cv::vx_load(mid + x);
+        cv::v_uint8 code = (cv::vx_load(up + x - 1) >= center) & bit7;
+        code = code | ((cv::vx_load(up + x) >= center) & bit6);
+        code = code | ((cv::vx_load(up + x + 1) >= center) & bit5);
+        code = code | ((cv::vx_load(mid + x + 1) >= center) & bit4);
+        code = code | ((cv::vx_load(down + x + 1) >= center) & bit3);
+        code = code | ((cv::vx_load(down + x) >= center) & bit2);
+        code = code | ((cv::vx_load(down + x - 1) >= center) & bit1);
+        code = code | ((cv::vx_load(mid + x - 1) >= center) & bit0);
+        cv::v_store(dst + x, code);
+      }
+#endif
+      // 标量收尾（及无 SIMD 时的整行）
+      for (; x < cols - 1; ++x) {
+        const uchar center = mid[x];
+        uchar code = 0;
+        code |= (up[x - 1] >= center) << 7;
+        code |= (up[x] >= center) << 6;
+        code |= (up[x + 1] >= center) << 5;
+        code |= (mid[x + 1] >= center) << 4;
+        code |= (down[x + 1] >= center) << 3;
+        code |= (down[x] >= center) << 2;
+        code |= (down[x - 1] >= center) << 1;
+        code |= (mid[x - 1] >= center) << 0;
+        dst[x] = code;
+      }
+    }
+  });
+  
+  if (cancel.isCancelled()) {
+    return cv::Mat();
+  }
+  return lbp;
+}
+
+void ForeignDetector::computeCellSums(const cv::Mat& lbp, int cellSize, cv::Mat& cellSum, cv::Mat& cellSqSum) {
+  // 单个 cell 平方和上限 cellSize² × 255²，cellSize ≤ 32 时 int32 不溢出
+  CV_Assert(lbp.type() == CV_8UC1 && cellSize > 0 && cellSize <= 32);
+  
+  const int cellRows = lbp.rows / cellSize;
+  const int cellCols = lbp.cols / cellSize;
+  cellSum.create(cellRows, cellCols, CV_32SC1);
+  cellSqSum.create(cellRows, cellCols, CV_32SC1);
+  
+  parallelFor(0, cellRows, [&](int first, int last) {
+    for (int cy = first; cy < last; ++cy) {
+      int* sumRow = cellSum.ptr<int>(cy);
+      int* sqRow = cellSqSum.ptr<int>(cy);
+      std::fill(sumRow, sumRow + cellCols, 0);
+      std::fill(sqRow, sqRow + cellCols, 0);
+      for (int y = cy * cellSize; y < (cy + 1) * cellSize; ++y) {
+        const uchar* src = lbp.ptr<uchar>(y);
+        for (int cx = 0; cx < cellCols; ++cx) {
+          const uchar* p = src + cx * cellSize;
+          int sum = 0;
+          int sqSum = 0;
+          for (int i = 0; i < cellSize; ++i) {
+            sum += p[i];
+            sqSum += p[i] * p[i];
+          }
+          sumRow[cx] += sum;
+          sqRow[cx] += sqSum;
+        }
+      }
+    }
+  });
+}
+
 void ForeignDetector::analyzeShapeFeatures(DefectInfo& defect, const std::vector<cv::Point>& contour) {
   if (contour.size() < 5) return;
   
@@ -262,11 +377,11 @@ void ForeignDetector::analyzeShapeFeatures(DefectInfo& defect, const std::vector
       std::min(rotRect.size.width, rotRect.size.height) : 1.0;
   
   // 存储形状特征
-  defect.attributes["circularity"] = circularity;
-  defect.attributes["solidity"] = solidity;
-  defect.attributes["rectangularity"] = rectangularity;
-  defect.attributes["aspectRatio"] = aspectRatio;
-  defect.attributes["perimeter"] = perimeter;
+  defect.features.set(DefectFeatures::Circularity, circularity);
+  defect.features.set(DefectFeatures::Solidity, solidity);
+  defect.features.set(DefectFeatures::Rectangularity, rectangularity);
+  defect.features.set(DefectFeatures::AspectRatio, aspectRatio);
+  defect.features.set(DefectFeatures::Perimeter, perimeter);
   
   // 根据形状特征调整置信度
   // 异物通常形状不规则（低圆形度、低矩形度）
@@ -274,20 +389,17 @@ void ForeignDetector::analyzeShapeFeatures(DefectInfo& defect, const std::vector
   defect.confidence = defect.confidence * 0.7 + shapeScore * 0.3;
 }
 
-std::vector<DefectInfo> ForeignDetector::detectColorAnomalies(const cv::Mat& image) {
+std::vector<DefectInfo> ForeignDetector::detectColorAnomalies(const cv::Mat& lab, const cv::Mat& mask,
+                                                              const Params& params) {
   std::vector<DefectInfo> defects;
   
-  // 转换到 Lab 颜色空间
-  cv::Mat lab;
-  cv::cvtColor(image, lab, cv::COLOR_BGR2Lab);
-  
   std::vector<cv::Mat> channels;
   cv::split(lab, channels);
   
   // 计算 a, b 通道的均值和标准差
   cv::Scalar meanA, stdA, meanB, stdB;
-  cv::meanStdDev(channels[1], meanA, stdA);
-  cv::meanStdDev(channels[2], meanB, stdB);
+  cv::meanStdDev(channels[1], meanA, stdA, mask);
+  cv::meanStdDev(channels[2], meanB, stdB, mask);
   
   // 检测颜色异常区域（偏离均值超过阈值）
   cv::Mat anomalyA, anomalyB;
@@ -306,6 +418,9 @@ std::vector<DefectInfo> ForeignDetector::detectColorAnomalies(const cv::Mat& ima
   cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
   cv::morphologyEx(binary, binary, cv::MORPH_OPEN, kernel);
   cv::morphologyEx(binary, binary, cv::MORPH_CLOSE, kernel);
+  if (!mask.empty()) {
+    cv::bitwise_and(binary, mask, binary);
+  }
   
   // 查找轮廓
   std::vector<std::vector<cv::Point>> contours;
@@ -313,7 +428,7 @@ std::vector<DefectInfo> ForeignDetector::detectColorAnomalies(const cv::Mat& ima
   
   for (const auto& contour : contours) {
     double area = cv::contourArea(contour);
-    if (area < m_minArea) continue;
+    if (area < params.minArea) continue;
     
     DefectInfo defect;
     defect.bbox = cv::boundingRect(contour);
@@ -322,19 +437,20 @@ std::vector<DefectInfo> ForeignDetector::detectColorAnomalies(const cv::Mat& ima
     defect.className = "Foreign";
     defect.confidence = std::min(1.0, area / 100.0);
     defect.severity = std::min(1.0, area / 200.0);
-    defect.attributes["area"] = area;
-    defect.attributes["method"] = "color";
+    defect.features.method = DetectionMethod::Color;
+    defect.features.set(DefectFeatures::Area, area);
     
     // 分析形状特征
     analyzeShapeFeatures(defect, contour);
     
-    defects.push_back(defect);
+    defects.push_back(std::move(defect));
   }
   
   return defects;
 }
 
-std::vector<DefectInfo> ForeignDetector::findForeignObjects(const cv::Mat& binary, const cv::Mat& original) {
+std::vector<DefectInfo> ForeignDetector::findForeignObjects(const cv::Mat& binary, const cv::Mat& gray,
+                                                           const cv::Mat& mask, const Params& params) {
   std::vector<DefectInfo> defects;
 
   // 查找轮廓
@@ -342,18 +458,12 @@ std::vector<DefectInfo> ForeignDetector::findForeignObjects(const cv::Mat& binar
   cv::findContours(binary, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
 
   // 计算图像平均亮度（用于对比度计算）
-  cv::Mat gray;
-  if (original.channels() == 3) {
-    cv::cvtColor(original, gray, cv::COLOR_BGR2GRAY);
-  } else {
-    gray = original;
-  }
-  double meanBrightness = cv::mean(gray)[0];
+  double meanBrightness = cv::mean(gray, mask)[0];
 
   for (const auto& contour : contours) {
     double area = cv::contourArea(contour);
     
-    if (area < m_minArea) {
+    if (area < params.minArea) {
       continue;
     }
 
@@ -389,15 +499,15 @@ std::vector<DefectInfo> ForeignDetector::findForeignObjects(const cv::Mat& binar
     defect.severity = calculateSeverity(area, contrast);
     
     // 附加属性
-    defect.attributes["area"] = area;
-    defect.attributes["contrast"] = contrast;
-    defect.attributes["meanBrightness"] = roiMean;
-    defect.attributes["method"] = "morphology";
+    defect.features.method = DetectionMethod::Morphology;
+    defect.features.set(DefectFeatures::Area, area);
+    defect.features.set(DefectFeatures::Contrast, contrast);
+    defect.features.set(DefectFeatures::MeanBrightness, roiMean);
     
     // 分析形状特征
     analyzeShapeFeatures(defect, contour);
 
-    defects.push_back(defect);
+    defects.push_back(std::move(defect));
   }
 
   return defects;
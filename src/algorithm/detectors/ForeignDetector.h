@@ -32,19 +32,38 @@ public:
   bool initialize() override;
   void release() override;
   DetectionResult detect(const cv::Mat& image) override;
+  DetectionResult detect(const FrameContext& ctx) override;
+  std::vector<FrameContext::Request> frameProducts() const override {
+    return {{FrameContext::Product::Median, 5}, {FrameContext::Product::Lab, 0}};
+  }
+
+  // 纹理分析内核（无状态，供基准程序直接调用）
+  // 8 邻域 LBP 编码（SIMD、按行并行），边界一圈为 0；取消时返回空图
+  static cv::Mat computeLBP(const cv::Mat& gray, const CancellationToken& cancel);
+  // 按 cellSize × cellSize 分格求 LBP 的和与平方和（CV_32SC1，不足一格的边缘丢弃）
+  static void computeCellSums(const cv::Mat& lbp, int cellSize, cv::Mat& cellSum, cv::Mat& cellSqSum);
+
+protected:
+  void compileParameters(const QVariantMap& params) override;
 
 private:
-  // 参数
-  int m_minArea = 5;             // 最小面积（像素²）
-  double m_contrast = 0.3;       // 对比度阈值 [0-1]
-  int m_colorThreshold = 50;     // 颜色差异阈值
+  // 类型化参数（编译自参数表，detect() 每帧读取一次快照）
+  struct Params {
+    int minArea = 5;             // 最小面积（像素²）
+    double contrast = 0.3;       // 对比度阈值 [0-1]
+    int colorThreshold = 50;     // 颜色差异阈值
+  };
+  ParamSnapshot<Params> m_paramSnapshot;
 
   // 内部方法
-  void updateParameters();
-  cv::Mat preprocessImage(const cv::Mat& input);
-  std::vector<DefectInfo> findForeignObjects(const cv::Mat& diff, const cv::Mat& original);
-  std::vector<DefectInfo> detectColorAnomalies(const cv::Mat& image);
-  std::vector<DefectInfo> detectTextureAnomalies(const cv::Mat& gray);
+  const cv::Mat& preprocessImage(const FrameContext& ctx);
+  // mask: 可选检测掩膜，为空表示整图
+  std::vector<DefectInfo> findForeignObjects(const cv::Mat& diff, const cv::Mat& gray, const cv::Mat& mask,
+                                             const Params& params);
+  std::vector<DefectInfo> detectColorAnomalies(const cv::Mat& lab, const cv::Mat& mask, const Params& params);
+  // 块统计取自 LBP 的 cell 和；逐行检查取消令牌，取消时返回已找到的部分结果
+  std::vector<DefectInfo> detectTextureAnomalies(const cv::Mat& gray, const cv::Mat& mask, const Params& params,
+                                                 const CancellationToken& cancel);
   void analyzeShapeFeatures(DefectInfo& defect, const std::vector<cv::Point>& contour);
   double calculateSeverity(double area, double contrast);
 };
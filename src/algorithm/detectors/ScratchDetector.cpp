@@ -18,133 +18,196 @@
 #include "ScratchDetector.h"
 #include "../postprocess/NMSFilter.h"
 #include "../common/Logger.h"
+#include "../common/ParallelFor.h"
 #include <QElapsedTimer>
+#include <iterator>
+
+namespace {
+
+// 灰度剖面测宽：每个缺陷最多取 MAX_PROFILE_SAMPLES 个采样点，每点沿垂直方向取
+// PROFILE_TAPS 个抽头（间距 1 像素），两端各 PROFILE_BG_TAPS 个抽头估计背景
+constexpr int MAX_PROFILE_SAMPLES = 10;
+constexpr int PROFILE_HALF_WIDTH = 10;
+constexpr int PROFILE_TAPS = 2 * PROFILE_HALF_WIDTH + 1;
+constexpr int PROFILE_BG_TAPS = 3;
+constexpr double PROFILE_DARK_RATIO = 0.8;  // 低于背景 20% 视为划痕
+
+// LSD 实例不可并发使用，参数固定，按线程缓存（避免每帧每尺度重新创建）
+cv::LineSegmentDetector& threadLineDetector() {
+  thread_local cv::Ptr<cv::LineSegmentDetector> lsd = cv::createLineSegmentDetector(
+      cv::LSD_REFINE_STD,  // 精细化模式
+      0.8,                  // scale
+      0.6,                  // sigma_scale
+      2.0,                  // quant
+      22.5,                 // ang_th
+      0,                    // log_eps
+      0.7,                  // density_th
+      1024                  // n_bins
+  );
+  return *lsd;
+}
+
+} // namespace
 
 ScratchDetector::ScratchDetector() {
   m_confidenceThreshold = 0.5;
 }
 
 bool ScratchDetector::initialize() {
-  updateParameters();
   m_initialized = true;
   return true;
 }
 
 void ScratchDetector::release() {
+  // 各尺度累计耗时与产出，供调整 pyramidLevels 参考
+  for (int level = 0; level < MAX_PYRAMID_LEVELS; ++level) {
+    const ScaleTiming timing = scaleTiming(level);
+    if (timing.calls > 0) {
+      LOG_INFO("ScratchDetector - scale 1/{}: {} frames, avg {:.2f}ms, kept {:.1f} candidates/frame",
+               1 << level, timing.calls, timing.averageMs(),
+               static_cast<double>(timing.kept) / timing.calls);
+    }
+  }
   m_initialized = false;
 }
 
-void ScratchDetector::updateParameters() {
-  m_sensitivity = getParam<int>("sensitivity", 75);
-  m_minLength = getParam<int>("minLength", 10);
-  m_maxWidth = getParam<int>("maxWidth", 5);
-  m_contrastThreshold = getParam<int>("contrastThreshold", 30);
+void ScratchDetector::compileParameters(const QVariantMap& params) {
+  Params compiled;
+  compiled.sensitivity = paramValue<int>(params, "sensitivity", 75);
+  compiled.minLength = paramValue<int>(params, "minLength", 10);
+  compiled.maxWidth = paramValue<int>(params, "maxWidth", 5);
+  compiled.contrastThreshold = paramValue<int>(params, "contrastThreshold", 30);
+  compiled.pyramidLevels = qBound(1, paramValue<int>(params, "pyramidLevels", 2), MAX_PYRAMID_LEVELS);
+  m_paramSnapshot.publish(compiled);
 }
 
-cv::Mat ScratchDetector::preprocessImage(const cv::Mat& input) {
-  cv::Mat gray, blurred;
-
-  // 转灰度
-  if (input.channels() == 3) {
-    cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
-  } else {
-    gray = input.clone();
+std::vector<FrameContext::Request> ScratchDetector::frameProducts() const {
+  // 原图尺度用高斯模糊图，缩小尺度取共享的灰度金字塔
+  std::vector<FrameContext::Request> requests = {{FrameContext::Product::Gaussian, 3}};
+  const int levels = m_paramSnapshot.read()->pyramidLevels;
+  for (int level = 1; level < levels; ++level) {
+    requests.push_back({FrameContext::Product::Pyramid, level});
   }
+  return requests;
+}
 
-  // 高斯模糊去噪
-  int kernelSize = 3;
-  cv::GaussianBlur(gray, blurred, cv::Size(kernelSize, kernelSize), 0);
+ScratchDetector::ScaleTiming ScratchDetector::scaleTiming(int level) const {
+  ScaleTiming timing;
+  if (level < 0 || level >= MAX_PYRAMID_LEVELS) {
+    return timing;
+  }
+  const ScaleSlot& slot = m_scaleTimings[level];
+  timing.calls = slot.calls.load(std::memory_order_relaxed);
+  timing.totalMs = slot.totalUs.load(std::memory_order_relaxed) / 1000.0;
+  timing.kept = slot.kept.load(std::memory_order_relaxed);
+  return timing;
+}
 
-  return blurred;
+const cv::Mat& ScratchDetector::preprocessImage(const FrameContext& ctx) {
+  // 灰度 + 3x3 高斯模糊去噪（由帧上下文缓存，其他检测器可复用）
+  return ctx.gaussian(3);
 }
 
 DetectionResult ScratchDetector::detect(const cv::Mat& image) {
+  FrameContext ctx(image);
+  return detect(ctx);
+}
+
+DetectionResult ScratchDetector::detect(const FrameContext& ctx) {
   QElapsedTimer timer;
   timer.start();
 
+  const cv::Mat& image = ctx.image();
   if (image.empty()) {
     LOG_ERROR("ScratchDetector::detect - Input image is empty");
     return makeErrorResult("Empty input image");
   }
 
-  updateParameters();
+  // 本帧参数快照（参数修改从下一帧生效）
+  const auto params = m_paramSnapshot.read();
   
   LOG_DEBUG("ScratchDetector::detect - Input: {}x{}, channels={}, params: sensitivity={}, minLength={}, maxWidth={}", 
-            image.cols, image.rows, image.channels(), m_sensitivity, m_minLength, m_maxWidth);
-
-  // 预处理
-  cv::Mat preprocessed = preprocessImage(image);
+            image.cols, image.rows, image.channels(), params->sensitivity, params->minLength, params->maxWidth);
+
+  // 多尺度检测：各金字塔层级并发执行（LSD 每帧可产生数千条线段，候选存放于帧内存池）
+  const int levels = params->pyramidLevels;
+  std::vector<ScaleOutput> outputs;
+  outputs.reserve(levels);
+  for (int level = 0; level < levels; ++level) {
+    outputs.emplace_back(ctx.arena());
+  }
+  parallelFor(0, levels, [&](int first, int last) {
+    for (int level = first; level < last; ++level) {
+      if (ctx.isCancelled()) {
+        return;
+      }
+      detectScale(ctx, level, *params, outputs[level]);
+    }
+  });
+  if (ctx.isCancelled()) {
+    return makeCancelledResult(timer.elapsed());
+  }
 
+  // 剖面分析与 NMS 不改变置信度，且 NMS 中低置信度框不会抑制高置信度框，
+  // 因此先按阈值筛选线段候选与原先 NMS 后再筛选的结果一致
+  // 合并顺序与串行版本一致（各层轮廓缺陷在前，线段在后）
+  const double confidenceThreshold = m_confidenceThreshold;
   std::vector<DefectInfo> allDefects;
   size_t lsdCount = 0, contourCount = 0;
-
-  // 多尺度检测
-  std::vector<double> scales = {1.0, 0.5};
-  for (double scale : scales) {
-    cv::Mat scaled;
-    if (scale < 1.0) {
-      cv::resize(preprocessed, scaled, cv::Size(), scale, scale, cv::INTER_AREA);
-    } else {
-      scaled = preprocessed;
+  for (int level = 0; level < levels; ++level) {
+    ScaleOutput& output = outputs[level];
+    lsdCount += output.lines.size();
+    contourCount += output.contours.size();
+
+    size_t kept = 0;
+    for (const auto& defect : output.contours) {
+      kept += defect.confidence >= confidenceThreshold;
     }
-
-    // 1. LSD 线段检测（主要方法，更精确）
-    auto lsdDefects = detectLinesLSD(scaled, image);
-    lsdCount += lsdDefects.size();
-    
-    // 2. Canny + 轮廓检测（补充方法，检测弯曲划痕）
-    int lowThreshold = std::max(10, 100 - m_sensitivity);
-    int highThreshold = lowThreshold * 3;
-    cv::Mat edges;
-    cv::Canny(scaled, edges, lowThreshold, highThreshold);
-
-    // 形态学操作：连接断开的边缘
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 1));
-    cv::dilate(edges, edges, kernel);
-    cv::erode(edges, edges, kernel);
-
-    auto contourDefects = findScratches(edges, scaled);
-    contourCount += contourDefects.size();
-
-    // 调整坐标回原始尺度
-    auto adjustCoords = [scale](std::vector<DefectInfo>& defects) {
-      if (scale < 1.0) {
-        for (auto& d : defects) {
-          d.bbox.x = static_cast<int>(d.bbox.x / scale);
-          d.bbox.y = static_cast<int>(d.bbox.y / scale);
-          d.bbox.width = static_cast<int>(d.bbox.width / scale);
-          d.bbox.height = static_cast<int>(d.bbox.height / scale);
-          // 调整轮廓点
-          for (auto& pt : d.contour) {
-            pt.x = static_cast<int>(pt.x / scale);
-            pt.y = static_cast<int>(pt.y / scale);
-          }
-        }
+    for (const auto& candidate : output.lines) {
+      kept += candidate.confidence >= confidenceThreshold;
+    }
+    allDefects.insert(allDefects.end(), std::make_move_iterator(output.contours.begin()),
+                      std::make_move_iterator(output.contours.end()));
+
+    ScaleSlot& slot = m_scaleTimings[level];
+    slot.calls.fetch_add(1, std::memory_order_relaxed);
+    slot.totalUs.fetch_add(static_cast<long long>(output.timeMs * 1000.0), std::memory_order_relaxed);
+    slot.kept.fetch_add(kept, std::memory_order_relaxed);
+    LOG_DEBUG("ScratchDetector::detect - scale 1/{}: {:.2f}ms, LSD:{}, contour:{}, kept:{}",
+              1 << level, output.timeMs, output.lines.size(), output.contours.size(), kept);
+  }
+  for (const auto& output : outputs) {
+    for (const auto& candidate : output.lines) {
+      if (candidate.confidence >= confidenceThreshold) {
+        allDefects.push_back(makeDefect(candidate));
       }
-    };
-    
-    adjustCoords(lsdDefects);
-    adjustCoords(contourDefects);
-    
-    allDefects.insert(allDefects.end(), lsdDefects.begin(), lsdDefects.end());
-    allDefects.insert(allDefects.end(), contourDefects.begin(), contourDefects.end());
+    }
   }
 
-  // 对每个缺陷进行灰度剖面分析（精确测量宽度）
-  for (auto& defect : allDefects) {
-    analyzeGrayProfile(defect, preprocessed);
+  // 剔除中心位于 ROI 外的线段
+  if (ctx.hasMask()) {
+    allDefects.erase(std::remove_if(allDefects.begin(), allDefects.end(),
+                                    [&ctx](const DefectInfo& d) { return !ctx.inMask(d.bbox); }),
+                     allDefects.end());
   }
 
+  if (ctx.isCancelled()) {
+    return makeCancelledResult(timer.elapsed());
+  }
+
+  // 对全部缺陷批量进行灰度剖面分析（精确测量宽度）
+  analyzeGrayProfiles(allDefects, preprocessImage(ctx));
+
   // 使用统一的 NMSFilter 去重
   size_t beforeNMS = allDefects.size();
   NMSFilter nmsFilter;
   nmsFilter.setIoUThreshold(0.5);
   nmsFilter.setConfidenceThreshold(0.0);  // 先不过滤置信度
-  allDefects = nmsFilter.filter(allDefects);
+  allDefects = nmsFilter.filter(std::move(allDefects));
 
   // 过滤低置信度
   size_t beforeFilter = allDefects.size();
-  allDefects = filterByConfidence(allDefects);
+  allDefects = filterByConfidence(std::move(allDefects));
 
   double timeMs = timer.elapsed();
   
@@ -162,46 +225,34 @@ DetectionResult ScratchDetector::detect(const cv::Mat& image) {
            beforeNMS, beforeFilter, beforeFilter, allDefects.size(),
            allDefects.empty() ? 0.0 : minConf, maxConf, timeMs);
   
-  return makeSuccessResult(allDefects, timeMs);
+  return makeSuccessResult(std::move(allDefects), timeMs);
 }
 
-std::vector<DefectInfo> ScratchDetector::detectLinesLSD(const cv::Mat& gray, const cv::Mat& /*original*/) {
-  std::vector<DefectInfo> defects;
-  
-  // 创建 LSD 检测器
-  cv::Ptr<cv::LineSegmentDetector> lsd = cv::createLineSegmentDetector(
-      cv::LSD_REFINE_STD,  // 精细化模式
-      0.8,                  // scale
-      0.6,                  // sigma_scale
-      2.0,                  // quant
-      22.5,                 // ang_th
-      0,                    // log_eps
-      0.7,                  // density_th
-      1024                  // n_bins
-  );
-  
-  // 检测线段
+void ScratchDetector::detectLinesLSD(const cv::Mat& gray, const Params& params,
+                                     std::pmr::vector<LineCandidate>& candidates) {
+  // 检测线段（本线程缓存的 LSD 实例）
   std::vector<cv::Vec4f> lines;
   std::vector<double> widths, precs, nfas;
-  lsd->detect(gray, lines, widths, precs, nfas);
-  
+  threadLineDetector().detect(gray, lines, widths, precs, nfas);
+  candidates.reserve(candidates.size() + lines.size());
+
   for (size_t i = 0; i < lines.size(); ++i) {
     const auto& line = lines[i];
     float x1 = line[0], y1 = line[1], x2 = line[2], y2 = line[3];
     
     double length = std::sqrt((x2-x1)*(x2-x1) + (y2-y1)*(y2-y1));
-    if (length < m_minLength) continue;
+    if (length < params.minLength) continue;
     
     // LSD 提供线宽估计
     double lineWidth = (i < widths.size()) ? widths[i] : 1.0;
-    if (lineWidth > m_maxWidth) continue;
+    if (lineWidth > params.maxWidth) continue;
     
     // 计算方向角度
     double angle = std::atan2(y2 - y1, x2 - x1) * 180.0 / CV_PI;
     if (angle < 0) angle += 180.0;
     
-    DefectInfo defect;
-    defect.bbox = cv::Rect(
+    LineCandidate candidate;
+    candidate.bbox = cv::Rect(
       static_cast<int>(std::min(x1, x2)),
       static_cast<int>(std::min(y1, y2)),
       static_cast<int>(std::abs(x2 - x1)) + 1,
@@ -209,50 +260,113 @@ std::vector<DefectInfo> ScratchDetector::detectLinesLSD(const cv::Mat& gray, con
     );
     
     // 确保 bbox 有效
-    defect.bbox.width = std::max(defect.bbox.width, 1);
-    defect.bbox.height = std::max(defect.bbox.height, 1);
+    candidate.bbox.width = std::max(candidate.bbox.width, 1);
+    candidate.bbox.height = std::max(candidate.bbox.height, 1);
     
-    // 存储线段端点作为轮廓
-    defect.contour = {
-      cv::Point(static_cast<int>(x1), static_cast<int>(y1)),
-      cv::Point(static_cast<int>(x2), static_cast<int>(y2))
-    };
-    
-    defect.classId = 0;
-    defect.className = "Scratch";
+    // 线段端点（构造缺陷时作为轮廓）
+    candidate.p1 = cv::Point(static_cast<int>(x1), static_cast<int>(y1));
+    candidate.p2 = cv::Point(static_cast<int>(x2), static_cast<int>(y2));
     
     // 置信度基于 LSD 的 NFA 和长度
     double nfa = (i < nfas.size()) ? nfas[i] : 0.0;
     double lengthScore = std::min(1.0, length / 100.0);
     double nfaScore = std::min(1.0, std::max(0.0, -nfa / 10.0));  // NFA 越小越好
-    defect.confidence = lengthScore * 0.6 + nfaScore * 0.4;
+    candidate.confidence = lengthScore * 0.6 + nfaScore * 0.4;
     
-    defect.severity = calculateSeverity(length, lineWidth);
+    candidate.severity = calculateSeverity(length, lineWidth);
     
-    defect.attributes["length"] = length;
-    defect.attributes["width"] = lineWidth;
-    defect.attributes["angle"] = angle;
-    defect.attributes["method"] = "LSD";
-    if (i < nfas.size()) defect.attributes["nfa"] = nfas[i];
+    candidate.features.method = DetectionMethod::LSD;
+    candidate.features.set(DefectFeatures::Length, length);
+    candidate.features.set(DefectFeatures::Width, lineWidth);
+    candidate.features.set(DefectFeatures::Angle, angle);
+    if (i < nfas.size()) candidate.features.set(DefectFeatures::Nfa, nfas[i]);
     
-    defects.push_back(defect);
+    candidates.push_back(candidate);
   }
-  
-  return defects;
 }
 
-std::vector<DefectInfo> ScratchDetector::detectLinesHough(const cv::Mat& edges, const cv::Mat& /*original*/) {
+void ScratchDetector::detectScale(const FrameContext& ctx, int level, const Params& params, ScaleOutput& output) {
+  QElapsedTimer timer;
+  timer.start();
+
+  // 原图尺度用 3×3 高斯模糊图；缩小尺度取帧上下文共享的金字塔（pyrDown 自带 5×5 高斯平滑）
+  const cv::Mat& scaled = level == 0 ? preprocessImage(ctx) : ctx.pyramid(level);
+  const double scale = 1.0 / (1 << level);
+
+  // 1. LSD 线段检测（主要方法，更精确）
+  detectLinesLSD(scaled, params, output.lines);
+
+  // 2. Canny + 轮廓检测（补充方法，检测弯曲划痕）
+  int lowThreshold = std::max(10, 100 - params.sensitivity);
+  int highThreshold = lowThreshold * 3;
+  cv::Mat edges;
+  cv::Canny(scaled, edges, lowThreshold, highThreshold);
+
+  // 形态学操作：连接断开的边缘
+  cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 1));
+  cv::dilate(edges, edges, kernel);
+  cv::erode(edges, edges, kernel);
+
+  // ROI 外的边缘不参与轮廓提取
+  ctx.applyMask(edges);
+
+  output.contours = findScratches(edges, scaled, params);
+
+  // 调整坐标回原始尺度
+  if (level > 0) {
+    auto adjustRect = [scale](cv::Rect& rect) {
+      rect.x = static_cast<int>(rect.x / scale);
+      rect.y = static_cast<int>(rect.y / scale);
+      rect.width = static_cast<int>(rect.width / scale);
+      rect.height = static_cast<int>(rect.height / scale);
+    };
+    auto adjustPoint = [scale](cv::Point& pt) {
+      pt.x = static_cast<int>(pt.x / scale);
+      pt.y = static_cast<int>(pt.y / scale);
+    };
+    for (auto& candidate : output.lines) {
+      adjustRect(candidate.bbox);
+      adjustPoint(candidate.p1);
+      adjustPoint(candidate.p2);
+    }
+    for (auto& d : output.contours) {
+      adjustRect(d.bbox);
+      // 调整轮廓点
+      for (auto& pt : d.contour) {
+        adjustPoint(pt);
+      }
+    }
+  }
+
+  output.timeMs = timer.nsecsElapsed() / 1e6;
+}
+
+DefectInfo ScratchDetector::makeDefect(const LineCandidate& candidate) const {
+  DefectInfo defect;
+  defect.bbox = candidate.bbox;
+  // 存储线段端点作为轮廓
+  defect.contour = {candidate.p1, candidate.p2};
+  defect.classId = 0;
+  defect.className = "Scratch";
+  defect.confidence = candidate.confidence;
+  defect.severity = candidate.severity;
+  defect.features = candidate.features;
+  return defect;
+}
+
+std::vector<DefectInfo> ScratchDetector::detectLinesHough(const cv::Mat& edges, const cv::Mat& /*original*/,
+                                                          const Params& params) {
   std::vector<DefectInfo> defects;
   
   // 概率 Hough 变换检测线段（作为备用方法）
   std::vector<cv::Vec4i> lines;
-  cv::HoughLinesP(edges, lines, 1, CV_PI / 180, 50, m_minLength, 10);
+  cv::HoughLinesP(edges, lines, 1, CV_PI / 180, 50, params.minLength, 10);
   
   for (const auto& line : lines) {
     int x1 = line[0], y1 = line[1], x2 = line[2], y2 = line[3];
     
     double length = std::sqrt((x2-x1)*(x2-x1) + (y2-y1)*(y2-y1));
-    if (length < m_minLength) continue;
+    if (length < params.minLength) continue;
     
     DefectInfo defect;
     defect.bbox = cv::Rect(
@@ -263,97 +377,147 @@ std::vector<DefectInfo> ScratchDetector::detectLinesHough(const cv::Mat& edges,
     defect.className = "Scratch";
     defect.confidence = std::min(1.0, length / 150.0);
     defect.severity = std::min(1.0, length / 200.0);
-    defect.attributes["length"] = length;
-    defect.attributes["method"] = "Hough";
+    defect.features.method = DetectionMethod::Hough;
+    defect.features.set(DefectFeatures::Length, length);
     
-    defects.push_back(defect);
+    defects.push_back(std::move(defect));
   }
   
   return defects;
 }
 
-void ScratchDetector::analyzeGrayProfile(DefectInfo& defect, const cv::Mat& gray) {
-  if (defect.contour.size() < 2) return;
-  
-  // 获取线段的两个端点
-  cv::Point p1 = defect.contour[0];
-  cv::Point p2 = defect.contour[1];
-  
-  // 计算垂直于线段的方向
-  double dx = p2.x - p1.x;
-  double dy = p2.y - p1.y;
-  double len = std::sqrt(dx*dx + dy*dy);
-  if (len < 1) return;
-  
-  // 归一化垂直方向
-  double perpX = -dy / len;
-  double perpY = dx / len;
-  
-  // 沿线段采样多个位置
-  int numSamples = std::min(10, static_cast<int>(len / 5) + 1);
-  std::vector<double> widthMeasurements;
-  
-  for (int i = 0; i < numSamples; ++i) {
-    double t = (numSamples > 1) ? static_cast<double>(i) / (numSamples - 1) : 0.5;
-    int cx = static_cast<int>(p1.x + t * dx);
-    int cy = static_cast<int>(p1.y + t * dy);
-    
-    // 沿垂直方向采样灰度值
-    std::vector<uchar> profile;
-    int halfWidth = 10;  // 采样半宽度
-    
-    for (int j = -halfWidth; j <= halfWidth; ++j) {
-      int px = cx + static_cast<int>(j * perpX);
-      int py = cy + static_cast<int>(j * perpY);
-      
-      if (px >= 0 && px < gray.cols && py >= 0 && py < gray.rows) {
-        profile.push_back(gray.at<uchar>(py, px));
+void ScratchDetector::analyzeGrayProfiles(std::vector<DefectInfo>& defects, const cv::Mat& gray) {
+  // 1. 每个缺陷沿线段均匀取若干采样点，每个采样点占剖面矩阵一行
+  std::vector<int> firstRow(defects.size() + 1, 0);
+  int totalRows = 0;
+  for (size_t k = 0; k < defects.size(); ++k) {
+    firstRow[k] = totalRows;
+    const auto& contour = defects[k].contour;
+    if (contour.size() < 2) continue;
+    const double len = cv::norm(contour[1] - contour[0]);
+    if (len < 1) continue;
+    totalRows += std::min(MAX_PROFILE_SAMPLES, static_cast<int>(len / 5) + 1);
+  }
+  firstRow[defects.size()] = totalRows;
+  if (totalRows == 0 || gray.empty()) return;
+
+  // 2. 采样坐标表：抽头沿垂直方向等距 1 像素，坐标保留亚像素精度；
+  //    抽头沿直线排列，落在图像内的部分是连续区间 [lo, hi]
+  cv::Mat mapX(totalRows, PROFILE_TAPS, CV_32F);
+  cv::Mat mapY(totalRows, PROFILE_TAPS, CV_32F);
+  std::vector<cv::Vec2i> validRange(totalRows);
+  const float maxX = static_cast<float>(gray.cols - 1);
+  const float maxY = static_cast<float>(gray.rows - 1);
+
+  for (size_t k = 0; k < defects.size(); ++k) {
+    const int samples = firstRow[k + 1] - firstRow[k];
+    if (samples == 0) continue;
+
+    const cv::Point p1 = defects[k].contour[0];
+    const cv::Point p2 = defects[k].contour[1];
+    const double dx = p2.x - p1.x;
+    const double dy = p2.y - p1.y;
+    const double len = std::sqrt(dx * dx + dy * dy);
+    // 归一化垂直方向
+    const double perpX = -dy / len;
+    const double perpY = dx / len;
+
+    for (int i = 0; i < samples; ++i) {
+      const double t = (samples > 1) ? static_cast<double>(i) / (samples - 1) : 0.5;
+      const double cx = p1.x + t * dx;
+      const double cy = p1.y + t * dy;
+
+      const int row = firstRow[k] + i;
+      float* xs = mapX.ptr<float>(row);
+      float* ys = mapY.ptr<float>(row);
+      int lo = PROFILE_TAPS, hi = -1;
+      for (int j = 0; j < PROFILE_TAPS; ++j) {
+        const int offset = j - PROFILE_HALF_WIDTH;
+        xs[j] = static_cast<float>(cx + offset * perpX);
+        ys[j] = static_cast<float>(cy + offset * perpY);
+        if (xs[j] >= 0.0f && xs[j] <= maxX && ys[j] >= 0.0f && ys[j] <= maxY) {
+          lo = std::min(lo, j);
+          hi = j;
+        }
       }
+      validRange[row] = cv::Vec2i(lo, hi);
     }
-    
-    if (profile.size() < 5) continue;
-    
-    // 计算背景灰度（两端平均）
-    double leftBg = 0, rightBg = 0;
-    int bgSamples = std::min(3, static_cast<int>(profile.size() / 4));
+  }
+
+  // 3. 一次 remap 双线性插值取出全部剖面
+  cv::Mat sampled, profiles;
+  cv::remap(gray, sampled, mapX, mapY, cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+  sampled.convertTo(profiles, CV_32F);
+
+  // 4. 背景灰度（两端各 PROFILE_BG_TAPS 个抽头的平均）与暗区阈值，整列归约
+  cv::Mat leftSum, rightSum;
+  cv::reduce(profiles.colRange(0, PROFILE_BG_TAPS), leftSum, 1, cv::REDUCE_SUM, CV_32F);
+  cv::reduce(profiles.colRange(PROFILE_TAPS - PROFILE_BG_TAPS, PROFILE_TAPS), rightSum, 1, cv::REDUCE_SUM, CV_32F);
+  cv::Mat threshold = (leftSum + rightSum) * (PROFILE_DARK_RATIO / (2.0 * PROFILE_BG_TAPS));
+
+  // 靠近图像边缘的剖面只有部分抽头有效，背景取有效区间两端
+  for (int row = 0; row < totalRows; ++row) {
+    const int lo = validRange[row][0], hi = validRange[row][1];
+    const int count = hi - lo + 1;
+    if (count == PROFILE_TAPS || count < 5) continue;
+    const float* p = profiles.ptr<float>(row);
+    const int bgSamples = std::min(PROFILE_BG_TAPS, count / 4);
+    double bg = 0.0;
     for (int j = 0; j < bgSamples; ++j) {
-      leftBg += profile[j];
-      rightBg += profile[profile.size() - 1 - j];
+      bg += p[lo + j] + p[hi - j];
     }
-    leftBg /= bgSamples;
-    rightBg /= bgSamples;
-    double bgValue = (leftBg + rightBg) / 2.0;
-    
-    // 寻找划痕宽度（灰度显著偏离背景的区域）
-    double threshold = bgValue * 0.8;  // 20% 偏差
-    int startIdx = -1, endIdx = -1;
-    
-    for (size_t j = 0; j < profile.size(); ++j) {
-      bool isDark = profile[j] < threshold;
-      if (isDark && startIdx < 0) startIdx = j;
-      if (isDark) endIdx = j;
+    threshold.at<float>(row) = static_cast<float>(bg / (2.0 * bgSamples) * PROFILE_DARK_RATIO);
+  }
+
+  // 暗区掩码（灰度显著低于背景）
+  cv::Mat dark;
+  cv::compare(profiles, cv::repeat(threshold, 1, PROFILE_TAPS), dark, cv::CMP_LT);
+
+  // 5. 宽度：首尾暗抽头两侧的阈值穿越点线性插值，得到亚像素宽度
+  for (size_t k = 0; k < defects.size(); ++k) {
+    double widthSum = 0.0;
+    int widthCount = 0;
+
+    for (int row = firstRow[k]; row < firstRow[k + 1]; ++row) {
+      const int lo = validRange[row][0], hi = validRange[row][1];
+      if (hi - lo + 1 < 5) continue;
+
+      const uchar* d = dark.ptr<uchar>(row);
+      int start = lo;
+      while (start <= hi && !d[start]) ++start;
+      if (start > hi) continue;
+      int end = hi;
+      while (!d[end]) --end;
+      if (end <= start) continue;
+
+      const float* p = profiles.ptr<float>(row);
+      const float thr = threshold.at<float>(row);
+      double left = start, right = end;
+      if (start > lo) {
+        left = start - (thr - p[start]) / (p[start - 1] - p[start]);
+      }
+      if (end < hi) {
+        right = end + (thr - p[end]) / (p[end + 1] - p[end]);
+      }
+      widthSum += right - left;
+      ++widthCount;
     }
-    
-    if (startIdx >= 0 && endIdx > startIdx) {
-      widthMeasurements.push_back(endIdx - startIdx);
+
+    // 计算平均宽度
+    if (widthCount > 0) {
+      DefectInfo& defect = defects[k];
+      const double avgWidth = widthSum / widthCount;
+      defect.features.set(DefectFeatures::MeasuredWidth, avgWidth);
+
+      // 更新严重度
+      double length = defect.features.get(DefectFeatures::Length);
+      defect.severity = calculateSeverity(length, avgWidth);
     }
   }
-  
-  // 计算平均宽度
-  if (!widthMeasurements.empty()) {
-    double avgWidth = 0;
-    for (double w : widthMeasurements) avgWidth += w;
-    avgWidth /= widthMeasurements.size();
-    
-    defect.attributes["measuredWidth"] = avgWidth;
-    
-    // 更新严重度
-    double length = defect.attributes.value("length", 0.0).toDouble();
-    defect.severity = calculateSeverity(length, avgWidth);
-  }
 }
 
-std::vector<DefectInfo> ScratchDetector::findScratches(const cv::Mat& edges, const cv::Mat& /*original*/) {
+std::vector<DefectInfo> ScratchDetector::findScratches(const cv::Mat& edges, const cv::Mat& /*original*/,
+                                                       const Params& params) {
   std::vector<DefectInfo> defects;
 
   // 查找轮廓
@@ -373,7 +537,7 @@ std::vector<DefectInfo> ScratchDetector::findScratches(const cv::Mat& edges, con
     double width = std::min(rotRect.size.width, rotRect.size.height);
 
     // 检查是否符合划痕特征（细长）
-    if (length < m_minLength || width > m_maxWidth) {
+    if (length < params.minLength || width > params.maxWidth) {
       continue;
     }
 
@@ -399,13 +563,13 @@ std::vector<DefectInfo> ScratchDetector::findScratches(const cv::Mat& edges, con
     defect.severity = calculateSeverity(length, width);
     
     // 附加属性
-    defect.attributes["length"] = length;
-    defect.attributes["width"] = width;
-    defect.attributes["aspectRatio"] = aspectRatio;
-    defect.attributes["angle"] = rotRect.angle;
-    defect.attributes["method"] = "contour";
+    defect.features.method = DetectionMethod::Contour;
+    defect.features.set(DefectFeatures::Length, length);
+    defect.features.set(DefectFeatures::Width, width);
+    defect.features.set(DefectFeatures::AspectRatio, aspectRatio);
+    defect.features.set(DefectFeatures::Angle, rotRect.angle);
 
-    defects.push_back(defect);
+    defects.push_back(std::move(defect));
   }
 
   return defects;
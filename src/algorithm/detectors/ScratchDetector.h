@@ -18,6 +18,8 @@
 #define SCRATCHDETECTOR_H
 
 #include "../BaseDetector.h"
+#include <array>
+#include <atomic>
 
 // 划痕检测器：使用边缘检测+形态学方法
 class ALGORITHM_LIBRARY ScratchDetector : public BaseDetector {
@@ -32,23 +34,70 @@ public:
   bool initialize() override;
   void release() override;
   DetectionResult detect(const cv::Mat& image) override;
+  DetectionResult detect(const FrameContext& ctx) override;
+  std::vector<FrameContext::Request> frameProducts() const override;
+
+  static constexpr int MAX_PYRAMID_LEVELS = 3;
+
+  // 单个尺度（金字塔层级）的累计耗时与产出，用于判断该尺度是否值得保留
+  struct ScaleTiming {
+    std::size_t calls = 0;
+    double totalMs = 0.0;
+    std::size_t kept = 0;         // 置信度达标的候选数（NMS 前）
+    double averageMs() const { return calls > 0 ? totalMs / calls : 0.0; }
+  };
+  ScaleTiming scaleTiming(int level) const;
+
+protected:
+  void compileParameters(const QVariantMap& params) override;
 
 private:
-  // 参数
-  int m_sensitivity = 75;       // 灵敏度 [0-100]
-  int m_minLength = 10;         // 最小长度（像素）
-  int m_maxWidth = 5;           // 最大宽度（像素）
-  int m_contrastThreshold = 30; // 对比度阈值
+  // 类型化参数（编译自参数表，detect() 每帧读取一次快照）
+  struct Params {
+    int sensitivity = 75;       // 灵敏度 [0-100]
+    int minLength = 10;         // 最小长度（像素）
+    int maxWidth = 5;           // 最大宽度（像素）
+    int contrastThreshold = 30; // 对比度阈值
+    int pyramidLevels = 2;      // 多尺度层数（金字塔 0..N-1 级）
+  };
+  ParamSnapshot<Params> m_paramSnapshot;
+
+  // LSD 线段候选（存放于帧内存池，置信度达标后才构造 DefectInfo）
+  struct LineCandidate {
+    cv::Rect bbox;
+    cv::Point p1, p2;
+    double confidence = 0.0;
+    double severity = 0.0;
+    DefectFeatures features;
+  };
+
+  // 单个尺度的检测输出（坐标已换算回原图）
+  struct ScaleOutput {
+    explicit ScaleOutput(std::pmr::memory_resource* resource) : lines(resource) {}
+    std::pmr::vector<LineCandidate> lines;
+    std::vector<DefectInfo> contours;
+    double timeMs = 0.0;
+  };
 
   // 内部方法
-  void updateParameters();
-  cv::Mat preprocessImage(const cv::Mat& input);
-  std::vector<DefectInfo> findScratches(const cv::Mat& edges, const cv::Mat& original);
-  std::vector<DefectInfo> detectLinesHough(const cv::Mat& edges, const cv::Mat& original);
-  std::vector<DefectInfo> detectLinesLSD(const cv::Mat& gray, const cv::Mat& original);
-  void analyzeGrayProfile(DefectInfo& defect, const cv::Mat& gray);
+  const cv::Mat& preprocessImage(const FrameContext& ctx);
+  // 在金字塔第 level 级上执行 LSD 与边缘轮廓检测（各级可并发执行）
+  void detectScale(const FrameContext& ctx, int level, const Params& params, ScaleOutput& output);
+  std::vector<DefectInfo> findScratches(const cv::Mat& edges, const cv::Mat& original, const Params& params);
+  std::vector<DefectInfo> detectLinesHough(const cv::Mat& edges, const cv::Mat& original, const Params& params);
+  void detectLinesLSD(const cv::Mat& gray, const Params& params, std::pmr::vector<LineCandidate>& candidates);
+  DefectInfo makeDefect(const LineCandidate& candidate) const;
+  // 垂直剖面测宽：全部缺陷的采样点经一次 remap 双线性取样，逐行批量求宽度
+  static void analyzeGrayProfiles(std::vector<DefectInfo>& defects, const cv::Mat& gray);
   bool isValidScratch(const std::vector<cv::Point>& contour);
-  double calculateSeverity(double length, double avgWidth);
+  static double calculateSeverity(double length, double avgWidth);
+
+  struct ScaleSlot {
+    std::atomic<std::size_t> calls{0};
+    std::atomic<long long> totalUs{0};
+    std::atomic<std::size_t> kept{0};
+  };
+  std::array<ScaleSlot, MAX_PYRAMID_LEVELS> m_scaleTimings;
 };
 
 #endif // SCRATCHDETECTOR_H
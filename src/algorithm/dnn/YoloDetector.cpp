@@ -145,7 +145,7 @@ DetectionResult YoloDetector::detect(const cv::Mat& image) {
     
     // 过滤低置信度
     size_t beforeFilter = defects.size();
-    defects = filterByConfidence(defects);
+    defects = filterByConfidence(std::move(defects));
     
     double timeMs = timer.elapsed();
     
@@ -164,7 +164,7 @@ DetectionResult YoloDetector::detect(const cv::Mat& image) {
       LOG_DEBUG("YoloDetector::detect - No defects found, time:{:.1f}ms", timeMs);
     }
     
-    return makeSuccessResult(defects, timeMs);
+    return makeSuccessResult(std::move(defects), timeMs);
     
   } catch (const cv::Exception& e) {
     return makeErrorResult(QString("OpenCV error: %1").arg(e.what()));
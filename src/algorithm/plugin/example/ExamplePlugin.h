@@ -78,7 +78,7 @@ public:
       defects.push_back(defect);
     }
     
-    return makeSuccessResult(defects, timer.elapsed());
+    return makeSuccessResult(std::move(defects), timer.elapsed());
   }
 
 private:
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <map>
 #include <cmath>
+#include <iterator>
+#include <numeric>
 
 // ============================================================================
 // NMSFilter
@@ -37,61 +39,97 @@ double NMSFilter::computeIoU(const cv::Rect& a, const cv::Rect& b) {
   return intersection / unionArea;
 }
 
-std::vector<DefectInfo> NMSFilter::filter(const std::vector<DefectInfo>& defects) {
+std::vector<DefectInfo> NMSFilter::filter(std::vector<DefectInfo> defects) {
   if (defects.empty()) {
-    return {};
+    return defects;
   }
-  
-  size_t inputCount = defects.size();
 
-  // 按置信度降序排序
-  std::vector<DefectInfo> sorted = defects;
-  std::sort(sorted.begin(), sorted.end(), [](const DefectInfo& a, const DefectInfo& b) {
-    return a.confidence > b.confidence;
+  // 只对下标排序，缺陷（轮廓、特征）在输出前不移动
+  std::vector<size_t> order(defects.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&defects](size_t a, size_t b) {
+    return defects[a].confidence > defects[b].confidence;
   });
 
-  std::vector<bool> suppressed(sorted.size(), false);
-  std::vector<DefectInfo> result;
+  std::vector<size_t> kept;
+  suppress(defects, order, 0, order.size(), kept);
+
+  size_t suppCount = defects.size() - kept.size();
+  if (suppCount > 0) {
+    LOG_DEBUG("NMSFilter::filter - {} -> {} defects (suppressed {} by IoU>{:.2f}, conf<{:.2f})",
+              defects.size(), kept.size(), suppCount, m_iouThreshold, m_confThreshold);
+  }
+  return take(defects, kept);
+}
+
+std::vector<DefectInfo> NMSFilter::filterByClass(std::vector<DefectInfo> defects) {
+  if (defects.empty()) {
+    return defects;
+  }
+
+  // 按（类别升序，置信度降序）排序下标，各类别为连续区间
+  std::vector<size_t> order(defects.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&defects](size_t a, size_t b) {
+    if (defects[a].classId != defects[b].classId) {
+      return defects[a].classId < defects[b].classId;
+    }
+    return defects[a].confidence > defects[b].confidence;
+  });
 
-  for (size_t i = 0; i < sorted.size(); ++i) {
+  // 对每个类别分别执行 NMS
+  std::vector<size_t> kept;
+  for (size_t begin = 0; begin < order.size(); ) {
+    size_t end = begin + 1;
+    while (end < order.size() && defects[order[end]].classId == defects[order[begin]].classId) {
+      ++end;
+    }
+    suppress(defects, order, begin, end, kept);
+    begin = end;
+  }
+
+  size_t suppCount = defects.size() - kept.size();
+  if (suppCount > 0) {
+    LOG_DEBUG("NMSFilter::filterByClass - {} -> {} defects (suppressed {} by IoU>{:.2f}, conf<{:.2f})",
+              defects.size(), kept.size(), suppCount, m_iouThreshold, m_confThreshold);
+  }
+  return take(defects, kept);
+}
+
+void NMSFilter::suppress(const std::vector<DefectInfo>& defects, const std::vector<size_t>& order,
+                         size_t begin, size_t end, std::vector<size_t>& kept) const {
+  // 按排序顺序把框复制到连续数组，两两比较时不再跨越整个 DefectInfo 访问内存
+  const size_t count = end - begin;
+  std::vector<cv::Rect> boxes(count);
+  for (size_t i = 0; i < count; ++i) {
+    boxes[i] = defects[order[begin + i]].bbox;
+  }
+  std::vector<bool> suppressed(count, false);
+
+  for (size_t i = 0; i < count; ++i) {
     if (suppressed[i]) continue;
-    if (sorted[i].confidence < m_confThreshold) continue;
+    if (defects[order[begin + i]].confidence < m_confThreshold) continue;
 
-    result.push_back(sorted[i]);
+    kept.push_back(order[begin + i]);
 
     // 抑制与当前缺陷重叠度高的其他缺陷
-    for (size_t j = i + 1; j < sorted.size(); ++j) {
+    for (size_t j = i + 1; j < count; ++j) {
       if (suppressed[j]) continue;
 
-      double iou = computeIoU(sorted[i].bbox, sorted[j].bbox);
+      double iou = computeIoU(boxes[i], boxes[j]);
       if (iou > m_iouThreshold) {
         suppressed[j] = true;
       }
     }
   }
-
-  size_t suppCount = inputCount - result.size();
-  if (suppCount > 0) {
-    LOG_DEBUG("NMSFilter::filter - {} -> {} defects (suppressed {} by IoU>{:.2f}, conf<{:.2f})",
-              inputCount, result.size(), suppCount, m_iouThreshold, m_confThreshold);
-  }
-  return result;
 }
 
-std::vector<DefectInfo> NMSFilter::filterByClass(const std::vector<DefectInfo>& defects) {
-  // 按类别分组
-  std::map<int, std::vector<DefectInfo>> byClass;
-  for (const auto& d : defects) {
-    byClass[d.classId].push_back(d);
-  }
-
-  // 对每个类别分别执行 NMS
+std::vector<DefectInfo> NMSFilter::take(std::vector<DefectInfo>& defects, const std::vector<size_t>& kept) {
   std::vector<DefectInfo> result;
-  for (auto& pair : byClass) {
-    auto filtered = filter(pair.second);
-    result.insert(result.end(), filtered.begin(), filtered.end());
+  result.reserve(kept.size());
+  for (size_t index : kept) {
+    result.push_back(std::move(defects[index]));
   }
-
   return result;
 }
 
@@ -119,7 +157,7 @@ double DefectMerger::computeDistance(const cv::Rect& a, const cv::Rect& b) {
   return std::sqrt(hDist * hDist + vDist * vDist);
 }
 
-DefectInfo DefectMerger::mergeDefects(const DefectInfo& a, const DefectInfo& b) {
+DefectInfo DefectMerger::mergeDefects(DefectInfo& a, DefectInfo& b) {
   DefectInfo merged;
   
   // 合并边界框
@@ -130,7 +168,7 @@ DefectInfo DefectMerger::mergeDefects(const DefectInfo& a, const DefectInfo& b)
   merged.bbox = cv::Rect(x1, y1, x2 - x1, y2 - y1);
 
   // 合并轮廓
-  merged.contour = a.contour;
+  merged.contour = std::move(a.contour);
   merged.contour.insert(merged.contour.end(), b.contour.begin(), b.contour.end());
 
   // 取最大置信度和严重度
@@ -140,29 +178,25 @@ DefectInfo DefectMerger::mergeDefects(const DefectInfo& a, const DefectInfo& b)
   // 保留主要缺陷的类别
   if (a.confidence >= b.confidence) {
     merged.classId = a.classId;
-    merged.className = a.className;
+    merged.className = std::move(a.className);
   } else {
     merged.classId = b.classId;
-    merged.className = b.className;
+    merged.className = std::move(b.className);
   }
 
   // 合并属性
-  merged.attributes = a.attributes;
-  for (auto it = b.attributes.begin(); it != b.attributes.end(); ++it) {
-    if (!merged.attributes.contains(it.key())) {
-      merged.attributes[it.key()] = it.value();
-    }
-  }
+  merged.features = a.features;
+  merged.features.mergeMissing(b.features);
 
   return merged;
 }
 
-std::vector<DefectInfo> DefectMerger::merge(const std::vector<DefectInfo>& defects) {
+std::vector<DefectInfo> DefectMerger::merge(std::vector<DefectInfo> defects) {
   if (defects.size() < 2) {
     return defects;
   }
 
-  std::vector<DefectInfo> result = defects;
+  std::vector<DefectInfo> result = std::move(defects);
   bool merged = true;
 
   while (merged) {
@@ -177,7 +211,7 @@ std::vector<DefectInfo> DefectMerger::merge(const std::vector<DefectInfo>& defec
           DefectInfo mergedDefect = mergeDefects(result[i], result[j]);
           result.erase(result.begin() + j);
           result.erase(result.begin() + i);
-          result.push_back(mergedDefect);
+          result.push_back(std::move(mergedDefect));
           merged = true;
         }
       }
@@ -187,18 +221,19 @@ std::vector<DefectInfo> DefectMerger::merge(const std::vector<DefectInfo>& defec
   return result;
 }
 
-std::vector<DefectInfo> DefectMerger::mergeByClass(const std::vector<DefectInfo>& defects) {
+std::vector<DefectInfo> DefectMerger::mergeByClass(std::vector<DefectInfo> defects) {
   // 按类别分组
   std::map<int, std::vector<DefectInfo>> byClass;
-  for (const auto& d : defects) {
-    byClass[d.classId].push_back(d);
+  for (auto& d : defects) {
+    byClass[d.classId].push_back(std::move(d));
   }
 
   // 对每个类别分别合并
   std::vector<DefectInfo> result;
   for (auto& pair : byClass) {
-    auto merged = merge(pair.second);
-    result.insert(result.end(), merged.begin(), merged.end());
+    auto merged = merge(std::move(pair.second));
+    result.insert(result.end(), std::make_move_iterator(merged.begin()),
+                  std::make_move_iterator(merged.end()));
   }
 
   return result;
@@ -35,11 +35,12 @@ public:
   void setConfidenceThreshold(double threshold);
   double confidenceThreshold() const { return m_confThreshold; }
 
-  // 执行 NMS
-  std::vector<DefectInfo> filter(const std::vector<DefectInfo>& defects);
+  // 执行 NMS，结果按置信度降序
+  // 输入按值传递：调用方 std::move 传入时全程移动，缺陷本身不被复制
+  std::vector<DefectInfo> filter(std::vector<DefectInfo> defects);
 
-  // 按类别分别执行 NMS
-  std::vector<DefectInfo> filterByClass(const std::vector<DefectInfo>& defects);
+  // 按类别分别执行 NMS，结果按类别升序、类内置信度降序
+  std::vector<DefectInfo> filterByClass(std::vector<DefectInfo> defects);
 
   // 计算两个矩形的 IoU
   static double computeIoU(const cv::Rect& a, const cv::Rect& b);
@@ -47,6 +48,13 @@ public:
 private:
   double m_iouThreshold = 0.5;
   double m_confThreshold = 0.3;
+
+  // 对排序后下标 order[begin, end) 执行抑制，保留的缺陷下标追加到 kept
+  void suppress(const std::vector<DefectInfo>& defects, const std::vector<size_t>& order,
+                size_t begin, size_t end, std::vector<size_t>& kept) const;
+
+  // 按 kept 下标顺序移动出结果
+  static std::vector<DefectInfo> take(std::vector<DefectInfo>& defects, const std::vector<size_t>& kept);
 };
 
 // 缺陷合并器：合并相邻的同类缺陷
@@ -60,10 +68,10 @@ public:
   double distanceThreshold() const { return m_distanceThreshold; }
 
   // 合并相邻缺陷
-  std::vector<DefectInfo> merge(const std::vector<DefectInfo>& defects);
+  std::vector<DefectInfo> merge(std::vector<DefectInfo> defects);
 
   // 按类别分别合并
-  std::vector<DefectInfo> mergeByClass(const std::vector<DefectInfo>& defects);
+  std::vector<DefectInfo> mergeByClass(std::vector<DefectInfo> defects);
 
 private:
   double m_distanceThreshold = 20.0;
@@ -71,8 +79,8 @@ private:
   // 计算两个矩形的距离
   double computeDistance(const cv::Rect& a, const cv::Rect& b);
 
-  // 合并两个缺陷
-  DefectInfo mergeDefects(const DefectInfo& a, const DefectInfo& b);
+  // 合并两个缺陷（移出 a、b 的内容）
+  DefectInfo mergeDefects(DefectInfo& a, DefectInfo& b);
 };
 
 #endif // NMSFILTER_H
@@ -0,0 +1,300 @@
+#include "GaborFilterBank.h"
+#include "ParallelFor.h"
+#include <opencv2/imgproc.hpp>
+#include <QElapsedTimer>
+#include <cmath>
+
+namespace {
+
+// 频域路径代价：一次实数 FFT 每点约 DFT_COST_PER_LOG2 × log2(点数) 次乘加（含访存开销）。
+// 估计值，tests/performance/bench_gabor 按实测耗时核对 auto 的选择，换平台后应重新运行
+constexpr double DFT_COST_PER_LOG2 = 4.0;
+// 核正变换只有前 ksize 行非零，行变换可跳过其余行，按半次完整变换计
+constexpr double KERNEL_DFT_COST = 0.5;
+
+// 取绝对值后并入逐像素最大值（各方向并行时加锁合并，峰值内存不超过并发数张响应图）
+void mergeAbsMax(cv::Mat& result, const cv::Mat& response, std::mutex& mutex) {
+  cv::Mat magnitude = cv::abs(response);
+  std::lock_guard<std::mutex> lock(mutex);
+  cv::max(result, magnitude, result);
+}
+
+} // namespace
+
+GaborFilterBank::GaborFilterBank(const Config& config) : m_config(config) {
+  m_config.orientations = std::max(1, m_config.orientations);
+  m_config.kernelSize = std::max(3, m_config.kernelSize | 1);
+
+  const int n = m_config.orientations;
+  const int ksize = m_config.kernelSize;
+  m_kernels.reserve(n);
+  m_separable.resize(n);
+
+  for (int i = 0; i < n; ++i) {
+    const double theta = CV_PI * i / n;
+    cv::Mat kernel = cv::getGaborKernel(cv::Size(ksize, ksize), m_config.sigma, theta,
+                                        m_config.lambda, m_config.gamma, m_config.psi, CV_32F);
+
+    // 低秩可分近似：K ≈ Σ σᵢ·uᵢ·vᵢᵀ，取能量达到阈值的最小秩；0°/90° 方向本身可分（秩 1）
+    cv::Mat kernel64;
+    kernel.convertTo(kernel64, CV_64F);
+    cv::SVD svd(kernel64);
+    const cv::Mat& w = svd.w;
+    const double totalEnergy = cv::sum(w.mul(w))[0];
+    double energy = 0.0;
+    for (int r = 0; r < w.rows; ++r) {
+      const double sv = w.at<double>(r);
+      if (sv <= 0.0) {
+        break;
+      }
+      cv::Mat column, row;
+      svd.u.col(r).convertTo(column, CV_32F, std::sqrt(sv));
+      svd.vt.row(r).convertTo(row, CV_32F, std::sqrt(sv));
+      m_separable[i].emplace_back(column, row);
+
+      energy += sv * sv;
+      if (totalEnergy <= 0.0 || energy / totalEnergy >= m_config.separableEnergy) {
+        break;
+      }
+    }
+
+    m_kernels.push_back(kernel);
+  }
+}
+
+cv::Mat GaborFilterBank::maxResponse(const cv::Mat& gray, Method method, Method* used) const {
+  CV_Assert(gray.type() == CV_8UC1);
+
+  if (method == Method::Auto || method == Method::Count) {
+    method = selectMethod(gray.size());
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  cv::Mat result;
+  switch (method) {
+  case Method::Separable:
+    result = filterSeparable(gray);
+    break;
+  case Method::Dft:
+    result = filterDft(gray);
+    break;
+  default:
+    method = Method::Direct;
+    result = filterDirect(gray);
+    break;
+  }
+
+  TimingSlot& slot = m_timings[static_cast<int>(method)];
+  slot.calls.fetch_add(1, std::memory_order_relaxed);
+  slot.totalUs.fetch_add(timer.nsecsElapsed() / 1000, std::memory_order_relaxed);
+
+  if (used) {
+    *used = method;
+  }
+  return result;
+}
+
+GaborFilterBank::Method GaborFilterBank::selectMethod(const cv::Size& imageSize) const {
+  if (imageSize.area() <= 0) {
+    return Method::Direct;
+  }
+
+  const double ksize = m_config.kernelSize;
+  const int n = orientationCount();
+
+  const double direct = n * ksize * ksize;
+
+  double separable = 0.0;
+  for (const auto& terms : m_separable) {
+    separable += static_cast<double>(terms.size()) * (2.0 * ksize + 1.0);
+  }
+
+  // 正变换 1 次 + 每方向逆变换 1 次，核频谱不缓存时每方向再加 1 次核正变换；
+  // 按补边后的 DFT 尺寸折算到每个输出像素
+  const double dftArea = static_cast<double>(dftSizeFor(imageSize).area());
+  const double transforms = (n + 1) + (cachesSpectra(imageSize) ? 0.0 : KERNEL_DFT_COST * n);
+  const double dft = DFT_COST_PER_LOG2 * std::log2(dftArea) * transforms * dftArea / imageSize.area() + 3.0 * n;
+
+  if (dft < separable && dft < direct) {
+    return Method::Dft;
+  }
+  return separable < direct ? Method::Separable : Method::Direct;
+}
+
+cv::Mat GaborFilterBank::filterDirect(const cv::Mat& gray) const {
+  cv::Mat result = cv::Mat::zeros(gray.size(), CV_32F);
+  std::mutex mergeMutex;
+
+  parallelFor(0, orientationCount(), [&](int first, int last) {
+    for (int i = first; i < last; ++i) {
+      cv::Mat filtered;
+      cv::filter2D(gray, filtered, CV_32F, m_kernels[i]);
+      mergeAbsMax(result, filtered, mergeMutex);
+    }
+  });
+  return result;
+}
+
+cv::Mat GaborFilterBank::filterSeparable(const cv::Mat& gray) const {
+  cv::Mat result = cv::Mat::zeros(gray.size(), CV_32F);
+  std::mutex mergeMutex;
+
+  parallelFor(0, orientationCount(), [&](int first, int last) {
+    for (int i = first; i < last; ++i) {
+      const auto& terms = m_separable[i];
+      if (terms.empty()) {
+        continue;
+      }
+      // sepFilter2D(kernelX = 行核, kernelY = 列核) 与 filter2D 同为相关运算、同一边界处理
+      cv::Mat response, term;
+      cv::sepFilter2D(gray, response, CV_32F, terms[0].second, terms[0].first);
+      for (std::size_t r = 1; r < terms.size(); ++r) {
+        cv::sepFilter2D(gray, term, CV_32F, terms[r].second, terms[r].first);
+        response += term;
+      }
+      mergeAbsMax(result, response, mergeMutex);
+    }
+  });
+  return result;
+}
+
+cv::Mat GaborFilterBank::filterDft(const cv::Mat& gray) const {
+  // 按 filter2D 的默认边界（BORDER_REFLECT_101）补边后做循环相关，补边保证有效区不发生回绕
+  const int border = m_config.kernelSize / 2;
+  cv::Mat padded;
+  cv::copyMakeBorder(gray, padded, border, border, border, border, cv::BORDER_REFLECT_101);
+
+  const cv::Size dftSize = dftSizeFor(gray.size());
+  cv::Mat source = cv::Mat::zeros(dftSize, CV_32F);
+  cv::Mat sourceRoi = source(cv::Rect(0, 0, padded.cols, padded.rows));
+  padded.convertTo(sourceRoi, CV_32F);
+
+  // 图像正变换只做一次，各方向共享
+  cv::Mat sourceSpectrum;
+  cv::dft(source, sourceSpectrum, 0, padded.rows);
+  source.release();
+  padded.release();
+
+  // 核频谱超过缓存上限时逐方向现算，峰值内存不超过并发数张频谱
+  const std::shared_ptr<const Spectra> spectra = spectraFor(dftSize);
+  cv::Mat result = cv::Mat::zeros(gray.size(), CV_32F);
+  std::mutex mergeMutex;
+
+  parallelFor(0, orientationCount(), [&](int first, int last) {
+    for (int i = first; i < last; ++i) {
+      // 与核频谱共轭相乘即相关运算；逆变换只需输出前 gray.rows 行
+      cv::Mat product, response;
+      cv::mulSpectrums(sourceSpectrum, spectra ? spectra->kernels[i] : kernelSpectrum(i, dftSize), product, 0, true);
+      cv::dft(product, response, cv::DFT_INVERSE | cv::DFT_SCALE | cv::DFT_REAL_OUTPUT, gray.rows);
+      mergeAbsMax(result, response(cv::Rect(0, 0, gray.cols, gray.rows)), mergeMutex);
+    }
+  });
+  return result;
+}
+
+cv::Size GaborFilterBank::dftSizeFor(const cv::Size& imageSize) const {
+  const int border = m_config.kernelSize / 2;
+  return cv::Size(cv::getOptimalDFTSize(imageSize.width + 2 * border),
+                  cv::getOptimalDFTSize(imageSize.height + 2 * border));
+}
+
+std::size_t GaborFilterBank::spectraBytes(const cv::Size& dftSize) const {
+  return static_cast<std::size_t>(dftSize.area()) * sizeof(float) * m_kernels.size();
+}
+
+bool GaborFilterBank::cachesSpectra(const cv::Size& imageSize) const {
+  return spectraBytes(dftSizeFor(imageSize)) <= MAX_SPECTRA_ENTRY_BYTES;
+}
+
+std::size_t GaborFilterBank::cachedSpectraBytes() const {
+  std::lock_guard<std::mutex> lock(m_spectraMutex);
+  return m_spectraBytes;
+}
+
+cv::Mat GaborFilterBank::kernelSpectrum(int orientation, const cv::Size& dftSize) const {
+  // 核放在左上角（锚点偏移已由图像补边抵消）
+  const cv::Mat& kernel = m_kernels[orientation];
+  cv::Mat padded = cv::Mat::zeros(dftSize, CV_32F);
+  cv::Mat paddedRoi = padded(cv::Rect(0, 0, kernel.cols, kernel.rows));
+  kernel.copyTo(paddedRoi);
+  cv::Mat spectrum;
+  cv::dft(padded, spectrum, 0, kernel.rows);
+  return spectrum;
+}
+
+std::shared_ptr<const GaborFilterBank::Spectra> GaborFilterBank::spectraFor(const cv::Size& dftSize) const {
+  const std::size_t bytes = spectraBytes(dftSize);
+  if (bytes > MAX_SPECTRA_ENTRY_BYTES) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(m_spectraMutex);
+
+  const auto key = std::make_pair(dftSize.width, dftSize.height);
+  auto it = m_spectra.find(key);
+  if (it != m_spectra.end()) {
+    it->second.lastUse = ++m_spectraUseCounter;
+    return it->second.spectra;
+  }
+
+  // 按最久未用淘汰，直到放得下新尺寸（正在使用的频谱由调用方的 shared_ptr 保持到本次结束）
+  while (!m_spectra.empty() && m_spectraBytes + bytes > MAX_CACHED_SPECTRA_BYTES) {
+    auto oldest = m_spectra.begin();
+    for (auto entry = m_spectra.begin(); entry != m_spectra.end(); ++entry) {
+      if (entry->second.lastUse < oldest->second.lastUse) {
+        oldest = entry;
+      }
+    }
+    m_spectraBytes -= oldest->second.spectra->bytes;
+    m_spectra.erase(oldest);
+  }
+
+  auto spectra = std::make_shared<Spectra>();
+  spectra->kernels.reserve(m_kernels.size());
+  for (int i = 0; i < orientationCount(); ++i) {
+    spectra->kernels.push_back(kernelSpectrum(i, dftSize));
+  }
+  spectra->bytes = bytes;
+
+  m_spectra.emplace(key, CachedSpectra{spectra, ++m_spectraUseCounter});
+  m_spectraBytes += bytes;
+  return spectra;
+}
+
+GaborFilterBank::PathTiming GaborFilterBank::timing(Method method) const {
+  PathTiming result;
+  if (method == Method::Count) {
+    return result;
+  }
+  const TimingSlot& slot = m_timings[static_cast<int>(method)];
+  result.calls = slot.calls.load(std::memory_order_relaxed);
+  result.totalMs = slot.totalUs.load(std::memory_order_relaxed) / 1000.0;
+  return result;
+}
+
+void GaborFilterBank::resetTimings() {
+  for (TimingSlot& slot : m_timings) {
+    slot.calls.store(0, std::memory_order_relaxed);
+    slot.totalUs.store(0, std::memory_order_relaxed);
+  }
+}
+
+const char* GaborFilterBank::methodName(Method method) {
+  switch (method) {
+  case Method::Auto:      return "auto";
+  case Method::Direct:    return "direct";
+  case Method::Separable: return "separable";
+  case Method::Dft:       return "dft";
+  default:                return "unknown";
+  }
+}
+
+GaborFilterBank::Method GaborFilterBank::methodFromName(const QString& name) {
+  const QString key = name.trimmed().toLower();
+  if (key == "direct") return Method::Direct;
+  if (key == "separable") return Method::Separable;
+  if (key == "dft") return Method::Dft;
+  return Method::Auto;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * GaborFilterBank.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：Gabor 滤波器组
+ * 描述：预先生成的多方向 Gabor 核（构造时一次生成，参数不变则复用），输出各方向
+ *       响应绝对值的逐像素最大值。支持三种卷积路径：filter2D 直接卷积、SVD 低秩
+ *       可分近似（sepFilter2D）、频域卷积（各方向共享一次图像正变换），可按图像与
+ *       核尺寸自动选择；各方向并行计算，并按路径累计耗时
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef GABORFILTERBANK_H
+#define GABORFILTERBANK_H
+
+#include "../algorithm_global.h"
+#include <opencv2/core.hpp>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// 线程安全：构造后只读，频域核缓存与耗时统计内部加锁/原子
+// 频域核缓存按字节数限制：单个 DFT 尺寸的核频谱超过 MAX_SPECTRA_ENTRY_BYTES 时不缓存（每次调用逐方向
+// 现算、用完即弃），缓存总量超过 MAX_CACHED_SPECTRA_BYTES 时淘汰最久未用的尺寸
+class ALGORITHM_LIBRARY GaborFilterBank {
+public:
+  enum class Method {
+    Auto,       // 按代价模型选择
+    Direct,     // cv::filter2D（大核时 OpenCV 内部可能分块 DFT）
+    Separable,  // SVD 低秩可分近似，每个秩一次 sepFilter2D
+    Dft,        // 频域卷积，图像正变换在各方向间共享
+    Count
+  };
+
+  struct Config {
+    int orientations = 4;            // 方向数，θ = k·180°/N
+    int kernelSize = 21;
+    double sigma = 4.0;
+    double lambda = 10.0;
+    double gamma = 0.5;
+    double psi = 0.0;
+    double separableEnergy = 0.999;  // 可分近似保留的奇异值平方和比例
+  };
+
+  // 单条路径的累计耗时
+  struct PathTiming {
+    std::size_t calls = 0;
+    double totalMs = 0.0;
+    double averageMs() const { return calls > 0 ? totalMs / calls : 0.0; }
+  };
+
+  explicit GaborFilterBank(const Config& config);
+
+  GaborFilterBank(const GaborFilterBank&) = delete;
+  GaborFilterBank& operator=(const GaborFilterBank&) = delete;
+
+  const Config& config() const { return m_config; }
+  int orientationCount() const { return static_cast<int>(m_kernels.size()); }
+  // 某方向可分近似使用的秩
+  int separableRank(int orientation) const { return static_cast<int>(m_separable[orientation].size()); }
+
+  // 各方向响应绝对值的逐像素最大值（CV_32F，与输入同尺寸）；used 返回实际采用的路径
+  cv::Mat maxResponse(const cv::Mat& gray, Method method = Method::Auto, Method* used = nullptr) const;
+
+  // 代价模型：按每输出像素的乘加次数估计，取最小者（频域路径按该尺寸的核频谱能否缓存计入核正变换）
+  Method selectMethod(const cv::Size& imageSize) const;
+
+  // 频域路径在该图像尺寸下是否缓存核频谱
+  bool cachesSpectra(const cv::Size& imageSize) const;
+  // 当前缓存的核频谱字节数
+  std::size_t cachedSpectraBytes() const;
+
+  static constexpr std::size_t MAX_SPECTRA_ENTRY_BYTES = 64u << 20;   // 单个 DFT 尺寸（2 MP、8 方向约 62 MB 可缓存；12 MP 不缓存）
+  static constexpr std::size_t MAX_CACHED_SPECTRA_BYTES = 192u << 20; // 缓存总量
+
+  PathTiming timing(Method method) const;
+  void resetTimings();
+
+  static const char* methodName(Method method);
+  // 未知名称返回 Auto
+  static Method methodFromName(const QString& name);
+
+private:
+  // 某 DFT 尺寸下各方向核的频谱（CCS 格式）
+  struct Spectra {
+    std::vector<cv::Mat> kernels;
+    std::size_t bytes = 0;
+  };
+
+  struct CachedSpectra {
+    std::shared_ptr<const Spectra> spectra;
+    std::uint64_t lastUse = 0;
+  };
+
+  cv::Mat filterDirect(const cv::Mat& gray) const;
+  cv::Mat filterSeparable(const cv::Mat& gray) const;
+  cv::Mat filterDft(const cv::Mat& gray) const;
+  // 补边后的 DFT 尺寸
+  cv::Size dftSizeFor(const cv::Size& imageSize) const;
+  std::size_t spectraBytes(const cv::Size& dftSize) const;
+  // 单个方向核的频谱
+  cv::Mat kernelSpectrum(int orientation, const cv::Size& dftSize) const;
+  // 缓存的核频谱；超过单尺寸上限时返回空指针（调用方逐方向现算）
+  std::shared_ptr<const Spectra> spectraFor(const cv::Size& dftSize) const;
+
+  Config m_config;
+  std::vector<cv::Mat> m_kernels;                                  // CV_32F，ksize × ksize
+  std::vector<std::vector<std::pair<cv::Mat, cv::Mat>>> m_separable;  // 每个方向：(列核, 行核) × 秩
+
+  mutable std::mutex m_spectraMutex;
+  mutable std::map<std::pair<int, int>, CachedSpectra> m_spectra;
+  mutable std::size_t m_spectraBytes = 0;
+  mutable std::uint64_t m_spectraUseCounter = 0;
+
+  struct TimingSlot {
+    std::atomic<std::size_t> calls{0};
+    std::atomic<long long> totalUs{0};
+  };
+  mutable std::array<TimingSlot, static_cast<int>(Method::Count)> m_timings;
+};
+
+#endif // GABORFILTERBANK_H
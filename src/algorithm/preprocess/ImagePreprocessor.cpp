@@ -167,7 +167,8 @@ cv::Mat ImagePreprocessor::processAdaptive(const cv::Mat& input) {
   // 获取建议参数
   AdaptiveParams params = suggestParams(quality);
   
-  cv::Mat result = input.clone();
+  // 以下各步骤均输出到新的 Mat，无需预先拷贝输入
+  cv::Mat result = input;
   
   // 1. 应用 ROI
   if (m_hasROI) {
@@ -218,7 +219,8 @@ cv::Mat ImagePreprocessor::process(const cv::Mat& input) {
     return processAdaptive(input);
   }
 
-  cv::Mat result = input.clone();
+  // 以下各步骤均输出到新的 Mat，无需预先拷贝输入
+  cv::Mat result = input;
 
   // 1. 应用 ROI
   if (m_hasROI) {
@@ -259,7 +261,8 @@ cv::Mat ImagePreprocessor::applyROI(const cv::Mat& input) {
     return input;
   }
 
-  return input(validROI).clone();
+  // 返回共享内存的视图，后续处理步骤均不原地修改；需要独立副本时由调用方 clone
+  return input(validROI);
 }
 
 cv::Mat ImagePreprocessor::denoise(const cv::Mat& input) {
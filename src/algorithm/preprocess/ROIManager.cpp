@@ -0,0 +1,282 @@
+#include "ROIManager.h"
+#include "Logger.h"
+#include <opencv2/imgproc.hpp>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+
+// ============================================================================
+// ROIShape
+// ============================================================================
+
+QJsonObject ROIShape::toJson() const {
+  QJsonObject json;
+  json["name"] = name;
+  json["exclude"] = exclude;
+  if (type == Type::Rect) {
+    json["type"] = "rect";
+    json["x"] = rect.x;
+    json["y"] = rect.y;
+    json["width"] = rect.width;
+    json["height"] = rect.height;
+  } else {
+    json["type"] = "polygon";
+    QJsonArray points;
+    for (const auto& pt : polygon) {
+      points.append(QJsonArray{pt.x, pt.y});
+    }
+    json["points"] = points;
+  }
+  return json;
+}
+
+ROIShape ROIShape::fromJson(const QJsonObject& json) {
+  ROIShape shape;
+  shape.name = json["name"].toString();
+  shape.exclude = json["exclude"].toBool(false);
+  if (json["type"].toString() == "polygon") {
+    shape.type = Type::Polygon;
+    for (const auto& value : json["points"].toArray()) {
+      QJsonArray pt = value.toArray();
+      shape.polygon.emplace_back(pt.at(0).toInt(), pt.at(1).toInt());
+    }
+  } else {
+    shape.type = Type::Rect;
+    shape.rect = cv::Rect(json["x"].toInt(), json["y"].toInt(),
+                          json["width"].toInt(), json["height"].toInt());
+  }
+  return shape;
+}
+
+// ============================================================================
+// ROIMask
+// ============================================================================
+
+bool ROIMask::contains(const cv::Point& pt) const {
+  if (mask.empty()) {
+    return true;
+  }
+  return pt.x >= 0 && pt.y >= 0 && pt.x < mask.cols && pt.y < mask.rows &&
+         mask.at<uchar>(pt) != 0;
+}
+
+// ============================================================================
+// ROIManager
+// ============================================================================
+
+void ROIManager::setShapeLocked(ROIShape shape) {
+  auto it = std::find_if(m_shapes.begin(), m_shapes.end(),
+                         [&shape](const ROIShape& s) { return s.name == shape.name; });
+  if (it != m_shapes.end()) {
+    *it = std::move(shape);
+  } else {
+    m_shapes.push_back(std::move(shape));
+  }
+  m_cache.clear();
+}
+
+void ROIManager::addRect(const QString& name, const cv::Rect& rect, bool exclude) {
+  ROIShape shape;
+  shape.name = name;
+  shape.type = ROIShape::Type::Rect;
+  shape.rect = rect;
+  shape.exclude = exclude;
+  QMutexLocker locker(&m_mutex);
+  setShapeLocked(std::move(shape));
+}
+
+void ROIManager::addPolygon(const QString& name, const std::vector<cv::Point>& polygon, bool exclude) {
+  if (polygon.size() < 3) {
+    LOG_WARN("ROIManager: Polygon '{}' needs at least 3 points", name.toStdString());
+    return;
+  }
+  ROIShape shape;
+  shape.name = name;
+  shape.type = ROIShape::Type::Polygon;
+  shape.polygon = polygon;
+  shape.exclude = exclude;
+  QMutexLocker locker(&m_mutex);
+  setShapeLocked(std::move(shape));
+}
+
+bool ROIManager::removeShape(const QString& name) {
+  QMutexLocker locker(&m_mutex);
+  auto it = std::find_if(m_shapes.begin(), m_shapes.end(),
+                         [&name](const ROIShape& s) { return s.name == name; });
+  if (it == m_shapes.end()) {
+    return false;
+  }
+  m_shapes.erase(it);
+  m_cache.clear();
+  return true;
+}
+
+void ROIManager::clear() {
+  QMutexLocker locker(&m_mutex);
+  m_shapes.clear();
+  m_cache.clear();
+}
+
+std::vector<ROIShape> ROIManager::shapes() const {
+  QMutexLocker locker(&m_mutex);
+  return m_shapes;
+}
+
+bool ROIManager::isEmpty() const {
+  QMutexLocker locker(&m_mutex);
+  return m_shapes.empty();
+}
+
+QJsonObject ROIManager::toJson() const {
+  QMutexLocker locker(&m_mutex);
+  QJsonArray shapes;
+  for (const auto& shape : m_shapes) {
+    shapes.append(shape.toJson());
+  }
+  QJsonObject json;
+  json["shapes"] = shapes;
+  return json;
+}
+
+bool ROIManager::fromJson(const QJsonObject& json) {
+  if (!json["shapes"].isArray()) {
+    LOG_WARN("ROIManager: Missing 'shapes' array");
+    return false;
+  }
+  std::vector<ROIShape> shapes;
+  for (const auto& value : json["shapes"].toArray()) {
+    ROIShape shape = ROIShape::fromJson(value.toObject());
+    if (shape.type == ROIShape::Type::Polygon ? shape.polygon.size() < 3 : shape.rect.empty()) {
+      LOG_WARN("ROIManager: Skipping invalid shape '{}'", shape.name.toStdString());
+      continue;
+    }
+    shapes.push_back(std::move(shape));
+  }
+
+  QMutexLocker locker(&m_mutex);
+  m_shapes = std::move(shapes);
+  m_cache.clear();
+  return true;
+}
+
+bool ROIManager::loadFromFile(const QString& path) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    LOG_ERROR("ROIManager: Cannot open {}", path.toStdString());
+    return false;
+  }
+  QJsonParseError error;
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+  if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+    LOG_ERROR("ROIManager: Invalid ROI file {}: {}", path.toStdString(),
+              error.errorString().toStdString());
+    return false;
+  }
+  if (!fromJson(doc.object())) {
+    return false;
+  }
+  LOG_INFO("ROIManager: Loaded {} shapes from {}", shapes().size(), path.toStdString());
+  return true;
+}
+
+bool ROIManager::saveToFile(const QString& path) const {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    LOG_ERROR("ROIManager: Cannot write {}", path.toStdString());
+    return false;
+  }
+  file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+  return true;
+}
+
+std::shared_ptr<const ROIMask> ROIManager::compile(const cv::Size& imageSize, double scale) const {
+  QMutexLocker locker(&m_mutex);
+  if (m_shapes.empty() || imageSize.empty()) {
+    return nullptr;
+  }
+
+  CacheKey key(imageSize.width, imageSize.height, cvRound(scale * 1e4));
+  auto it = m_cache.find(key);
+  if (it != m_cache.end()) {
+    return it->second;
+  }
+
+  auto mask = build(imageSize, scale);
+  if (m_cache.size() >= MAX_CACHED_MASKS) {
+    m_cache.erase(m_cache.begin());
+  }
+  m_cache[key] = mask;
+  return mask;
+}
+
+std::shared_ptr<const ROIMask> ROIManager::build(const cv::Size& imageSize, double scale) const {
+  auto roi = std::make_shared<ROIMask>();
+  roi->imageSize = imageSize;
+
+  // 仅有排除区域时，以整图为检测区域
+  const bool hasInclude = std::any_of(m_shapes.begin(), m_shapes.end(),
+                                      [](const ROIShape& s) { return !s.exclude; });
+  roi->mask = cv::Mat(imageSize, CV_8UC1, cv::Scalar(hasInclude ? 0 : 255));
+
+  auto scaled = [scale](const cv::Point& pt) {
+    return cv::Point(cvRound(pt.x * scale), cvRound(pt.y * scale));
+  };
+  auto draw = [&](const ROIShape& shape, const cv::Scalar& value) {
+    if (shape.type == ROIShape::Type::Rect) {
+      cv::Rect rect(scaled(shape.rect.tl()), scaled(shape.rect.br()));
+      roi->mask(rect & cv::Rect(cv::Point(), imageSize)).setTo(value);
+    } else {
+      std::vector<cv::Point> pts;
+      pts.reserve(shape.polygon.size());
+      for (const auto& pt : shape.polygon) {
+        pts.push_back(scaled(pt));
+      }
+      cv::fillPoly(roi->mask, std::vector<std::vector<cv::Point>>{pts}, value);
+    }
+  };
+
+  // 先绘制检测区域，再扣除排除区域
+  for (const auto& shape : m_shapes) {
+    if (!shape.exclude) {
+      draw(shape, cv::Scalar(255));
+    }
+  }
+  for (const auto& shape : m_shapes) {
+    if (shape.exclude) {
+      draw(shape, cv::Scalar(0));
+    }
+  }
+
+  // 连通区域外接矩形，相交的矩形合并，保证各矩形互不重叠
+  std::vector<std::vector<cv::Point>> contours;
+  cv::findContours(roi->mask.clone(), contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+  for (const auto& contour : contours) {
+    cv::Rect rect = cv::boundingRect(contour);
+    for (bool merged = true; merged; ) {
+      merged = false;
+      for (auto it = roi->rects.begin(); it != roi->rects.end(); ++it) {
+        if ((*it & rect).area() > 0) {
+          rect |= *it;
+          roi->rects.erase(it);
+          merged = true;
+          break;
+        }
+      }
+    }
+    roi->rects.push_back(rect);
+  }
+  std::sort(roi->rects.begin(), roi->rects.end(), [](const cv::Rect& a, const cv::Rect& b) {
+    return a.y != b.y ? a.y < b.y : a.x < b.x;
+  });
+
+  for (const auto& rect : roi->rects) {
+    roi->bounds = roi->bounds.empty() ? rect : (roi->bounds | rect);
+  }
+  roi->coverage = static_cast<double>(cv::countNonZero(roi->mask)) / imageSize.area();
+
+  LOG_DEBUG("ROIManager: Compiled {} shapes for {}x{} (scale {:.3f}) -> {} regions, coverage {:.1f}%",
+            m_shapes.size(), imageSize.width, imageSize.height, scale,
+            roi->rects.size(), roi->coverage * 100.0);
+  return roi;
+}
@@ -17,4 +17,75 @@
 #ifndef ROIMANAGER_H
 #define ROIMANAGER_H
 
+#include "../algorithm_global.h"
+#include <opencv2/core.hpp>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+// ROI 形状（坐标为相机原始分辨率）
+struct ALGORITHM_LIBRARY ROIShape {
+  enum class Type { Rect, Polygon };
+
+  QString name;
+  Type type = Type::Rect;
+  cv::Rect rect;                     // Type::Rect
+  std::vector<cv::Point> polygon;    // Type::Polygon
+  bool exclude = false;              // 排除区域（从检测区域中扣除）
+
+  QJsonObject toJson() const;
+  static ROIShape fromJson(const QJsonObject& json);
+};
+
+// 编译后的 ROI：二值掩膜 + 紧致外接矩形集合
+struct ALGORITHM_LIBRARY ROIMask {
+  cv::Size imageSize;
+  cv::Mat mask;                      // CV_8U，255 为检测区域
+  std::vector<cv::Rect> rects;       // 各连通检测区域的外接矩形（互不重叠）
+  cv::Rect bounds;                   // 所有检测区域的外接矩形
+  double coverage = 0.0;             // 检测区域占整图比例 [0-1]
+
+  bool empty() const { return rects.empty(); }
+  bool contains(const cv::Point& pt) const;
+};
+
+// ROI 管理器（线程安全）
+class ALGORITHM_LIBRARY ROIManager {
+public:
+  ROIManager() = default;
+
+  // 形状管理（同名形状会被替换）
+  void addRect(const QString& name, const cv::Rect& rect, bool exclude = false);
+  void addPolygon(const QString& name, const std::vector<cv::Point>& polygon, bool exclude = false);
+  bool removeShape(const QString& name);
+  void clear();
+  std::vector<ROIShape> shapes() const;
+  bool isEmpty() const;
+
+  // ROI 模板（JSON）保存与加载
+  QJsonObject toJson() const;
+  bool fromJson(const QJsonObject& json);
+  bool loadFromFile(const QString& path);
+  bool saveToFile(const QString& path) const;
+
+  // 编译为指定尺寸的掩膜，scale 为检测图像相对 ROI 定义坐标的缩放比例
+  // 结果按 (尺寸, 比例) 缓存，形状变更后失效；未定义任何形状时返回 nullptr
+  std::shared_ptr<const ROIMask> compile(const cv::Size& imageSize, double scale = 1.0) const;
+
+private:
+  void setShapeLocked(ROIShape shape);
+  std::shared_ptr<const ROIMask> build(const cv::Size& imageSize, double scale) const;
+
+  using CacheKey = std::tuple<int, int, int>;  // width, height, scale * 1e4
+  static constexpr size_t MAX_CACHED_MASKS = 4;
+
+  mutable QMutex m_mutex;
+  std::vector<ROIShape> m_shapes;
+  mutable std::map<CacheKey, std::shared_ptr<const ROIMask>> m_cache;
+};
+
 #endif // ROIMANAGER_H
@@ -32,7 +32,7 @@ void DefectScorer::setPassThreshold(double threshold) {
   m_passThreshold = qBound(0.0, threshold, 100.0);
 }
 
-double DefectScorer::scoreDefect(const DefectInfo& defect) {
+double DefectScorer::scoreDefect(const DefectInfo& defect) const {
   // 基础扣分 = 严重度 * 权重 * 基础分值
   double baseDeduction = 10.0;  // 每个缺陷基础扣分
   
@@ -42,14 +42,25 @@ double DefectScorer::scoreDefect(const DefectInfo& defect) {
   
   // 面积因子（可选，基于缺陷大小）
   double areaFactor = 1.0;
-  if (defect.attributes.contains("area")) {
-    double area = defect.attributes["area"].toDouble();
+  if (defect.features.has(DefectFeatures::Area)) {
+    double area = defect.features.get(DefectFeatures::Area);
     areaFactor = std::min(2.0, 1.0 + area / 1000.0);
   }
   
   return baseDeduction * typeWeight * severityFactor * confidenceFactor * areaFactor;
 }
 
+SeverityGrade DefectScorer::gradeForScore(double totalScore) const {
+  if (totalScore >= m_minorThreshold) {
+    return SeverityGrade::OK;
+  } else if (totalScore >= m_majorThreshold) {
+    return SeverityGrade::Minor;
+  } else if (totalScore >= m_criticalThreshold) {
+    return SeverityGrade::Major;
+  }
+  return SeverityGrade::Critical;
+}
+
 ScoringResult DefectScorer::score(const std::vector<DefectInfo>& defects) {
   ScoringResult result;
   result.totalScore = 100.0;  // 满分开始
@@ -83,15 +94,7 @@ ScoringResult DefectScorer::score(const std::vector<DefectInfo>& defects) {
   result.totalScore = std::max(0.0, 100.0 - totalDeduction);
 
   // 确定等级
-  if (result.totalScore >= m_minorThreshold) {
-    result.grade = SeverityGrade::OK;
-  } else if (result.totalScore >= m_majorThreshold) {
-    result.grade = SeverityGrade::Minor;
-  } else if (result.totalScore >= m_criticalThreshold) {
-    result.grade = SeverityGrade::Major;
-  } else {
-    result.grade = SeverityGrade::Critical;
-  }
+  result.grade = gradeForScore(result.totalScore);
 
   result.gradeText = gradeToText(result.grade);
   result.isPass = result.totalScore >= m_passThreshold;
@@ -20,6 +20,7 @@
 #include "../algorithm_global.h"
 #include "../IDefectDetector.h"
 #include <QString>
+#include <QStringList>
 #include <QVariantMap>
 #include <vector>
 #include <map>
@@ -42,6 +43,29 @@ struct ALGORITHM_LIBRARY ScoringResult {
   QString summary;                // 评分摘要
 };
 
+// 致命缺陷规则（提前退出判定）：只看单个缺陷自身的类别与严重度，不依赖整帧评分
+// （单个缺陷的扣分至多约 50 分，按总分等级判定达不到 Major/Critical）
+struct CriticalDefectRule {
+  QStringList classes;        // 致命类别，出现即判定 NG
+  double minSeverity = 0.9;   // 任意类别自身严重度 [0-1] 达到此值即判定 NG（大于 1 表示不按严重度判定）
+
+  bool matches(const DefectInfo& defect) const {
+    return defect.severity >= minSeverity || classes.contains(defect.className);
+  }
+
+  // 由配置构造：classes 为逗号分隔的类别名（detection.earlyExitClasses）
+  static CriticalDefectRule fromConfig(const QString& classes, double minSeverity) {
+    CriticalDefectRule rule;
+    for (const QString& name : classes.split(',', Qt::SkipEmptyParts)) {
+      if (!name.trimmed().isEmpty()) {
+        rule.classes.push_back(name.trimmed());
+      }
+    }
+    rule.minSeverity = minSeverity;
+    return rule;
+  }
+};
+
 // 缺陷评分器
 class ALGORITHM_LIBRARY DefectScorer {
 public:
@@ -63,7 +87,10 @@ public:
   ScoringResult score(const std::vector<DefectInfo>& defects);
 
   // 计算单个缺陷的扣分
-  double scoreDefect(const DefectInfo& defect);
+  double scoreDefect(const DefectInfo& defect) const;
+
+  // 总分对应的等级
+  SeverityGrade gradeForScore(double totalScore) const;
 
   // 获取等级文本
   static QString gradeToText(SeverityGrade grade);
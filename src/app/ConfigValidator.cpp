@@ -1,11 +1,14 @@
 #include "ConfigValidator.h"
 #include "config/AppConfig.h"
 #include "common/Logger.h"
+#include "common/ThreadAffinity.h"
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
 #include <QJsonDocument>
 #include <QJsonParseError>
+#include <algorithm>
+#include <thread>
 
 QString ConfigValidator::ValidationResult::summary() const
 {
@@ -70,7 +73,7 @@ ConfigValidator::ValidationResult ConfigValidator::validateJson(const QJsonObjec
     ValidationResult result;
 
     // 检查必需的顶级键
-    QStringList requiredSections = {"camera", "detection", "ui", "database", "log"};
+    QStringList requiredSections = {"camera", "detection", "ui", "database", "log", "threading"};
     for (const QString& section : requiredSections) {
         if (!json.contains(section)) {
             result.addWarning(QString("Missing section '%1', using defaults").arg(section));
@@ -105,6 +108,7 @@ ConfigValidator::ValidationResult ConfigValidator::validate(const AppConfig& con
     ValidationResult uiResult = validateUI(config.ui);
     ValidationResult dbResult = validateDatabase(config.database);
     ValidationResult logResult = validateLog(config.log);
+    ValidationResult threadingResult = validateThreading(config.threading);
 
     // 合并所有结果
     result.errors.append(cameraResult.errors);
@@ -112,15 +116,17 @@ ConfigValidator::ValidationResult ConfigValidator::validate(const AppConfig& con
     result.errors.append(uiResult.errors);
     result.errors.append(dbResult.errors);
     result.errors.append(logResult.errors);
+    result.errors.append(threadingResult.errors);
 
     result.warnings.append(cameraResult.warnings);
     result.warnings.append(detectionResult.warnings);
     result.warnings.append(uiResult.warnings);
     result.warnings.append(dbResult.warnings);
     result.warnings.append(logResult.warnings);
+    result.warnings.append(threadingResult.warnings);
 
     result.valid = cameraResult.valid && detectionResult.valid &&
-                   uiResult.valid && dbResult.valid && logResult.valid;
+                   uiResult.valid && dbResult.valid && logResult.valid && threadingResult.valid;
     
     if (result.valid) {
         LOG_INFO("ConfigValidator: Config valid - {} warnings", result.warnings.size());
@@ -197,6 +203,65 @@ ConfigValidator::ValidationResult ConfigValidator::validateDetection(const Detec
         if (!checkRange(cfg.batchSize, 1, 32)) {
             result.addError("detection.batchSize must be between 1 and 32");
         }
+        if (!checkRange(cfg.stageQueueCapacity, 1, 64)) {
+            result.addError("detection.stageQueueCapacity must be between 1 and 64");
+        }
+        if (!checkRange(cfg.maxFramesInFlight, 1, 32)) {
+            result.addError("detection.maxFramesInFlight must be between 1 and 32");
+        }
+        if (!checkRange(cfg.lateThresholdMs, 0, 60000)) {
+            result.addError("detection.lateThresholdMs must be between 0 and 60000");
+        }
+        if (!checkRange(cfg.degradeScale, 0.1, 1.0)) {
+            result.addError("detection.degradeScale must be between 0.1 and 1.0");
+        }
+        if (!checkRange(cfg.matPoolMaxMB, 16, 8192)) {
+            result.addError("detection.matPoolMaxMB must be between 16 and 8192");
+        }
+        if (!checkRange(cfg.maxDetectDim, 0, 32768)) {
+            result.addError("detection.maxDetectDim must be between 0 and 32768");
+        }
+        if (!checkRange(cfg.tileSize, 128, 8192)) {
+            result.addError("detection.tileSize must be between 128 and 8192");
+        }
+        if (!checkRange(cfg.tileOverlap, 0, 1024)) {
+            result.addError("detection.tileOverlap must be between 0 and 1024");
+        } else if (cfg.tileOverlap * 2 >= cfg.tileSize) {
+            result.addError("detection.tileOverlap must be less than half of detection.tileSize");
+        }
+        if (!checkRange(cfg.refinePadding, 0, 512)) {
+            result.addError("detection.refinePadding must be between 0 and 512");
+        }
+        if (!checkRange(cfg.earlyExitSeverity, 0.0, 2.0)) {
+            result.addError("detection.earlyExitSeverity must be between 0.0 and 2.0 (above 1 disables the severity rule)");
+        }
+        if (!checkRange(cfg.cpuBudget, 0, 1024)) {
+            result.addError("detection.cpuBudget must be between 0 and 1024");
+        }
+        if (!checkRange(cfg.ioThreads, 1, 64)) {
+            result.addError("detection.ioThreads must be between 1 and 64");
+        }
+    }
+
+    // 验证过载策略
+    if (m_flags & ValidateEnums) {
+        QStringList validPolicies = {"block", "dropNewest", "dropOldest", "degrade"};
+        if (!checkEnum(cfg.overloadPolicy, validPolicies)) {
+            result.addError(QString("detection.overloadPolicy '%1' is invalid. Must be one of: %2")
+                                .arg(cfg.overloadPolicy, validPolicies.join(", ")));
+        }
+        QStringList validClasses = {"Scratch", "Crack", "Foreign", "Dimension"};
+        for (const QString& name : cfg.earlyExitClasses.split(',', Qt::SkipEmptyParts)) {
+            if (!checkEnum(name.trimmed(), validClasses)) {
+                result.addWarning(QString("detection.earlyExitClasses contains unknown class '%1'. Known classes: %2")
+                                      .arg(name.trimmed(), validClasses.join(", ")));
+            }
+        }
+        QStringList validStrategies = {"auto", "inter", "intra"};
+        if (!checkEnum(cfg.parallelStrategy, validStrategies)) {
+            result.addError(QString("detection.parallelStrategy '%1' is invalid. Must be one of: %2")
+                                .arg(cfg.parallelStrategy, validStrategies.join(", ")));
+        }
     }
 
     // 验证模型路径
@@ -209,6 +274,9 @@ ConfigValidator::ValidationResult ConfigValidator::validateDetection(const Detec
                 result.addWarning("detection.modelPath should be .onnx or .pt file");
             }
         }
+        if (!cfg.roiFile.isEmpty() && !QFileInfo::exists(cfg.roiFile)) {
+            result.addWarning(QString("detection.roiFile '%1' does not exist").arg(cfg.roiFile));
+        }
     }
 
     return result;
@@ -302,6 +370,72 @@ ConfigValidator::ValidationResult ConfigValidator::validateLog(const LogConfig&
     return result;
 }
 
+ConfigValidator::ValidationResult ConfigValidator::validateThreading(const ThreadingConfig& cfg) const
+{
+    ValidationResult result;
+    const QStringList validPolicies = {"default", "fifo", "rr"};
+    const QStringList validStages = {"acquire", "preprocess", "detect", "postprocess", "output"};
+
+    // 检查一组放置参数（CPU 列表格式、调度策略、优先级范围）
+    auto checkPlacement = [&](const QString& key, const QString& cpus, const QString& policy, int priority) {
+        std::vector<int> parsed;
+        if (!ThreadAffinity::parseCpuList(cpus.toStdString(), parsed)) {
+            result.addError(QString("%1 cpus '%2' is invalid, expected a list like \"0,2-5\"").arg(key, cpus));
+        } else {
+            // 按进程 CPU 集合逐个检查（taskset/cgroup 下可用 CPU 不一定从 0 开始）；集合未知时按 CPU 编号范围
+            const std::vector<int>& processCpus = ThreadAffinity::processCpus();
+            const int cpuCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            std::vector<int> unavailable;
+            for (int cpu : parsed) {
+                const bool available = processCpus.empty()
+                    ? cpu < cpuCount
+                    : std::find(processCpus.begin(), processCpus.end(), cpu) != processCpus.end();
+                if (!available) {
+                    unavailable.push_back(cpu);
+                }
+            }
+            if (!unavailable.empty()) {
+                const QString allowed = processCpus.empty()
+                    ? QString("0-%1").arg(cpuCount - 1)
+                    : QString::fromStdString(ThreadAffinity::formatCpuList(processCpus));
+                result.addWarning(QString("%1 cpus '%2' includes CPUs %3 outside the process CPU set %4")
+                                      .arg(key, cpus,
+                                           QString::fromStdString(ThreadAffinity::formatCpuList(unavailable)),
+                                           allowed));
+            }
+        }
+        if (m_flags & ValidateEnums) {
+            if (!checkEnum(policy, validPolicies)) {
+                result.addError(QString("%1 policy '%2' is invalid. Must be one of: %3")
+                                    .arg(key, policy, validPolicies.join(", ")));
+            }
+        }
+        if (m_flags & ValidateRange) {
+            if (policy == "default" && !checkRange(priority, -20, 19)) {
+                result.addError(QString("%1 priority must be a nice value between -20 and 19").arg(key));
+            } else if (policy != "default" && !checkRange(priority, 1, 99)) {
+                result.addError(QString("%1 priority must be between 1 and 99 for %2").arg(key, policy));
+            }
+        }
+    };
+
+    checkPlacement("threading.mainCpus", cfg.mainCpus, "default", 0);
+    checkPlacement("threading.pool", cfg.poolCpus, cfg.poolPolicy, cfg.poolPriority);
+
+    for (auto it = cfg.stages.cbegin(); it != cfg.stages.cend(); ++it) {
+        const QString key = QString("threading.stages.%1").arg(it.key());
+        if ((m_flags & ValidateEnums) && !checkEnum(it.key(), validStages)) {
+            result.addWarning(QString("%1 is not a pipeline stage (%2)").arg(key, validStages.join(", ")));
+            continue;
+        }
+        const QVariantMap stage = it.value().toMap();
+        checkPlacement(key, stage.value("cpus").toString(),
+                       stage.value("policy", "default").toString(), stage.value("priority", 0).toInt());
+    }
+
+    return result;
+}
+
 bool ConfigValidator::isValid(const QString& path) const
 {
     return validateFile(path).valid;
@@ -28,6 +28,7 @@ struct DetectionConfig;
 struct UIConfig;
 struct DatabaseConfig;
 struct LogConfig;
+struct ThreadingConfig;
 
 class ConfigValidator {
 public:
@@ -75,6 +76,7 @@ public:
     ValidationResult validateUI(const UIConfig& cfg) const;
     ValidationResult validateDatabase(const DatabaseConfig& cfg) const;
     ValidationResult validateLog(const LogConfig& cfg) const;
+    ValidationResult validateThreading(const ThreadingConfig& cfg) const;
 
     // 便捷方法
     bool isValid(const QString& path) const;
@@ -287,6 +287,8 @@ void FlowController::connectPipeline()
             this, &FlowController::onPipelineResult);
     connect(m_pipeline, &DetectPipeline::error,
             this, &FlowController::onPipelineError);
+    connect(m_pipeline, &DetectPipeline::frameDropped,
+            this, &FlowController::onPipelineFrameDropped);
     connect(m_pipeline, &DetectPipeline::started,
             this, &FlowController::onPipelineStarted);
     connect(m_pipeline, &DetectPipeline::stopped,
@@ -301,6 +303,8 @@ void FlowController::disconnectPipeline()
                this, &FlowController::onPipelineResult);
     disconnect(m_pipeline, &DetectPipeline::error,
                this, &FlowController::onPipelineError);
+    disconnect(m_pipeline, &DetectPipeline::frameDropped,
+               this, &FlowController::onPipelineFrameDropped);
     disconnect(m_pipeline, &DetectPipeline::started,
                this, &FlowController::onPipelineStarted);
     disconnect(m_pipeline, &DetectPipeline::stopped,
@@ -346,6 +350,14 @@ void FlowController::updateStatistics(const DetectResult& result)
         m_stats.yield = 100.0 * m_stats.okCount / m_stats.totalCount;
     }
 
+    // 过载统计
+    if (result.late) {
+        m_stats.lateCount++;
+    }
+    if (result.degraded) {
+        m_stats.degradedCount++;
+    }
+
     // 计算平均节拍
     m_cycleTimeSum += result.cycleTimeMs;
     m_stats.avgCycleTime = m_cycleTimeSum / m_stats.totalCount;
@@ -358,20 +370,29 @@ void FlowController::updateStatistics(const DetectResult& result)
     emit statisticsUpdated(m_stats);
 }
 
-void FlowController::onPipelineResult(const DetectResult& result)
+void FlowController::onPipelineResult(const DetectResultPtr& result)
 {
+    if (!result) return;
+
     // 更新统计
-    updateStatistics(result);
+    updateStatistics(*result);
 
     // 写入 PLC
     if (m_plc) {
-        writePLCResult(result);
+        writePLCResult(*result);
     }
 
-    // 转发结果
+    // 转发结果（共享同一份只读结果，不复制缺陷数据）
     emit resultReady(result);
 }
 
+void FlowController::onPipelineFrameDropped(quint64 totalDropped)
+{
+    // 未检测的零件比慢检测更严重，需要单独统计
+    m_stats.droppedCount = totalDropped;
+    emit statisticsUpdated(m_stats);
+}
+
 void FlowController::onPipelineError(const QString& module, const QString& message)
 {
     LOG_ERROR("FlowController: Pipeline error - module={}, message={}", 
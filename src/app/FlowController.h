@@ -21,10 +21,10 @@
 #include <QString>
 #include <QTimer>
 #include <memory>
+#include "Types.h"
 
 class DetectPipeline;
 class IPLCClient;
-struct DetectResult;
 
 class FlowController : public QObject {
     Q_OBJECT
@@ -74,6 +74,9 @@ public:
         int ngCount = 0;
         double yield = 100.0;       // 良率 %
         double avgCycleTime = 0.0;  // 平均节拍 ms
+        quint64 droppedCount = 0;   // 过载丢弃（未检测）数
+        int lateCount = 0;          // 超过节拍上限才出结果的数量
+        int degradedCount = 0;      // 降分辨率检测数量
         qint64 startTime = 0;
         qint64 runningTime = 0;     // 运行时间 ms
     };
@@ -97,12 +100,13 @@ signals:
     void paused();
     void resumed();
     void error(const QString& module, const QString& message);
-    void resultReady(const DetectResult& result);
+    void resultReady(const DetectResultPtr& result);  // 转发流水线的共享只读结果
     void statisticsUpdated(const Statistics& stats);
 
 private slots:
-    void onPipelineResult(const DetectResult& result);
+    void onPipelineResult(const DetectResultPtr& result);
     void onPipelineError(const QString& module, const QString& message);
+    void onPipelineFrameDropped(quint64 totalDropped);
     void onPipelineStarted();
     void onPipelineStopped();
     void onPLCPollTimeout();
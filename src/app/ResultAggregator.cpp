@@ -56,7 +56,7 @@ void ResultAggregator::addResult(int stationId, const DetectResult& result)
         m_pendingResults.clear();
         
         locker.unlock();
-        emit this->aggregated(aggregated);
+        emit this->aggregated(std::make_shared<const DetectResult>(std::move(aggregated)));
     } else if (!m_timer->isActive() && m_timeoutMs > 0) {
         // 启动超时计时器
         m_timer->start(m_timeoutMs);
@@ -117,7 +117,7 @@ void ResultAggregator::onTimeout()
     
     locker.unlock();
     emit timeout();
-    emit this->aggregated(aggregated);
+    emit this->aggregated(std::make_shared<const DetectResult>(std::move(aggregated)));
 }
 
 DetectResult ResultAggregator::aggregateInternal(const QMap<int, DetectResult>& results)
@@ -326,11 +326,6 @@ DetectResult ResultAggregator::aggregateMaxSeverity(const QMap<int, DetectResult
 
 void ResultAggregator::mergeDefects(DetectResult& target, const DetectResult& source)
 {
-    // 合并缺陷区域
-    target.regions.insert(target.regions.end(), 
-                          source.regions.begin(), 
-                          source.regions.end());
-    
     // 合并缺陷详情
     target.defects.insert(target.defects.end(),
                           source.defects.begin(),
@@ -69,7 +69,7 @@ public:
 
 signals:
   void resultReceived(int stationId);
-  void aggregated(const DetectResult& result);
+  void aggregated(const DetectResultPtr& result);  // 聚合结果以共享只读句柄发布
   void timeout();
 
 private slots:
@@ -24,9 +24,12 @@
 #include <QDir>
 #include <cstdio>
 #include <csignal>
+#include <opencv2/core/utility.hpp>
 
 #include "config/ConfigManager.h"
 #include "Logger.h"
+#include "ThreadAffinity.h"
+#include "ThreadBudget.h"
 #include "data/DatabaseManager.h"
 #include "ui/services/UserManager.h"
 #include "ui/dialogs/LoginDialog.h"
@@ -248,6 +251,28 @@ int main(int argc, char* argv[])
         }
         qDebug() << "[INIT] Config loaded";
 
+        // 线程预算与放置须在创建日志/数据库/网络线程之前设置：
+        // 先按全部可用 CPU 确定预算，再绑定主线程，其后创建的日志/数据库/网络线程继承主线程的 CPU 集合，
+        // 不占用为采集与检测预留的核心。全局线程池与检测阶段线程启动时按各自放置设置亲和性，
+        // 未指定 CPU 时恢复为进程 CPU 集合；OpenCV 工作线程无法单独放置，在绑定主线程之前创建
+        auto threadCfg = gConfig.threadingConfig();
+        ThreadPlacement poolPlacement;
+        if (!ThreadPlacement::parse(threadCfg.poolCpus.toStdString(), threadCfg.poolPolicy.toStdString(),
+                                    threadCfg.poolPriority, poolPlacement)) {
+            qWarning() << "Invalid threading.pool placement, partially applied";
+        }
+        const auto budgetCfg = gConfig.detectionConfig();
+        ThreadBudget::instance().configure(budgetCfg.cpuBudget, budgetCfg.ioThreads, poolPlacement);
+        ThreadBudget::instance().applyOpenCV();
+        cv::parallel_for_(cv::Range(0, ThreadBudget::instance().perFrameParallelism()), [](const cv::Range&) {});
+        ThreadPlacement mainPlacement;
+        ThreadPlacement::parse(threadCfg.mainCpus.toStdString(), "default", 0, mainPlacement);
+        // 日志尚未初始化，失败原因先经 qWarning 输出，日志初始化后再记录
+        const bool mainPlaced = ThreadAffinity::applyToCurrentThread(mainPlacement, "MainThread");
+        if (!mainPlaced) {
+            qWarning() << "[INIT] Failed to apply main thread placement, cpus:" << threadCfg.mainCpus;
+        }
+
         // 初始化日志
         qDebug() << "[INIT] Initializing logger...";
         auto logCfg = gConfig.logConfig();
@@ -267,6 +292,16 @@ int main(int argc, char* argv[])
         LOG_INFO("Version: {}", app.applicationVersion().toStdString());
         LOG_INFO("Config: {}", gConfig.configPath());
 
+        // 报告线程放置（配置在日志初始化之前已生效）
+        LOG_INFO("Thread budget: {} compute threads, {} I/O threads, process cpus {}, main thread {}",
+                 ThreadBudget::instance().coreBudget(), ThreadBudget::instance().ioThreads(),
+                 ThreadAffinity::formatCpuList(ThreadAffinity::processCpus()),
+                 ThreadAffinity::describeCurrentThread());
+        if (!mainPlaced) {
+            LOG_WARN("MainThread: Failed to apply placement cpus={}, running with {}",
+                     threadCfg.mainCpus.toStdString(), ThreadAffinity::describeCurrentThread());
+        }
+
         // 加载样式表
         qDebug() << "[INIT] Loading stylesheet...";
         const QString styleSheet = loadStyleSheet();
@@ -329,9 +364,33 @@ int main(int argc, char* argv[])
         DetectPipeline pipeline;
         pipeline.setImageDir(camCfg.imageDir);
         pipeline.setCaptureInterval(camCfg.captureIntervalMs);
+        auto detCfg = gConfig.detectionConfig();
+        pipeline.setPipelinedMode(detCfg.pipelined);
+        pipeline.setStageQueueCapacity(detCfg.stageQueueCapacity);
+        pipeline.setMaxFramesInFlight(detCfg.maxFramesInFlight);
+        pipeline.setOverloadPolicy(DetectPipeline::overloadPolicyFromString(detCfg.overloadPolicy));
+        pipeline.setLateThresholdMs(detCfg.lateThresholdMs);
+        pipeline.setDegradeScale(detCfg.degradeScale);
+        pipeline.setMaxDetectDim(detCfg.maxDetectDim);
+        pipeline.setTiledDetection(detCfg.tiledDetection, detCfg.tileSize, detCfg.tileOverlap);
+        pipeline.setCoarseToFine(detCfg.coarseToFine, detCfg.refinePadding);
+        pipeline.setEarlyExit(detCfg.earlyExit, detCfg.earlyExitClasses, detCfg.earlyExitSeverity);
+        pipeline.setParallelStrategy(detCfg.parallelStrategy);
+        pipeline.setMatPooling(detCfg.matPooling, detCfg.matPoolMaxMB);
+        for (auto it = threadCfg.stages.cbegin(); it != threadCfg.stages.cend(); ++it) {
+            const QVariantMap stageCfg = it.value().toMap();
+            ThreadPlacement placement;
+            ThreadPlacement::parse(stageCfg.value("cpus").toString().toStdString(),
+                                   stageCfg.value("policy", "default").toString().toStdString(),
+                                   stageCfg.value("priority", 0).toInt(), placement);
+            pipeline.setStagePlacement(it.key(), placement);
+        }
+        if (!detCfg.roiFile.isEmpty() && !pipeline.loadROI(detCfg.roiFile)) {
+            LOG_WARN("Failed to load ROI file {}, detecting full frame", detCfg.roiFile.toStdString());
+        }
         
         // 流水线心跳
-        QObject::connect(&pipeline, &DetectPipeline::resultReady, [](const DetectResult&) {
+        QObject::connect(&pipeline, &DetectPipeline::resultReady, [](const DetectResultPtr&) {
             if (g_watchdog) {
                 g_watchdog->feed("Pipeline");
             }
@@ -8,8 +8,10 @@
  * 作者：Vere
  * 创建日期：2025年12月03日
  * 摘要：环形缓冲区模板类定义
- * 描述：固定大小的环形缓冲区，支持FIFO操作，用于数据流缓存、
- *       历史记录存储等场景
+ * 描述：固定大小的类型化环形缓冲区，支持FIFO操作、满时覆盖最旧元素、
+ *       连续区段视图批量读取，用于数据流缓存、实时曲线、历史记录存储等场景；
+ *       槽位在构造时一次性分配，push/pop 不产生逐元素分配。
+ *       另提供单写多读的 seqlock 版本，读方无锁读取最近 N 个元素
  *
  * 当前版本：1.0
  */
@@ -17,28 +19,234 @@
 #ifndef CIRCULARBUFFER_H
 #define CIRCULARBUFFER_H
 
-#include <any>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// ============================================================================
+// 存储：N > 0 时为编译期容量（内嵌数组），N == 0 时为构造时指定的运行期容量
+// ============================================================================
+
+namespace circular_buffer_detail {
+
+template <typename T, std::size_t N>
+struct Storage {
+  explicit Storage(std::size_t) {}
+  T* data() { return slots.data(); }
+  const T* data() const { return slots.data(); }
+  static constexpr std::size_t capacity() { return N; }
+  std::array<T, N> slots{};
+};
+
+template <typename T>
+struct Storage<T, 0> {
+  explicit Storage(std::size_t capacity) : slots(capacity == 0 ? 1 : capacity) {}
+  T* data() { return slots.data(); }
+  const T* data() const { return slots.data(); }
+  std::size_t capacity() const { return slots.size(); }
+  std::vector<T> slots;
+};
+
+} // namespace circular_buffer_detail
+
+// ============================================================================
+// 环形缓冲区（非线程安全，与所属对象在同一线程使用）
+// ============================================================================
+
+template <typename T, std::size_t N = 0>
 class CircularBuffer {
 public:
-  explicit CircularBuffer(std::size_t capacity = 1024);
+  // 满时的处理方式
+  enum class OverflowPolicy {
+    Reject,          // 拒绝写入，push 返回 false
+    OverwriteOldest  // 覆盖最旧元素（实时曲线、滚动历史）
+  };
+
+  // 只读连续区段
+  struct Span {
+    const T* data = nullptr;
+    std::size_t size = 0;
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+  };
+
+  // N > 0 时忽略 capacity 参数
+  explicit CircularBuffer(std::size_t capacity = 1024,
+                          OverflowPolicy policy = OverflowPolicy::Reject)
+      : m_storage(capacity), m_policy(policy) {}
+
+  // 写入：满时按溢出策略拒绝或覆盖最旧元素（覆盖计入 overwritten）
+  bool push(const T& value) { return emplace(value); }
+  bool push(T&& value) { return emplace(std::move(value)); }
+
+  // 槽位已预先构造，写入为赋值，不产生新的分配（元素自身的赋值除外）
+  template <typename... Args>
+  bool emplace(Args&&... args) {
+    if (full()) {
+      if (m_policy == OverflowPolicy::Reject) {
+        return false;
+      }
+      m_tail = next(m_tail);
+      --m_size;
+      ++m_overwritten;
+    }
+    m_storage.data()[m_head] = T(std::forward<Args>(args)...);
+    m_head = next(m_head);
+    ++m_size;
+    return true;
+  }
+
+  // 取出最旧元素
+  bool pop(T& out) {
+    if (empty()) {
+      return false;
+    }
+    out = std::move(m_storage.data()[m_tail]);
+    m_tail = next(m_tail);
+    --m_size;
+    return true;
+  }
+
+  // 丢弃最旧的 count 个元素（批量读取后使用）
+  void consume(std::size_t count) {
+    count = std::min(count, m_size);
+    m_tail = (m_tail + count) % capacity();
+    m_size -= count;
+  }
+
+  // 按时间顺序访问：0 为最旧，size()-1 为最新
+  const T& operator[](std::size_t index) const { return m_storage.data()[(m_tail + index) % capacity()]; }
+  T& operator[](std::size_t index) { return m_storage.data()[(m_tail + index) % capacity()]; }
+  const T& front() const { return (*this)[0]; }
+  const T& back() const { return (*this)[m_size - 1]; }
+
+  // 按时间顺序的两个连续区段（first 为较旧部分），未回绕时 second 为空
+  std::pair<Span, Span> spans() const {
+    const T* base = m_storage.data();
+    const std::size_t firstSize = std::min(m_size, capacity() - m_tail);
+    return {Span{base + m_tail, firstSize}, Span{base, m_size - firstSize}};
+  }
+
+  // 按时间顺序复制到连续内存，返回复制数量
+  template <typename OutputIt>
+  std::size_t copyTo(OutputIt out) const {
+    const auto parts = spans();
+    out = std::copy(parts.first.begin(), parts.first.end(), out);
+    std::copy(parts.second.begin(), parts.second.end(), out);
+    return m_size;
+  }
+
+  void clear() {
+    m_head = m_tail = 0;
+    m_size = 0;
+  }
+
+  bool empty() const { return m_size == 0; }
+  bool full() const { return m_size == capacity(); }
+  std::size_t size() const { return m_size; }
+  std::size_t capacity() const { return m_storage.capacity(); }
+
+  void setOverflowPolicy(OverflowPolicy policy) { m_policy = policy; }
+  OverflowPolicy overflowPolicy() const { return m_policy; }
+
+  // 覆盖模式下被覆盖（丢弃）的元素总数
+  std::size_t overwritten() const { return m_overwritten; }
+
+private:
+  std::size_t next(std::size_t index) const { return index + 1 == capacity() ? 0 : index + 1; }
+
+  circular_buffer_detail::Storage<T, N> m_storage;
+  OverflowPolicy m_policy;
+  std::size_t m_head = 0;   // 下一个写入位置
+  std::size_t m_tail = 0;   // 最旧元素位置
+  std::size_t m_size = 0;
+  std::size_t m_overwritten = 0;
+};
+
+// ============================================================================
+// 单写多读 seqlock 环形缓冲区
+// 写方始终覆盖最旧元素且从不等待读方；读方无锁复制最近的元素，
+// 以槽位戳（元素序号 + 1，写入期间为 0）校验复制期间未被覆盖。
+// 要求 T 可平凡复制（读方可能读到写了一半的数据，校验失败后丢弃）
+// ============================================================================
+
+template <typename T, std::size_t N>
+class SeqlockCircularBuffer {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqlockCircularBuffer requires a trivially copyable T");
+  static_assert(N > 0, "SeqlockCircularBuffer requires a compile-time capacity");
+
+public:
+  SeqlockCircularBuffer() {
+    for (auto& slot : m_slots) {
+      slot.stamp.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  SeqlockCircularBuffer(const SeqlockCircularBuffer&) = delete;
+  SeqlockCircularBuffer& operator=(const SeqlockCircularBuffer&) = delete;
+
+  // 写入（只能从一个线程调用）
+  void push(const T& value) {
+    const std::size_t pos = m_written.load(std::memory_order_relaxed);
+    Slot& slot = m_slots[pos % N];
+    slot.stamp.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot.value, &value, sizeof(T));
+    slot.stamp.store(pos + 1, std::memory_order_release);
+    m_written.store(pos + 1, std::memory_order_release);
+  }
 
-  bool push(const std::any &value);
-  bool pop(std::any &out);
+  // 读取最近至多 count 个元素，按时间顺序写入 out，返回实际数量（可从任意线程调用）
+  // 较旧的元素在复制期间被写方覆盖时，只返回其后仍有效的部分
+  std::size_t readLatest(T* out, std::size_t count) const {
+    const std::size_t written = m_written.load(std::memory_order_acquire);
+    count = std::min({count, written, N});
 
-  void clear();
-  bool empty() const;
-  bool full() const;
-  std::size_t size() const;
-  std::size_t capacity() const;
+    // 从最新向前复制，遇到已被覆盖的槽位即停止，保证结果连续
+    std::size_t copied = 0;
+    for (; copied < count; ++copied) {
+      const std::size_t pos = written - 1 - copied;
+      const Slot& slot = m_slots[pos % N];
+      if (slot.stamp.load(std::memory_order_acquire) != pos + 1) {
+        break;
+      }
+      T value;
+      std::memcpy(&value, &slot.value, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.stamp.load(std::memory_order_relaxed) != pos + 1) {
+        break;
+      }
+      out[count - 1 - copied] = value;
+    }
+
+    if (copied < count) {
+      std::move(out + (count - copied), out + count, out);
+    }
+    return copied;
+  }
+
+  // 读取最新元素
+  bool latest(T& out) const { return readLatest(&out, 1) == 1; }
+
+  // 累计写入的元素数
+  std::size_t written() const { return m_written.load(std::memory_order_acquire); }
+  static constexpr std::size_t capacity() { return N; }
 
 private:
-  std::vector<std::any> m_storage;
-  std::size_t m_head = 0;
-  std::size_t m_tail = 0;
-  bool m_full = false;
+  struct Slot {
+    std::atomic<std::size_t> stamp;
+    T value;
+  };
+
+  std::array<Slot, N> m_slots;
+  alignas(64) std::atomic<std::size_t> m_written{0};
 };
 
 #endif // CIRCULARBUFFER_H
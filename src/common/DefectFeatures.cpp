@@ -0,0 +1,120 @@
+#include "DefectFeatures.h"
+
+namespace {
+
+struct FieldInfo {
+  const char* name;
+  int scalePower;   // 坐标缩放时的幂次：0 不变，1 长度，2 面积
+  bool integral;    // 导出为 int
+};
+
+constexpr FieldInfo FIELD_INFO[DefectFeatures::FieldCount] = {
+  {"area",           2, false},
+  {"length",         1, false},
+  {"width",          1, false},
+  {"angle",          0, false},
+  {"nfa",            0, false},
+  {"perimeter",      1, false},
+  {"complexity",     0, false},
+  {"skeletonLength", 1, false},
+  {"branchPoints",   0, true},
+  {"endPoints",      0, true},
+  {"measuredWidth",  1, false},
+  {"aspectRatio",    0, false},
+  {"circularity",    0, false},
+  {"solidity",       0, false},
+  {"rectangularity", 0, false},
+  {"contrast",       0, false},
+  {"meanBrightness", 0, false},
+  {"textureAnomaly", 0, false},
+  {"targetValue",    0, false},
+  {"actualValue",    0, false},
+  {"deviation",      0, false},
+  {"tolerance",      0, false},
+  {"seamMerged",     0, true},
+};
+
+} // namespace
+
+void DefectFeatures::mergeMissing(const DefectFeatures& other) {
+  const std::uint32_t missing = other.m_mask & ~m_mask;
+  for (int i = 0; i < FieldCount; ++i) {
+    if (missing & bit(static_cast<Field>(i))) {
+      m_values[i] = other.m_values[i];
+    }
+  }
+  m_mask |= missing;
+
+  if (method == DetectionMethod::None) {
+    method = other.method;
+  }
+  if (measureType == MeasureType::None) {
+    measureType = other.measureType;
+    subpixelPrecision = other.subpixelPrecision;
+  }
+}
+
+void DefectFeatures::scale(double factor) {
+  for (int i = 0; i < FieldCount; ++i) {
+    if (!has(static_cast<Field>(i))) {
+      continue;
+    }
+    if (FIELD_INFO[i].scalePower == 1) {
+      m_values[i] *= factor;
+    } else if (FIELD_INFO[i].scalePower == 2) {
+      m_values[i] *= factor * factor;
+    }
+  }
+}
+
+QVariantMap DefectFeatures::toVariantMap() const {
+  QVariantMap map;
+  for (int i = 0; i < FieldCount; ++i) {
+    if (!has(static_cast<Field>(i))) {
+      continue;
+    }
+    if (FIELD_INFO[i].integral) {
+      map.insert(FIELD_INFO[i].name, static_cast<int>(m_values[i]));
+    } else {
+      map.insert(FIELD_INFO[i].name, m_values[i]);
+    }
+  }
+  if (method != DetectionMethod::None) {
+    map.insert("method", methodName(method));
+  }
+  if (measureType != MeasureType::None) {
+    map.insert("measureType", measureTypeName(measureType));
+    if (measureType != MeasureType::Circularity) {
+      map.insert("subpixelPrecision", subpixelPrecision);
+    }
+  }
+  return map;
+}
+
+const char* DefectFeatures::fieldName(Field field) {
+  return field < FieldCount ? FIELD_INFO[field].name : "";
+}
+
+const char* DefectFeatures::methodName(DetectionMethod method) {
+  switch (method) {
+    case DetectionMethod::LSD:        return "LSD";
+    case DetectionMethod::Hough:      return "Hough";
+    case DetectionMethod::Contour:    return "contour";
+    case DetectionMethod::Skeleton:   return "skeleton";
+    case DetectionMethod::LBP:        return "LBP";
+    case DetectionMethod::Color:      return "color";
+    case DetectionMethod::Morphology: return "morphology";
+    case DetectionMethod::None:       break;
+  }
+  return "";
+}
+
+const char* DefectFeatures::measureTypeName(MeasureType type) {
+  switch (type) {
+    case MeasureType::Width:       return "width";
+    case MeasureType::Height:      return "height";
+    case MeasureType::Circularity: return "circularity";
+    case MeasureType::None:        break;
+  }
+  return "";
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * DefectFeatures.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：缺陷类型化特征
+ * 描述：以定长数组 + 有效位掩码保存各类缺陷的几何/纹理/尺寸特征，
+ *       复制与合并不产生堆分配；仅在 UI 显示与 JSON 导出时按需转换为 QVariantMap
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef DEFECTFEATURES_H
+#define DEFECTFEATURES_H
+
+#include "common_global.h"
+#include <QVariantMap>
+#include <array>
+#include <cstdint>
+
+// 检测方法
+enum class DetectionMethod : std::uint8_t {
+  None,
+  LSD,         // 划痕：LSD 线段
+  Hough,       // 划痕：概率 Hough
+  Contour,     // 划痕/裂纹：轮廓拟合
+  Skeleton,    // 裂纹：骨架分析
+  LBP,         // 异物：LBP 纹理异常
+  Color,       // 异物：颜色异常
+  Morphology   // 异物：形态学
+};
+
+// 尺寸测量类型
+enum class MeasureType : std::uint8_t {
+  None,
+  Width,
+  Height,
+  Circularity
+};
+
+class COMMON_LIBRARY DefectFeatures {
+public:
+  // 特征字段，顺序与 QVariantMap 键名表一致
+  enum Field : std::uint8_t {
+    Area,
+    Length,
+    Width,
+    Angle,
+    Nfa,
+    Perimeter,
+    Complexity,
+    SkeletonLength,
+    BranchPoints,
+    EndPoints,
+    MeasuredWidth,
+    AspectRatio,
+    Circularity,
+    Solidity,
+    Rectangularity,
+    Contrast,
+    MeanBrightness,
+    TextureAnomaly,
+    TargetValue,
+    ActualValue,
+    Deviation,
+    Tolerance,
+    SeamMerged,
+    FieldCount
+  };
+
+  DetectionMethod method = DetectionMethod::None;
+  MeasureType measureType = MeasureType::None;
+  bool subpixelPrecision = false;   // 仅宽度/高度测量时导出
+
+  void set(Field field, double value) {
+    m_values[field] = value;
+    m_mask |= bit(field);
+  }
+  bool has(Field field) const { return (m_mask & bit(field)) != 0; }
+  double get(Field field, double defaultValue = 0.0) const {
+    return has(field) ? m_values[field] : defaultValue;
+  }
+  void clear(Field field) { m_mask &= ~bit(field); }
+  bool empty() const { return m_mask == 0 && method == DetectionMethod::None && measureType == MeasureType::None; }
+
+  // 补齐 other 中有而本对象缺失的特征（合并缺陷时使用，已有值优先）
+  void mergeMissing(const DefectFeatures& other);
+
+  // 坐标缩放：长度类特征乘以 factor，面积乘以 factor²
+  void scale(double factor);
+
+  // 转换为与旧版 attributes 相同键名的 QVariantMap（仅用于 UI 与导出）
+  QVariantMap toVariantMap() const;
+
+  static const char* fieldName(Field field);
+  static const char* methodName(DetectionMethod method);
+  static const char* measureTypeName(MeasureType type);
+
+private:
+  static constexpr std::uint32_t bit(Field field) { return std::uint32_t(1) << field; }
+
+  std::array<double, FieldCount> m_values{};
+  std::uint32_t m_mask = 0;
+};
+
+#endif // DEFECTFEATURES_H
@@ -0,0 +1,140 @@
+#include "FramePool.h"
+
+// ============================================================================
+// FrameBuffer
+// ============================================================================
+
+FrameBuffer::FrameBuffer(const cv::Mat& mat)
+    : m_mat(std::make_shared<cv::Mat>(mat)), m_pooled(false) {}
+
+// ============================================================================
+// FramePool
+// ============================================================================
+
+struct FramePool::State {
+    using Key = std::tuple<int, int, int>;  // rows, cols, type
+
+    mutable std::mutex mutex;
+    std::map<Key, std::vector<std::unique_ptr<cv::Mat>>> freeLists;
+    size_t maxFreePerShape = 8;
+    Stats stats;
+
+    static size_t bytesOf(const cv::Mat& mat) {
+        return mat.total() * mat.elemSize();
+    }
+
+    void release(cv::Mat* raw) {
+        std::unique_ptr<cv::Mat> mat(raw);
+
+        // 仍有外部 cv::Mat 引用同一块内存时不能复用，否则会覆盖对方数据
+        const bool reusable = !mat->empty() && mat->isContinuous() &&
+                              mat->data == mat->datastart &&
+                              mat->u != nullptr && mat->u->refcount == 1;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stats.outstanding > 0) {
+            stats.outstanding--;
+        }
+        if (reusable) {
+            auto& list = freeLists[Key(mat->rows, mat->cols, mat->type())];
+            if (list.size() < maxFreePerShape) {
+                stats.pooledBytes += bytesOf(*mat);
+                stats.pooled++;
+                stats.returned++;
+                list.push_back(std::move(mat));
+                return;
+            }
+        }
+        stats.discarded++;
+    }
+};
+
+FramePool::FramePool(size_t maxFreePerShape)
+    : m_state(std::make_shared<State>()) {
+    m_state->maxFreePerShape = maxFreePerShape;
+}
+
+FramePool::~FramePool() {
+    // 未归还的句柄持有 weak_ptr，池销毁后由句柄自行释放内存
+    m_state.reset();
+}
+
+FrameBuffer FramePool::acquire(int rows, int cols, int type) {
+    std::unique_ptr<cv::Mat> mat;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        auto it = m_state->freeLists.find(State::Key(rows, cols, type));
+        if (it != m_state->freeLists.end() && !it->second.empty()) {
+            mat = std::move(it->second.back());
+            it->second.pop_back();
+            m_state->stats.pooledBytes -= State::bytesOf(*mat);
+            m_state->stats.pooled--;
+            m_state->stats.hits++;
+        } else {
+            m_state->stats.misses++;
+        }
+        m_state->stats.outstanding++;
+    }
+
+    if (!mat) {
+        mat = std::make_unique<cv::Mat>(rows, cols, type);
+    }
+
+    std::weak_ptr<State> weak = m_state;
+    std::shared_ptr<cv::Mat> handle(mat.release(), [weak](cv::Mat* m) {
+        if (auto state = weak.lock()) {
+            state->release(m);
+        } else {
+            delete m;
+        }
+    });
+    return FrameBuffer(std::move(handle), true);
+}
+
+void FramePool::reserve(const cv::Size& size, int type, size_t count) {
+    std::vector<std::unique_ptr<cv::Mat>> fresh;
+    fresh.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        fresh.push_back(std::make_unique<cv::Mat>(size.height, size.width, type));
+    }
+
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    auto& list = m_state->freeLists[State::Key(size.height, size.width, type)];
+    for (auto& mat : fresh) {
+        if (list.size() >= m_state->maxFreePerShape) {
+            break;
+        }
+        m_state->stats.pooledBytes += State::bytesOf(*mat);
+        m_state->stats.pooled++;
+        list.push_back(std::move(mat));
+    }
+}
+
+void FramePool::clear() {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->freeLists.clear();
+    m_state->stats.pooled = 0;
+    m_state->stats.pooledBytes = 0;
+}
+
+void FramePool::setMaxFreePerShape(size_t count) {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->maxFreePerShape = count;
+    for (auto& [key, list] : m_state->freeLists) {
+        while (list.size() > count) {
+            m_state->stats.pooledBytes -= State::bytesOf(*list.back());
+            m_state->stats.pooled--;
+            list.pop_back();
+        }
+    }
+}
+
+FramePool::Stats FramePool::stats() const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->stats;
+}
+
+FramePool& globalFramePool() {
+    static FramePool pool(8);
+    return pool;
+}
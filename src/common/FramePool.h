@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * FramePool.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：帧缓冲池
+ * 描述：按图像尺寸/类型分组缓存固定大小的 cv::Mat 缓冲块，
+ *       通过引用计数句柄借出，最后一个句柄释放时自动归还，
+ *       消除采集到检测链路上逐帧的大块内存分配与缺页
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include "common_global.h"
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+// ============================================================================
+// 帧缓冲句柄 - 引用计数，最后一个引用释放时归还所属缓冲池
+// ============================================================================
+
+class COMMON_LIBRARY FrameBuffer {
+public:
+    FrameBuffer() = default;
+
+    // 包装普通 cv::Mat（不属于任何缓冲池，不拷贝数据）
+    explicit FrameBuffer(const cv::Mat& mat);
+
+    // 空句柄（默认构造）不可调用 mat()
+    cv::Mat& mat() { return *m_mat; }
+    const cv::Mat& mat() const { return *m_mat; }
+
+    bool empty() const { return !m_mat || m_mat->empty(); }
+    bool isPooled() const { return m_pooled; }
+    explicit operator bool() const { return !empty(); }
+
+    // 提前释放引用
+    void reset() { m_mat.reset(); m_pooled = false; }
+
+private:
+    friend class FramePool;
+    FrameBuffer(std::shared_ptr<cv::Mat> mat, bool pooled)
+        : m_mat(std::move(mat)), m_pooled(pooled) {}
+
+    std::shared_ptr<cv::Mat> m_mat;
+    bool m_pooled = false;
+};
+
+// ============================================================================
+// 帧缓冲池 - 线程安全
+// 注意：向缓冲写入时应写入 buffer.mat() 本身（如 cv::resize(src, buf.mat(), ...)），
+// 尺寸/类型一致时 OpenCV 会复用已有内存；归还时若仍有外部 cv::Mat 引用该内存，
+// 则该缓冲块不再复用，避免数据被覆盖
+// ============================================================================
+
+class COMMON_LIBRARY FramePool {
+public:
+    // 统计信息
+    struct Stats {
+        size_t hits = 0;            // 命中缓存次数
+        size_t misses = 0;          // 新分配次数
+        size_t returned = 0;        // 归还入池次数
+        size_t discarded = 0;       // 因池满或仍被引用而丢弃的次数
+        size_t outstanding = 0;     // 当前借出数量
+        size_t pooled = 0;          // 池中空闲缓冲块数量
+        size_t pooledBytes = 0;     // 池中空闲缓冲块占用字节
+    };
+
+    // maxFreePerShape: 每种尺寸/类型最多缓存的空闲缓冲块数
+    explicit FramePool(size_t maxFreePerShape = 8);
+    ~FramePool();
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // 借出指定尺寸/类型的缓冲（内容未初始化）
+    FrameBuffer acquire(int rows, int cols, int type);
+    FrameBuffer acquire(const cv::Size& size, int type) {
+        return acquire(size.height, size.width, type);
+    }
+
+    // 预分配缓冲块，避免产线启动后首批帧的分配抖动
+    void reserve(const cv::Size& size, int type, size_t count);
+
+    // 释放所有空闲缓冲块
+    void clear();
+
+    void setMaxFreePerShape(size_t count);
+    Stats stats() const;
+
+private:
+    struct State;
+    std::shared_ptr<State> m_state;
+};
+
+// 全局帧缓冲池
+COMMON_LIBRARY FramePool& globalFramePool();
+
+#endif // FRAMEPOOL_H
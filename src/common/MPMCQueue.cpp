@@ -0,0 +1,8 @@
+// MPMCQueue 是模板类，实现在头文件中
+// 此文件仅用于保持项目文件结构一致性
+
+#include "MPMCQueue.h"
+
+// 显式实例化常用类型（可选，用于加速编译）
+// template class MPMCQueue<int>;
+// template class BlockingMPMCQueue<int>;
@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * MPMCQueue.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：多生产者多消费者有界无锁队列
+ * 描述：基于 Vyukov 序号环形缓冲区的无锁队列模板类，每个槽位带序号并按缓存行对齐，
+ *       适用于多个检测线程/相机/模块向同一消费方汇聚数据的场景
+ *       （如 DetectPipeline 各工作线程完成的帧汇聚到 GUI 线程）；
+ *       另提供带条件变量的阻塞式封装。竞争基准见 tests/performance/bench_mpmc_queue
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef MPMCQUEUE_H
+#define MPMCQUEUE_H
+
+#include "common_global.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// ============================================================================
+// 无锁多生产者多消费者队列 (Lock-Free MPMC Queue)
+// 每个槽位的序号表示其状态：序号 == 位置 可写，序号 == 位置 + 1 可读，
+// 生产者/消费者各自以 CAS 抢占位置，抢到后独占该槽位，无需加锁
+// ============================================================================
+
+template <typename T>
+class MPMCQueue {
+public:
+    // 容量向上取整为 2 的幂（至少为 2）
+    explicit MPMCQueue(size_t capacity);
+    ~MPMCQueue();
+
+    // 禁止拷贝和移动
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+    MPMCQueue(MPMCQueue&&) = delete;
+    MPMCQueue& operator=(MPMCQueue&&) = delete;
+
+    // 生产者接口 (可从任意线程调用)，队列满时返回 false
+    bool push(const T& value);
+    bool push(T&& value);
+
+    template <typename... Args>
+    bool emplace(Args&&... args);
+
+    // 消费者接口 (可从任意线程调用)，队列空时返回 false
+    bool pop(T& value);
+    std::optional<T> pop();
+    bool tryPop(T& value);
+
+    // 状态查询 (并发访问时为近似值)
+    bool empty() const;
+    bool full() const;
+    size_t size() const;
+    size_t capacity() const { return m_capacity; }
+
+    // 清空队列 (只能在没有并发访问时调用)
+    void clear();
+
+private:
+    static constexpr size_t CacheLineSize = 64;
+
+    // 槽位独占缓存行，相邻槽位的生产者/消费者互不干扰
+    struct alignas(CacheLineSize) Cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T* value() { return std::launder(reinterpret_cast<T*>(&storage)); }
+    };
+
+    Cell* m_cells;
+    size_t m_capacity;
+    size_t m_mask;
+
+    // 读写位置各占一个缓存行，避免伪共享
+    alignas(CacheLineSize) std::atomic<size_t> m_enqueuePos{0};
+    alignas(CacheLineSize) std::atomic<size_t> m_dequeuePos{0};
+};
+
+// ============================================================================
+// 实现
+// ============================================================================
+
+template <typename T>
+MPMCQueue<T>::MPMCQueue(size_t capacity) {
+    m_capacity = 2;
+    while (m_capacity < capacity) {
+        m_capacity <<= 1;
+    }
+    m_mask = m_capacity - 1;
+
+    // 按缓存行对齐分配（operator new 默认对齐不保证 64 字节）
+    m_cells = static_cast<Cell*>(::operator new(m_capacity * sizeof(Cell), std::align_val_t(alignof(Cell))));
+    for (size_t i = 0; i < m_capacity; ++i) {
+        new (&m_cells[i]) Cell;
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+MPMCQueue<T>::~MPMCQueue() {
+    clear();
+    ::operator delete(m_cells, std::align_val_t(alignof(Cell)));
+}
+
+template <typename T>
+bool MPMCQueue<T>::push(const T& value) {
+    return emplace(value);
+}
+
+template <typename T>
+bool MPMCQueue<T>::push(T&& value) {
+    return emplace(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+bool MPMCQueue<T>::emplace(Args&&... args) {
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &m_cells[pos & m_mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            // 槽位可写，抢占该位置；失败时 pos 被更新为最新位置后重试
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 槽位仍保存上一轮未取走的元素：队列满
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    new (&cell->storage) T(std::forward<Args>(args)...);
+    // 发布写入：序号推进为 pos + 1，消费者可读
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool MPMCQueue<T>::pop(T& value) {
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &m_cells[pos & m_mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 槽位尚未写入：队列空
+            return false;
+        } else {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    T* slot = cell->value();
+    value = std::move(*slot);
+    slot->~T();
+    // 释放槽位：序号推进一整轮，供下一轮生产者写入
+    cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+std::optional<T> MPMCQueue<T>::pop() {
+    T value;
+    if (pop(value)) {
+        return std::move(value);
+    }
+    return std::nullopt;
+}
+
+template <typename T>
+bool MPMCQueue<T>::tryPop(T& value) {
+    return pop(value);
+}
+
+template <typename T>
+bool MPMCQueue<T>::empty() const {
+    return size() == 0;
+}
+
+template <typename T>
+bool MPMCQueue<T>::full() const {
+    return size() >= m_capacity;
+}
+
+template <typename T>
+size_t MPMCQueue<T>::size() const {
+    const size_t dequeuePos = m_dequeuePos.load(std::memory_order_acquire);
+    const size_t enqueuePos = m_enqueuePos.load(std::memory_order_acquire);
+    // 两次读取之间其他线程可能推进了位置，结果限制在 [0, capacity]
+    if (enqueuePos <= dequeuePos) {
+        return 0;
+    }
+    const size_t count = enqueuePos - dequeuePos;
+    return count > m_capacity ? m_capacity : count;
+}
+
+template <typename T>
+void MPMCQueue<T>::clear() {
+    T value;
+    while (pop(value)) {
+        // 持续弹出直到队列为空
+    }
+}
+
+// ============================================================================
+// 阻塞式 MPMC 队列 (带条件变量)
+// 入队/出队走无锁快速路径，仅在有线程等待时才经互斥锁通知，
+// 生产者与消费者之间不会因锁而串行化
+// ============================================================================
+
+template <typename T>
+class BlockingMPMCQueue {
+public:
+    explicit BlockingMPMCQueue(size_t capacity);
+
+    // 生产者接口 (可从任意线程调用)，队列停止后丢弃元素
+    void push(const T& value);
+    void push(T&& value);
+    bool tryPush(const T& value);
+    bool tryPush(T&& value);
+
+    // 消费者接口 (可从任意线程调用)
+    T pop();
+    bool tryPop(T& value);
+    bool tryPopFor(T& value, std::chrono::milliseconds timeout);
+
+    // 停止队列 (解除所有阻塞)
+    void stop();
+    bool isStopped() const { return m_stopped.load(); }
+
+    size_t size() const { return m_queue.size(); }
+    bool empty() const { return m_queue.empty(); }
+    size_t capacity() const { return m_queue.capacity(); }
+
+private:
+    template <typename U>
+    void pushBlocking(U&& value);
+
+    // 唤醒等待方：先加锁再通知，保证等待方不是处于“已检查条件、尚未进入等待”的窗口
+    void notify(std::atomic<size_t>& waiting, std::condition_variable& cv);
+
+    MPMCQueue<T> m_queue;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cvNotEmpty;
+    std::condition_variable m_cvNotFull;
+    std::atomic<size_t> m_waitingConsumers{0};
+    std::atomic<size_t> m_waitingProducers{0};
+    std::atomic<bool> m_stopped{false};
+};
+
+template <typename T>
+BlockingMPMCQueue<T>::BlockingMPMCQueue(size_t capacity)
+    : m_queue(capacity) {}
+
+template <typename T>
+void BlockingMPMCQueue<T>::notify(std::atomic<size_t>& waiting, std::condition_variable& cv) {
+    // 与等待方的 fetch_add 构成 Dekker 式配对：
+    // 要么本线程看到等待计数，要么等待方在检查条件时看到本次入队/出队
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_relaxed) > 0) {
+        { std::lock_guard<std::mutex> lock(m_mutex); }
+        cv.notify_one();
+    }
+}
+
+template <typename T>
+template <typename U>
+void BlockingMPMCQueue<T>::pushBlocking(U&& value) {
+    if (m_queue.push(std::forward<U>(value))) {
+        notify(m_waitingConsumers, m_cvNotEmpty);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_waitingProducers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool pushed = false;
+    m_cvNotFull.wait(lock, [&] {
+        return m_stopped.load() || (pushed = m_queue.push(std::forward<U>(value)));
+    });
+    m_waitingProducers.fetch_sub(1);
+    lock.unlock();
+
+    if (pushed) {
+        notify(m_waitingConsumers, m_cvNotEmpty);
+    }
+}
+
+template <typename T>
+void BlockingMPMCQueue<T>::push(const T& value) {
+    pushBlocking(value);
+}
+
+template <typename T>
+void BlockingMPMCQueue<T>::push(T&& value) {
+    pushBlocking(std::move(value));
+}
+
+template <typename T>
+bool BlockingMPMCQueue<T>::tryPush(const T& value) {
+    if (m_queue.push(value)) {
+        notify(m_waitingConsumers, m_cvNotEmpty);
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+bool BlockingMPMCQueue<T>::tryPush(T&& value) {
+    if (m_queue.push(std::move(value))) {
+        notify(m_waitingConsumers, m_cvNotEmpty);
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+T BlockingMPMCQueue<T>::pop() {
+    T value;
+    if (m_queue.pop(value)) {
+        notify(m_waitingProducers, m_cvNotFull);
+        return value;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_waitingConsumers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool popped = false;
+    m_cvNotEmpty.wait(lock, [&] {
+        return (popped = m_queue.pop(value)) || m_stopped.load();
+    });
+    m_waitingConsumers.fetch_sub(1);
+    lock.unlock();
+
+    if (!popped) {
+        throw std::runtime_error("Queue stopped");
+    }
+    notify(m_waitingProducers, m_cvNotFull);
+    return value;
+}
+
+template <typename T>
+bool BlockingMPMCQueue<T>::tryPop(T& value) {
+    if (m_queue.pop(value)) {
+        notify(m_waitingProducers, m_cvNotFull);
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+bool BlockingMPMCQueue<T>::tryPopFor(T& value, std::chrono::milliseconds timeout) {
+    if (tryPop(value)) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_waitingConsumers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool popped = false;
+    m_cvNotEmpty.wait_for(lock, timeout, [&] {
+        return (popped = m_queue.pop(value)) || m_stopped.load();
+    });
+    m_waitingConsumers.fetch_sub(1);
+    lock.unlock();
+
+    if (popped) {
+        notify(m_waitingProducers, m_cvNotFull);
+    }
+    return popped;
+}
+
+template <typename T>
+void BlockingMPMCQueue<T>::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopped.store(true);
+    }
+    m_cvNotEmpty.notify_all();
+    m_cvNotFull.notify_all();
+}
+
+#endif // MPMCQUEUE_H
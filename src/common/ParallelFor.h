@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * ParallelFor.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：基于全局线程池的数据并行循环
+ * 描述：检测器内部的数据并行（多尺度、多方向、按行分条）提交到全局工作窃取线程池，
+ *       不依赖进程级的 OpenCV 线程数设置：图节点/分块并发执行时，其余块由空闲工作线程
+ *       窃取执行，工作线程数固定为核数预算，嵌套并行不会超额订阅，也不会退化为串行
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include "PooledMatAllocator.h"
+#include "ThreadBudget.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+// ============================================================================
+// 按块并行执行 [begin, end)：body(start, end) 处理一个连续子区间
+// 块数不超过单帧可用并行度；调用线程执行首块并协助执行其余块，返回前全部完成。
+// 区间长度不超过 1 或线程池未运行时在当前线程直接执行；子任务沿用调用线程的
+// cv::Mat 池化设置。body 被多个线程同时调用，只能写入各自子区间对应的数据
+// ============================================================================
+
+template <typename Body>
+void parallelFor(int begin, int end, Body&& body) {
+    const int count = end - begin;
+    if (count <= 0) {
+        return;
+    }
+
+    ThreadPool& pool = globalThreadPool();
+    const int chunks = std::min(count, ThreadBudget::instance().perFrameParallelism());
+    if (chunks <= 1 || !pool.isRunning()) {
+        body(begin, end);
+        return;
+    }
+
+    auto bound = [begin, count, chunks](int chunk) {
+        return begin + static_cast<int>(static_cast<long long>(count) * chunk / chunks);
+    };
+    const bool matPooling = PooledMatAllocator::isThreadEnabled();
+    TaskGroup group(pool);
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        const int start = bound(chunk);
+        const int stop = bound(chunk + 1);
+        group.run([&body, start, stop, matPooling] {
+            ScopedMatPooling pooling(matPooling);
+            body(start, stop);
+        });
+    }
+    body(begin, bound(1));
+    group.wait();
+}
+
+#endif // PARALLELFOR_H
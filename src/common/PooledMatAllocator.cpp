@@ -0,0 +1,233 @@
+#include "PooledMatAllocator.h"
+#include <algorithm>
+
+namespace {
+
+thread_local bool t_poolingEnabled = false;
+
+// 计数只用于统计，不参与同步
+constexpr auto RELAXED = std::memory_order_relaxed;
+
+void updatePeak(std::atomic<size_t>& peak, size_t value) {
+    size_t current = peak.load(RELAXED);
+    while (value > current && !peak.compare_exchange_weak(current, value, RELAXED)) {
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// PooledMatAllocator
+// ============================================================================
+
+PooledMatAllocator::PooledMatAllocator(size_t maxPooledBytes)
+    : m_maxPooledBytes(maxPooledBytes) {}
+
+PooledMatAllocator::~PooledMatAllocator() {
+    // 借出中的块仍指向本分配器，实例必须比经它分配的 cv::Mat 存活更久
+    clear();
+}
+
+size_t PooledMatAllocator::sizeClass(size_t bytes) {
+    if (bytes < MIN_POOLED_BYTES) {
+        return bytes;
+    }
+    // 最高位所在区间再分 4 级，向上取整
+    size_t top = 1;
+    while ((top << 1) <= bytes) {
+        top <<= 1;
+    }
+    const size_t step = top >> 2;
+    return (bytes + step - 1) / step * step;
+}
+
+int PooledMatAllocator::classIndex(size_t blockSize) {
+    // blockSize 已按 sizeClass 取整：2^bit + k * 2^(bit-2)，k = 0..3
+    int bit = MIN_POOLED_SHIFT;
+    while (bit < 63 && (size_t(2) << bit) <= blockSize) {
+        ++bit;
+    }
+    const size_t top = size_t(1) << bit;
+    return (bit - MIN_POOLED_SHIFT) * 4 + static_cast<int>((blockSize - top) / (top >> 2));
+}
+
+size_t PooledMatAllocator::classBytes(int index) {
+    const size_t top = size_t(1) << (MIN_POOLED_SHIFT + index / 4);
+    return top + static_cast<size_t>(index % 4) * (top >> 2);
+}
+
+cv::UMatData* PooledMatAllocator::allocate(int dims, const int* sizes, int type, void* data0,
+                                           size_t* step, cv::AccessFlag flags,
+                                           cv::UMatUsageFlags usageFlags) const {
+    // 外部数据与未启用池化的线程走 OpenCV 标准分配器，其释放也由标准分配器负责
+    if (data0 || !t_poolingEnabled) {
+        return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data0, step, flags, usageFlags);
+    }
+
+    // 步长计算与标准分配器一致（连续存储）
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; --i) {
+        if (step) {
+            step[i] = total;
+        }
+        total *= static_cast<size_t>(sizes[i]);
+    }
+
+    const size_t blockSize = sizeClass(total);
+    m_allocations.fetch_add(1, RELAXED);
+    m_bytesAllocated.fetch_add(blockSize, RELAXED);
+    updatePeak(m_peakBytesInUse, m_bytesInUse.fetch_add(blockSize, RELAXED) + blockSize);
+
+    // 小块只计数不加锁；池化尺寸仅锁住对应尺寸级的空闲链表
+    void* block = nullptr;
+    if (total < MIN_POOLED_BYTES) {
+        m_smallAllocations.fetch_add(1, RELAXED);
+    } else {
+        FreeList& list = m_freeLists[classIndex(blockSize)];
+        {
+            std::lock_guard<std::mutex> lock(list.mutex);
+            if (!list.blocks.empty()) {
+                block = list.blocks.back();
+                list.blocks.pop_back();
+                m_pooledBlocks.fetch_sub(1, RELAXED);
+                m_pooledBytes.fetch_sub(blockSize, RELAXED);
+            }
+        }
+        (block ? m_hits : m_misses).fetch_add(1, RELAXED);
+    }
+
+    if (!block) {
+        try {
+            block = cv::fastMalloc(blockSize);
+        } catch (...) {
+            m_bytesInUse.fetch_sub(blockSize, RELAXED);
+            throw;
+        }
+    }
+
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = static_cast<uchar*>(block);
+    u->size = total;
+    return u;
+}
+
+bool PooledMatAllocator::allocate(cv::UMatData* data, cv::AccessFlag /*accessFlags*/,
+                                  cv::UMatUsageFlags /*usageFlags*/) const {
+    return data != nullptr;
+}
+
+void PooledMatAllocator::deallocate(cv::UMatData* u) const {
+    if (!u) {
+        return;
+    }
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+
+    void* block = u->origdata;
+    const size_t total = u->size;
+    const size_t blockSize = sizeClass(total);
+    delete u;
+
+    m_bytesInUse.fetch_sub(blockSize, RELAXED);
+    if (total >= MIN_POOLED_BYTES) {
+        // 先预占容量再入池，并发归还时空闲总量也不会超过上限
+        if (m_pooledBytes.fetch_add(blockSize, RELAXED) + blockSize <= m_maxPooledBytes.load(RELAXED)) {
+            FreeList& list = m_freeLists[classIndex(blockSize)];
+            std::lock_guard<std::mutex> lock(list.mutex);
+            list.blocks.push_back(block);
+            m_pooledBlocks.fetch_add(1, RELAXED);
+            return;
+        }
+        m_pooledBytes.fetch_sub(blockSize, RELAXED);
+        m_evictions.fetch_add(1, RELAXED);
+    }
+    cv::fastFree(block);
+}
+
+void PooledMatAllocator::setMaxPooledBytes(size_t bytes) {
+    m_maxPooledBytes.store(bytes);
+    trim();
+}
+
+size_t PooledMatAllocator::maxPooledBytes() const {
+    return m_maxPooledBytes.load();
+}
+
+void PooledMatAllocator::trim() const {
+    // 从最大的尺寸级开始释放，尽快回到上限以内
+    for (int index = SIZE_CLASS_COUNT - 1; index >= 0 && m_pooledBytes.load() > m_maxPooledBytes.load(); --index) {
+        FreeList& list = m_freeLists[index];
+        const size_t blockSize = classBytes(index);
+        std::lock_guard<std::mutex> lock(list.mutex);
+        while (!list.blocks.empty() && m_pooledBytes.load() > m_maxPooledBytes.load()) {
+            cv::fastFree(list.blocks.back());
+            list.blocks.pop_back();
+            m_pooledBlocks.fetch_sub(1, RELAXED);
+            m_pooledBytes.fetch_sub(blockSize, RELAXED);
+            m_evictions.fetch_add(1, RELAXED);
+        }
+    }
+}
+
+void PooledMatAllocator::clear() {
+    for (int index = 0; index < SIZE_CLASS_COUNT; ++index) {
+        FreeList& list = m_freeLists[index];
+        std::lock_guard<std::mutex> lock(list.mutex);
+        for (void* block : list.blocks) {
+            cv::fastFree(block);
+        }
+        m_pooledBlocks.fetch_sub(list.blocks.size(), RELAXED);
+        m_pooledBytes.fetch_sub(list.blocks.size() * classBytes(index), RELAXED);
+        list.blocks.clear();
+    }
+}
+
+PooledMatAllocator::Stats PooledMatAllocator::stats() const {
+    // 各计数分别读取，并发分配时快照之间可能相差正在进行的几次操作
+    Stats s;
+    s.allocations = m_allocations.load(RELAXED);
+    s.hits = m_hits.load(RELAXED);
+    s.misses = m_misses.load(RELAXED);
+    s.smallAllocations = m_smallAllocations.load(RELAXED);
+    s.evictions = m_evictions.load(RELAXED);
+    s.bytesAllocated = m_bytesAllocated.load(RELAXED);
+    s.bytesInUse = m_bytesInUse.load(RELAXED);
+    s.peakBytesInUse = m_peakBytesInUse.load(RELAXED);
+    s.pooledBlocks = m_pooledBlocks.load(RELAXED);
+    s.pooledBytes = m_pooledBytes.load(RELAXED);
+    return s;
+}
+
+void PooledMatAllocator::resetStats() {
+    m_allocations.store(0, RELAXED);
+    m_hits.store(0, RELAXED);
+    m_misses.store(0, RELAXED);
+    m_smallAllocations.store(0, RELAXED);
+    m_evictions.store(0, RELAXED);
+    m_bytesAllocated.store(0, RELAXED);
+    m_peakBytesInUse.store(m_bytesInUse.load(RELAXED), RELAXED);
+}
+
+void PooledMatAllocator::install() {
+    if (cv::Mat::getDefaultAllocator() != this) {
+        cv::Mat::setDefaultAllocator(this);
+    }
+}
+
+void PooledMatAllocator::setThreadEnabled(bool enabled) {
+    t_poolingEnabled = enabled;
+}
+
+bool PooledMatAllocator::isThreadEnabled() {
+    return t_poolingEnabled;
+}
+
+// ============================================================================
+// 全局池化分配器
+// ============================================================================
+
+PooledMatAllocator& globalMatAllocator() {
+    // 有意不析构：进程退出时静态对象中的 cv::Mat 可能晚于本对象释放
+    static PooledMatAllocator* allocator = new PooledMatAllocator();
+    return *allocator;
+}
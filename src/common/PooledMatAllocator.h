@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * PooledMatAllocator.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：池化 cv::Mat 分配器
+ * 描述：按尺寸级缓存 cv::Mat 数据块的 OpenCV 分配器。检测器每帧重复申请相同尺寸的
+ *       临时图像（Gabor 响应、形态学结果、Sobel 梯度、LBP 图等），预热后均命中空闲块，
+ *       不再向系统申请大块内存。安装为进程默认分配器后按线程启用：未启用的线程
+ *       转交 OpenCV 标准分配器。空闲块总量受容量上限约束，并提供命中率等统计
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef POOLEDMATALLOCATOR_H
+#define POOLEDMATALLOCATOR_H
+
+#include "common_global.h"
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// ============================================================================
+// 池化分配器 - 线程安全
+// 尺寸级：每个 2 的幂区间再分 4 级（浪费不超过 25%），小于 MIN_POOLED_BYTES 的
+// 请求直接分配（小块由系统分配器的线程缓存处理，池化收益很小）
+// 计数均为原子量，小块分配不加锁；空闲链表按尺寸级各自加锁，不同尺寸互不争用
+// ============================================================================
+
+class COMMON_LIBRARY PooledMatAllocator : public cv::MatAllocator {
+public:
+    static constexpr int MIN_POOLED_SHIFT = 14;
+    static constexpr size_t MIN_POOLED_BYTES = size_t(1) << MIN_POOLED_SHIFT;  // 16 KB
+
+    // 统计信息
+    struct Stats {
+        size_t allocations = 0;     // 经本分配器的分配次数
+        size_t hits = 0;            // 池化尺寸命中空闲块次数
+        size_t misses = 0;          // 池化尺寸向系统新申请次数（大块分配）
+        size_t smallAllocations = 0; // 小块直接分配次数
+        size_t evictions = 0;       // 归还时超出容量上限而释放的块数
+        size_t bytesAllocated = 0;  // 累计分配字节（按尺寸级）
+        size_t bytesInUse = 0;      // 当前借出字节
+        size_t peakBytesInUse = 0;  // 借出字节峰值
+        size_t pooledBlocks = 0;    // 池中空闲块数
+        size_t pooledBytes = 0;     // 池中空闲块占用字节
+
+        double hitRate() const {
+            const size_t total = hits + misses;
+            return total > 0 ? static_cast<double>(hits) / total : 0.0;
+        }
+    };
+
+    // maxPooledBytes: 空闲块总字节上限
+    explicit PooledMatAllocator(size_t maxPooledBytes = 256 * 1024 * 1024);
+    ~PooledMatAllocator() override;
+
+    PooledMatAllocator(const PooledMatAllocator&) = delete;
+    PooledMatAllocator& operator=(const PooledMatAllocator&) = delete;
+
+    // cv::MatAllocator 接口
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags,
+                  cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* data) const override;
+
+    // 调低上限时立即释放超出部分的空闲块
+    void setMaxPooledBytes(size_t bytes);
+    size_t maxPooledBytes() const;
+
+    // 释放全部空闲块（借出中的块归还时照常入池）
+    void clear();
+
+    Stats stats() const;
+    // 清零计数与峰值（借出与池中容量保持不变）
+    void resetStats();
+
+    // 安装为 OpenCV 默认分配器（进程级设置，重复调用无副作用）
+    void install();
+
+    // 当前线程的池化开关（默认关闭）
+    static void setThreadEnabled(bool enabled);
+    static bool isThreadEnabled();
+
+private:
+    // 尺寸级总数：MIN_POOLED_BYTES 起每个 2 的幂区间 4 级
+    static constexpr int SIZE_CLASS_COUNT = (64 - MIN_POOLED_SHIFT) * 4;
+
+    // 单个尺寸级的空闲链表（按缓存行对齐，避免相邻尺寸级的锁伪共享）
+    struct alignas(64) FreeList {
+        std::mutex mutex;
+        std::vector<void*> blocks;
+    };
+
+    static size_t sizeClass(size_t bytes);
+    static int classIndex(size_t blockSize);
+    static size_t classBytes(int index);
+    void trim() const;
+
+    mutable FreeList m_freeLists[SIZE_CLASS_COUNT];
+
+    mutable std::atomic<size_t> m_allocations{0};
+    mutable std::atomic<size_t> m_hits{0};
+    mutable std::atomic<size_t> m_misses{0};
+    mutable std::atomic<size_t> m_smallAllocations{0};
+    mutable std::atomic<size_t> m_evictions{0};
+    mutable std::atomic<size_t> m_bytesAllocated{0};
+    mutable std::atomic<size_t> m_bytesInUse{0};
+    mutable std::atomic<size_t> m_peakBytesInUse{0};
+    mutable std::atomic<size_t> m_pooledBlocks{0};
+    mutable std::atomic<size_t> m_pooledBytes{0};
+    std::atomic<size_t> m_maxPooledBytes;
+};
+
+// ============================================================================
+// 作用域内启用当前线程的池化，析构时恢复原设置
+// ============================================================================
+
+class COMMON_LIBRARY ScopedMatPooling {
+public:
+    explicit ScopedMatPooling(bool enabled)
+        : m_previous(PooledMatAllocator::isThreadEnabled()) {
+        PooledMatAllocator::setThreadEnabled(enabled);
+    }
+    ~ScopedMatPooling() { PooledMatAllocator::setThreadEnabled(m_previous); }
+
+    ScopedMatPooling(const ScopedMatPooling&) = delete;
+    ScopedMatPooling& operator=(const ScopedMatPooling&) = delete;
+
+private:
+    bool m_previous;
+};
+
+// 全局池化分配器（进程退出时不析构，静态 cv::Mat 的释放晚于它时仍然安全）
+COMMON_LIBRARY PooledMatAllocator& globalMatAllocator();
+
+#endif // POOLEDMATALLOCATOR_H
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * ReorderBuffer.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：按序号重排缓冲区
+ * 描述：多帧并发处理时结果完成顺序不确定，按采集序号缓存乱序到达的结果，
+ *       保证严格按序号递增顺序输出；被丢弃的序号通过 skip 标记，避免阻塞后续输出
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef REORDERBUFFER_H
+#define REORDERBUFFER_H
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <utility>
+
+// ============================================================================
+// 重排缓冲区 (非线程安全，调用方需保证在同一线程中使用)
+// ============================================================================
+
+template <typename T>
+class ReorderBuffer {
+public:
+    explicit ReorderBuffer(uint64_t firstSequence = 0)
+        : m_nextSequence(firstSequence) {}
+
+    // 放入一个已完成的结果
+    void push(uint64_t sequence, T value) {
+        if (sequence < m_nextSequence) return;  // 过期序号直接丢弃
+        m_pending[sequence] = std::move(value);
+    }
+
+    // 标记序号已放弃（采集失败、过载丢帧等），不产生输出
+    void skip(uint64_t sequence) {
+        if (sequence < m_nextSequence) return;
+        m_pending[sequence] = std::nullopt;
+    }
+
+    // 取出下一个按序可输出的结果，遇到空洞时返回 false
+    bool pop(T& value) {
+        auto it = m_pending.begin();
+        while (it != m_pending.end() && it->first == m_nextSequence) {
+            std::optional<T> entry = std::move(it->second);
+            it = m_pending.erase(it);
+            ++m_nextSequence;
+            if (entry) {
+                value = std::move(*entry);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 重置到新的起始序号，清空缓存
+    void reset(uint64_t firstSequence = 0) {
+        m_pending.clear();
+        m_nextSequence = firstSequence;
+    }
+
+    uint64_t nextSequence() const { return m_nextSequence; }
+    size_t pendingCount() const { return m_pending.size(); }
+    bool empty() const { return m_pending.empty(); }
+
+private:
+    uint64_t m_nextSequence;
+    std::map<uint64_t, std::optional<T>> m_pending;
+};
+
+#endif // REORDERBUFFER_H
@@ -0,0 +1,271 @@
+#include "ThreadAffinity.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+[[maybe_unused]] const char* policyName(ThreadPlacement::Policy policy) {
+    switch (policy) {
+        case ThreadPlacement::Policy::Default:    return "default";
+        case ThreadPlacement::Policy::Fifo:       return "fifo";
+        case ThreadPlacement::Policy::RoundRobin: return "rr";
+    }
+    return "unknown";
+}
+
+#ifdef __linux__
+pid_t currentTid() {
+    return static_cast<pid_t>(syscall(SYS_gettid));
+}
+#endif
+
+std::vector<int> queryProcessCpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#elif defined(_WIN32)
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        for (int cpu = 0; cpu < static_cast<int>(sizeof(DWORD_PTR) * 8); ++cpu) {
+            if (processMask & (static_cast<DWORD_PTR>(1) << cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+// 模块加载时（main 之前，任何线程绑定之前）记录
+const std::vector<int> g_processCpus = queryProcessCpus();
+
+// 设置当前线程的 CPU 集合，cpus 为空时不做处理
+bool setCurrentThreadCpus(const std::vector<int>& cpus, const std::string& name) {
+    if (cpus.empty()) {
+        return true;
+    }
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        LOG_WARN("{}: Failed to set CPU affinity {}: {}", name,
+                 ThreadAffinity::formatCpuList(cpus), std::strerror(rc));
+        return false;
+    }
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+            mask |= static_cast<DWORD_PTR>(1) << cpu;
+        }
+    }
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+        LOG_WARN("{}: Failed to set CPU affinity {}: error {}", name,
+                 ThreadAffinity::formatCpuList(cpus), GetLastError());
+        return false;
+    }
+#else
+    (void)name;
+#endif
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// ThreadPlacement
+// ============================================================================
+
+bool ThreadPlacement::parse(const std::string& cpus, const std::string& policy, int priority,
+                            ThreadPlacement& placement) {
+    bool ok = ThreadAffinity::parseCpuList(cpus, placement.cpus);
+
+    if (policy.empty() || policy == "default") {
+        placement.policy = Policy::Default;
+        placement.priority = std::clamp(priority, -20, 19);
+    } else if (policy == "fifo" || policy == "rr") {
+        placement.policy = policy == "fifo" ? Policy::Fifo : Policy::RoundRobin;
+        placement.priority = std::clamp(priority, 1, 99);
+    } else {
+        placement.policy = Policy::Default;
+        placement.priority = 0;
+        ok = false;
+    }
+    return ok;
+}
+
+// ============================================================================
+// ThreadAffinity
+// ============================================================================
+
+bool ThreadAffinity::parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    cpus.clear();
+    std::stringstream ss(text);
+    std::string item;
+    bool ok = true;
+    while (std::getline(ss, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) {
+            continue;
+        }
+        try {
+            const size_t dash = item.find('-');
+            const int first = std::stoi(item.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            if (first < 0 || last < first) {
+                ok = false;
+                continue;
+            }
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            ok = false;
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return ok;
+}
+
+std::string ThreadAffinity::formatCpuList(const std::vector<int>& cpus) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < cpus.size(); ) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (i > 0) {
+            oss << ",";
+        }
+        oss << cpus[i];
+        if (j > i) {
+            oss << "-" << cpus[j];
+        }
+        i = j + 1;
+    }
+    return oss.str();
+}
+
+bool ThreadAffinity::applyToCurrentThread(const ThreadPlacement& placement, const std::string& name) {
+    // 未指定 CPU 时恢复为进程 CPU 集合，不继承创建线程（如已绑定的主线程）的亲和性
+    bool ok = setCurrentThreadCpus(placement.cpus.empty() ? processCpus() : placement.cpus, name);
+    if (placement.isDefault()) {
+        return ok;
+    }
+
+#if defined(__linux__)
+    if (placement.policy != ThreadPlacement::Policy::Default) {
+        sched_param param{};
+        param.sched_priority = placement.priority;
+        const int policy = placement.policy == ThreadPlacement::Policy::Fifo ? SCHED_FIFO : SCHED_RR;
+        const int rc = pthread_setschedparam(pthread_self(), policy, &param);
+        if (rc != 0) {
+            // 实时调度需要 CAP_SYS_NICE 或 RLIMIT_RTPRIO 授权
+            LOG_WARN("{}: Failed to set {} priority {}: {}", name, policyName(placement.policy),
+                     placement.priority, std::strerror(rc));
+            ok = false;
+        }
+    } else if (placement.priority != 0) {
+        // Linux 下 nice 值按线程生效
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(currentTid()), placement.priority) != 0) {
+            LOG_WARN("{}: Failed to set nice {}: {}", name, placement.priority, std::strerror(errno));
+            ok = false;
+        }
+    }
+#elif defined(_WIN32)
+    int priority = THREAD_PRIORITY_NORMAL;
+    if (placement.policy != ThreadPlacement::Policy::Default) {
+        priority = placement.priority >= 50 ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+    } else if (placement.priority < 0) {
+        priority = THREAD_PRIORITY_ABOVE_NORMAL;
+    } else if (placement.priority > 0) {
+        priority = THREAD_PRIORITY_BELOW_NORMAL;
+    }
+    if (priority != THREAD_PRIORITY_NORMAL && !SetThreadPriority(GetCurrentThread(), priority)) {
+        LOG_WARN("{}: Failed to set thread priority {}: error {}", name, priority, GetLastError());
+        ok = false;
+    }
+#else
+    LOG_WARN("{}: Thread placement is not supported on this platform", name);
+    ok = false;
+#endif
+
+    LOG_INFO("{}: placement {}", name, describeCurrentThread());
+    return ok;
+}
+
+std::string ThreadAffinity::describeCurrentThread() {
+    std::ostringstream oss;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<int> cpus;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    oss << "cpus=" << (cpus.empty() ? std::string("?") : formatCpuList(cpus));
+
+    int policy = SCHED_OTHER;
+    sched_param param{};
+    pthread_getschedparam(pthread_self(), &policy, &param);
+    if (policy == SCHED_FIFO || policy == SCHED_RR) {
+        oss << " policy=" << (policy == SCHED_FIFO ? "fifo" : "rr") << " priority=" << param.sched_priority;
+    } else {
+        errno = 0;
+        const int nice = getpriority(PRIO_PROCESS, static_cast<id_t>(currentTid()));
+        oss << " policy=default nice=" << (errno == 0 ? nice : 0);
+    }
+#elif defined(_WIN32)
+    oss << "priority=" << GetThreadPriority(GetCurrentThread());
+#else
+    oss << "unsupported";
+#endif
+    return oss.str();
+}
+
+const std::vector<int>& ThreadAffinity::processCpus() {
+    return g_processCpus;
+}
+
+int ThreadAffinity::availableCpuCount() {
+    // 按进程 CPU 集合计：sched_getaffinity(0) 返回的是调用线程的集合，主线程绑定后会偏小
+    if (!g_processCpus.empty()) {
+        return static_cast<int>(g_processCpus.size());
+    }
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
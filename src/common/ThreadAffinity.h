@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * ThreadAffinity.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：线程CPU亲和性与调度优先级
+ * 描述：将线程绑定到指定CPU集合并设置调度策略/优先级，用于为采集与检测路径
+ *       预留核心（Linux 使用 pthread_setaffinity_np 与 SCHED_*，Windows 使用
+ *       SetThreadAffinityMask 与线程优先级）；权限不足时保留原设置并告警
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef THREADAFFINITY_H
+#define THREADAFFINITY_H
+
+#include "common_global.h"
+#include <string>
+#include <vector>
+
+// 线程放置：CPU 集合 + 调度策略
+struct COMMON_LIBRARY ThreadPlacement {
+    enum class Policy {
+        Default,     // 普通分时调度，priority 为 nice 值（-20 ~ 19，0 表示不调整）
+        Fifo,        // SCHED_FIFO 实时调度，priority 为 1 ~ 99
+        RoundRobin   // SCHED_RR 实时调度，priority 为 1 ~ 99
+    };
+
+    std::vector<int> cpus;          // 空表示不绑定
+    Policy policy = Policy::Default;
+    int priority = 0;
+
+    bool isDefault() const { return cpus.empty() && policy == Policy::Default && priority == 0; }
+
+    // 由配置文本构造："2-3,6" / "default|fifo|rr"；格式错误时返回 false 并保留已解析部分
+    static bool parse(const std::string& cpus, const std::string& policy, int priority,
+                      ThreadPlacement& placement);
+};
+
+class COMMON_LIBRARY ThreadAffinity {
+public:
+    // 解析 CPU 列表（如 "0,2-5"），空文本得到空集合
+    static bool parseCpuList(const std::string& text, std::vector<int>& cpus);
+    static std::string formatCpuList(const std::vector<int>& cpus);
+
+    // 应用到当前线程，各项独立生效（亲和性成功而优先级无权限时仍返回 false）
+    // 未指定 CPU 时恢复为进程 CPU 集合（新线程继承创建线程的亲和性，创建者可能已绑定）
+    // name 仅用于日志；指定了放置时以 INFO 输出实际生效的放置
+    static bool applyToCurrentThread(const ThreadPlacement& placement, const std::string& name);
+
+    // 当前线程实际生效的放置描述，如 "cpus=2-3 policy=fifo priority=50"
+    static std::string describeCurrentThread();
+
+    // 进程启动时的 CPU 集合（模块加载时记录，不受之后各线程绑定的影响；未知时为空）
+    static const std::vector<int>& processCpus();
+
+    // 本进程可用的 CPU 数（受启动时亲和性限制，如 taskset/cgroup）
+    static int availableCpuCount();
+};
+
+#endif // THREADAFFINITY_H
@@ -0,0 +1,88 @@
+#include "ThreadBudget.h"
+#include "Logger.h"
+#include <opencv2/core/utility.hpp>
+#include <QThreadPool>
+#include <algorithm>
+
+ThreadBudget& ThreadBudget::instance() {
+    static ThreadBudget inst;
+    return inst;
+}
+
+ThreadBudget::ThreadBudget() : m_coreBudget(ThreadAffinity::availableCpuCount()) {}
+
+void ThreadBudget::configure(int coreBudget, int ioThreads, const ThreadPlacement& poolPlacement) {
+    // 工作线程绑定到指定 CPU 时，预算不超过该集合大小，否则按进程可用 CPU 计
+    const int hardware = poolPlacement.cpus.empty()
+        ? ThreadAffinity::availableCpuCount() : static_cast<int>(poolPlacement.cpus.size());
+    const int budget = coreBudget > 0 ? std::min(coreBudget, hardware) : hardware;
+    const int io = std::max(1, ioThreads);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_poolSized && budget != m_coreBudget) {
+            LOG_WARN("ThreadBudget: Global thread pool already created with {} threads, "
+                     "new budget {} only applies to per-frame parallelism", m_coreBudget, budget);
+        }
+        m_coreBudget = budget;
+        m_ioThreads = io;
+        m_poolPlacement = poolPlacement;
+        m_openCVThreads = -1;
+    }
+
+    // QtConcurrent::run 默认使用 Qt 全局线程池，I/O 类任务（图像保存等）不占用计算预算
+    QThreadPool::globalInstance()->setMaxThreadCount(io);
+
+    LOG_INFO("ThreadBudget: {} compute threads ({} available CPUs), {} I/O threads", budget, hardware, io);
+}
+
+int ThreadBudget::coreBudget() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_coreBudget;
+}
+
+int ThreadBudget::ioThreads() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ioThreads;
+}
+
+void ThreadBudget::setConcurrentFrames(int frames) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_concurrentFrames = std::max(1, frames);
+}
+
+int ThreadBudget::concurrentFrames() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_concurrentFrames;
+}
+
+int ThreadBudget::perFrameParallelism() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::max(1, m_coreBudget / m_concurrentFrames);
+}
+
+ThreadPlacement ThreadBudget::poolPlacement() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_poolPlacement;
+}
+
+int ThreadBudget::poolThreadCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_poolSized = true;
+    return m_coreBudget;
+}
+
+void ThreadBudget::applyOpenCV() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const int threads = std::max(1, m_coreBudget / m_concurrentFrames);
+    if (threads == m_openCVThreads) {
+        return;
+    }
+    cv::setNumThreads(threads);
+    m_openCVThreads = threads;
+    LOG_DEBUG("ThreadBudget: OpenCV threads set to {} ({} concurrent frames)", threads, m_concurrentFrames);
+}
+
+int ThreadBudget::openCVThreads() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_openCVThreads;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * ThreadBudget.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：全局CPU线程预算
+ * 描述：以一个可配置的核数预算统一约束全局线程池、OpenCV 内部并行与
+ *       Qt 全局线程池（I/O 类任务）的线程数，避免多层并行叠加造成线程超额订阅
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef THREADBUDGET_H
+#define THREADBUDGET_H
+
+#include "common_global.h"
+#include "ThreadAffinity.h"
+#include <mutex>
+
+class COMMON_LIBRARY ThreadBudget {
+public:
+    static ThreadBudget& instance();
+
+    ThreadBudget(const ThreadBudget&) = delete;
+    ThreadBudget& operator=(const ThreadBudget&) = delete;
+
+    // 设置核数预算（0 为全部可用 CPU）与 I/O 线程数（Qt 全局线程池，供 QtConcurrent 使用）；
+    // poolPlacement 为全局线程池工作线程的放置，绑定 CPU 时预算不超过该 CPU 集合大小
+    // 应在首次使用 globalThreadPool() 之前调用，之后调用时全局线程池大小与放置不再变化
+    void configure(int coreBudget, int ioThreads,
+                   const ThreadPlacement& poolPlacement = ThreadPlacement());
+
+    int coreBudget() const;
+    int ioThreads() const;
+
+    // 同时处理的帧数，核数预算在各帧之间平分
+    void setConcurrentFrames(int frames);
+    int concurrentFrames() const;
+
+    // 单帧可用并行度（至少为 1）
+    int perFrameParallelism() const;
+
+    ThreadPlacement poolPlacement() const;
+
+    // 全局线程池的工作线程数（等于核数预算；由 globalThreadPool() 构造时调用一次）
+    int poolThreadCount();
+
+    // 按单帧可用并行度设置 OpenCV 线程数（值变化时才调用 cv::setNumThreads）
+    // OpenCV 线程数为进程级设置，只随预算与并发帧数变化，不随单次调用的并行方式切换，
+    // 并发帧之间不会互相覆盖；检测器内部的数据并行使用 parallelFor（全局线程池），不受其影响
+    void applyOpenCV();
+    int openCVThreads() const;
+
+private:
+    ThreadBudget();
+    ~ThreadBudget() = default;
+
+    mutable std::mutex m_mutex;
+    int m_coreBudget;
+    int m_ioThreads = 2;
+    int m_concurrentFrames = 1;
+    int m_openCVThreads = -1;   // 最近一次设置的 OpenCV 线程数，-1 为未设置
+    bool m_poolSized = false;   // 全局线程池是否已按预算创建
+    ThreadPlacement m_poolPlacement;
+};
+
+#endif // THREADBUDGET_H
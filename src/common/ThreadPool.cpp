@@ -1,6 +1,8 @@
 #include "ThreadPool.h"
 #include "Logger.h"
+#include "ThreadBudget.h"
 #include <algorithm>
+#include <chrono>
 #include <sstream>
 
 #ifdef _WIN32
@@ -20,6 +22,13 @@ void setThreadName([[maybe_unused]] const std::string& name) {
     // Windows: SetThreadDescription 在 MinGW 中不可用，跳过
 }
 
+// 当前线程所属的线程池及其队列编号（非工作线程为 nullptr）
+thread_local const ThreadPool* t_pool = nullptr;
+thread_local size_t t_queueIndex = 0;
+
+// 任务组等待时无任务可协助的休眠上限，期间有新的子任务派生时可及时参与执行
+constexpr auto GROUP_IDLE_WAIT = std::chrono::microseconds(200);
+
 } // namespace
 
 // ============================================================================
@@ -32,6 +41,11 @@ ThreadPool::ThreadPool(size_t threadCount, const std::string& name)
     if (m_desiredThreadCount == 0) {
         m_desiredThreadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
     }
+    // 队列在构造时一次性创建，提交路径无需与 start/stop 同步
+    m_queues.reserve(m_desiredThreadCount);
+    for (size_t i = 0; i < m_desiredThreadCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
 }
 
 ThreadPool::~ThreadPool() {
@@ -58,6 +72,9 @@ void ThreadPool::stop() {
 
     LOG_INFO("{}: stopping...", m_name);
 
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
     m_cv.notify_all();
 
     for (auto& t : m_workers) {
@@ -67,53 +84,164 @@ void ThreadPool::stop() {
     }
     m_workers.clear();
 
-    // 清空剩余任务
+    // 清空剩余任务（任务组子任务的领取凭据被丢弃不影响子任务本身，由其等待方自行执行）
     size_t dropped = 0;
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        dropped = m_tasks.size();
-        while (!m_tasks.empty()) {
-            m_tasks.pop();
+    for (auto& queue : m_queues) {
+        std::deque<PoolTask> pending[PRIORITY_LEVELS];
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            for (int p = 0; p < PRIORITY_LEVELS; ++p) {
+                dropped += queue->tasks[p].size();
+                pending[p].swap(queue->tasks[p]);
+            }
         }
     }
+    m_queued.fetch_sub(dropped);
+    if (dropped > 0 && m_unfinished.fetch_sub(dropped) == dropped) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_cvComplete.notify_all();
+    }
 
     if (dropped > 0) {
         LOG_WARN("{}: dropped {} pending tasks", m_name, dropped);
     }
 
-    LOG_INFO("{}: stopped. completed={}, failed={}",
-             m_name, m_completedTasks.load(), m_failedTasks.load());
+    LOG_INFO("{}: stopped. completed={}, failed={}, stolen={}",
+             m_name, m_completedTasks.load(), m_failedTasks.load(), m_stolenTasks.load());
 }
 
 void ThreadPool::waitAll() {
-    std::unique_lock<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
     m_cvComplete.wait(lock, [this] {
-        return m_tasks.empty() && m_activeCount.load() == 0;
+        return m_unfinished.load() == 0;
     });
 }
 
-void ThreadPool::enqueue(std::function<void()> task) {
-    enqueue(Priority::Normal, std::move(task));
-}
-
-void ThreadPool::enqueue(Priority priority, std::function<void()> task) {
+bool ThreadPool::push(Priority priority, PoolTask task) {
     if (!m_running.load()) {
         LOG_WARN("{}: cannot enqueue, pool not running", m_name);
-        return;
+        return false;
+    }
+    if (task.isHeapAllocated()) {
+        ++m_heapTasks;
     }
 
+    // 工作线程派生的子任务进入本线程队列（fork-join 局部性），外部线程提交轮询分配
+    const size_t index = (t_pool == this) ? t_queueIndex
+                                          : m_nextQueue.fetch_add(1) % m_queues.size();
+    ++m_totalTasks;
+    ++m_unfinished;
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_tasks.push(Task{std::move(task), priority});
-        ++m_totalTasks;
+        WorkerQueue& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks[static_cast<int>(priority)].push_back(std::move(task));
+        ++m_queued;
     }
 
-    m_cv.notify_one();
+    // 仅在有线程休眠时才需要唤醒；加锁保证与休眠线程的谓词检查互斥，不丢失唤醒
+    if (m_sleepers.load() > 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+        }
+        m_cv.notify_one();
+    }
+    return true;
 }
 
-size_t ThreadPool::pendingTasks() const {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_tasks.size();
+bool ThreadPool::popLocal(size_t index, PoolTask& task) {
+    WorkerQueue& queue = *m_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (int p = PRIORITY_LEVELS - 1; p >= 0; --p) {
+        auto& tasks = queue.tasks[p];
+        if (!tasks.empty()) {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+            --m_queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::steal(size_t start, PoolTask& task) {
+    // 从队首窃取：最早提交的任务通常粒度最大，且与队列所有者的 LIFO 端不冲突
+    const size_t count = m_queues.size();
+    for (size_t i = 0; i < count; ++i) {
+        WorkerQueue& queue = *m_queues[(start + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (int p = PRIORITY_LEVELS - 1; p >= 0; --p) {
+            auto& tasks = queue.tasks[p];
+            if (!tasks.empty()) {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                --m_queued;
+                ++m_stolenTasks;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::takeTask(PoolTask& task) {
+    if (m_queued.load() == 0) {
+        return false;
+    }
+    if (t_pool == this) {
+        return popLocal(t_queueIndex, task) || steal(t_queueIndex + 1, task);
+    }
+    return steal(m_nextQueue.load(), task);
+}
+
+bool ThreadPool::runPendingTask() {
+    PoolTask task;
+    if (!takeTask(task)) {
+        return false;
+    }
+    runTask(task, t_pool == this ? m_name + "-" + std::to_string(t_queueIndex) : m_name + "-helper");
+    return true;
+}
+
+bool ThreadPool::isWorkerThread() const {
+    return t_pool == this;
+}
+
+void ThreadPool::runTask(PoolTask& task, const std::string& threadName) {
+    ++m_activeCount;
+
+    try {
+        task();
+        ++m_completedTasks;
+    } catch (const std::exception& e) {
+        ++m_failedTasks;
+        LOG_ERROR("{}: task exception: {}", threadName, e.what());
+
+        ExceptionHandler handler;
+        {
+            std::lock_guard<std::mutex> lock(m_handlerMutex);
+            handler = m_exceptionHandler;
+        }
+        if (handler) {
+            try {
+                handler(e, threadName);
+            } catch (...) {
+                // 忽略异常处理器的异常
+            }
+        }
+    } catch (...) {
+        ++m_failedTasks;
+        LOG_ERROR("{}: task threw unknown exception", threadName);
+    }
+
+    // 先销毁任务（释放捕获的资源），再计为完成
+    task = PoolTask();
+    --m_activeCount;
+
+    // 通知等待者
+    if (m_unfinished.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_cvComplete.notify_all();
+    }
 }
 
 ThreadPool::Stats ThreadPool::stats() const {
@@ -122,82 +250,113 @@ ThreadPool::Stats ThreadPool::stats() const {
     s.completedTasks = m_completedTasks.load();
     s.failedTasks = m_failedTasks.load();
     s.activeThreads = m_activeCount.load();
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        s.pendingTasks = m_tasks.size();
-    }
+    s.pendingTasks = m_queued.load();
+    s.stolenTasks = m_stolenTasks.load();
+    s.heapTasks = m_heapTasks.load();
     return s;
 }
 
 void ThreadPool::setExceptionHandler(ExceptionHandler handler) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<std::mutex> lock(m_handlerMutex);
     m_exceptionHandler = std::move(handler);
 }
 
 void ThreadPool::workerLoop(size_t workerId) {
+    t_pool = this;
+    t_queueIndex = workerId;
+
     std::ostringstream oss;
     oss << m_name << "-" << workerId;
     std::string threadName = oss.str();
     setThreadName(threadName);
+    ThreadAffinity::applyToCurrentThread(m_placement, threadName);
 
     LOG_DEBUG("{}: worker started", threadName);
 
     while (m_running.load()) {
-        Task task;
-
-        {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            m_cv.wait(lock, [this] {
-                return !m_running.load() || !m_tasks.empty();
-            });
+        PoolTask task;
+        if (takeTask(task)) {
+            runTask(task, threadName);
+            continue;
+        }
 
-            if (!m_running.load() && m_tasks.empty()) {
-                break;
-            }
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        ++m_sleepers;
+        m_cv.wait(lock, [this] {
+            return !m_running.load() || m_queued.load() > 0;
+        });
+        --m_sleepers;
+    }
 
-            if (m_tasks.empty()) {
-                continue;
-            }
+    t_pool = nullptr;
+    LOG_DEBUG("{}: worker exiting", threadName);
+}
 
-            task = std::move(const_cast<Task&>(m_tasks.top()));
-            m_tasks.pop();
-        }
+// ============================================================================
+// TaskGroup
+// ============================================================================
 
-        if (task.func) {
-            ++m_activeCount;
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // 析构时忽略子任务异常（应显式调用 wait 获取）
+    }
+}
 
-            try {
-                task.func();
-                ++m_completedTasks;
-            } catch (const std::exception& e) {
-                ++m_failedTasks;
-                LOG_ERROR("{}: task exception: {}", threadName, e.what());
-
-                if (m_exceptionHandler) {
-                    try {
-                        m_exceptionHandler(e, threadName);
-                    } catch (...) {
-                        // 忽略异常处理器的异常
-                    }
-                }
-            } catch (...) {
-                ++m_failedTasks;
-                LOG_ERROR("{}: task threw unknown exception", threadName);
-            }
+void TaskGroup::wait() {
+    // 等待期间只协助执行本组尚未被领取的子任务：工作线程内嵌套等待不会死锁，
+    // 也不会把线程池中排队的其他顶层任务（如整帧检测）嵌套到当前调用栈上，拉长本组的完成时间
+    while (m_pending.load() > 0) {
+        if (!m_list || !runOne(*m_list, true)) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_for(lock, GROUP_IDLE_WAIT, [this] { return m_pending.load() == 0; });
+        }
+    }
 
-            --m_activeCount;
+    // 与最后一个完成的子任务同步，确保其已不再访问本对象
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        error = m_error;
+        m_error = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
 
-            // 通知等待者
-            {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                if (m_tasks.empty() && m_activeCount.load() == 0) {
-                    m_cvComplete.notify_all();
-                }
-            }
+bool TaskGroup::runOne(PendingList& list, bool newest) {
+    PoolTask task;
+    {
+        std::lock_guard<std::mutex> lock(list.mutex);
+        if (list.tasks.empty()) {
+            return false;
+        }
+        if (newest) {
+            task = std::move(list.tasks.back());
+            list.tasks.pop_back();
+        } else {
+            task = std::move(list.tasks.front());
+            list.tasks.pop_front();
         }
     }
+    task();
+    return true;
+}
 
-    LOG_DEBUG("{}: worker exiting", threadName);
+void TaskGroup::finish() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pending.fetch_sub(1) == 1) {
+        m_cv.notify_all();
+    }
+}
+
+void TaskGroup::captureException() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_error) {
+        m_error = std::current_exception();
+    }
 }
 
 // ============================================================================
@@ -205,9 +364,11 @@ void ThreadPool::workerLoop(size_t workerId) {
 // ============================================================================
 
 ThreadPool& globalThreadPool() {
-    static ThreadPool pool(0, "GlobalPool");
+    // 工作线程数取自全局线程预算（ThreadBudget::configure 应在此之前调用）
+    static ThreadPool pool(static_cast<size_t>(ThreadBudget::instance().poolThreadCount()), "GlobalPool");
     static std::once_flag initFlag;
     std::call_once(initFlag, [] {
+        pool.setWorkerPlacement(ThreadBudget::instance().poolPlacement());
         pool.start();
     });
     return pool;
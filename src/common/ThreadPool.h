@@ -8,8 +8,9 @@
  * 作者：Vere
  * 创建日期：2025年12月03日
  * 摘要：线程池模块接口定义
- * 描述：基于std::thread的线程池实现，支持任务队列、动态线程数量、
- *       异步任务提交和future结果获取
+ * 描述：基于std::thread的工作窃取线程池，每个工作线程持有独立的任务双端队列，
+ *       本线程从队尾取任务（LIFO，缓存友好），空闲线程从其他队列队首窃取；
+ *       支持优先级、future结果获取、fork-join任务组（嵌套并行时等待方协助执行）
  *
  * 当前版本：1.0
  */
@@ -18,27 +19,127 @@
 #define THREADPOOL_H
 
 #include "common_global.h"
+#include "ThreadAffinity.h"
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 // ============================================================================
-// 线程池 - 支持 future、优先级、异常处理
+// 任务对象 - 仅可移动，小对象内联存储（不分配堆内存）
+// ============================================================================
+
+class PoolTask {
+public:
+    // 内联存储容量：可容纳捕获数个指针/引用的 lambda
+    static constexpr size_t INLINE_SIZE = 48;
+
+    PoolTask() = default;
+
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<F>, PoolTask>::value>>
+    PoolTask(F&& f) {  // NOLINT: 允许由可调用对象隐式构造
+        using Fn = std::decay_t<F>;
+        if constexpr (sizeof(Fn) <= INLINE_SIZE &&
+                      alignof(Fn) <= alignof(std::max_align_t) &&
+                      std::is_nothrow_move_constructible<Fn>::value) {
+            new (&m_storage) Fn(std::forward<F>(f));
+            m_ops = &InlineOps<Fn>::ops;
+        } else {
+            *reinterpret_cast<Fn**>(&m_storage) = new Fn(std::forward<F>(f));
+            m_ops = &HeapOps<Fn>::ops;
+        }
+    }
+
+    PoolTask(PoolTask&& other) noexcept { moveFrom(other); }
+
+    PoolTask& operator=(PoolTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    PoolTask(const PoolTask&) = delete;
+    PoolTask& operator=(const PoolTask&) = delete;
+
+    ~PoolTask() { reset(); }
+
+    explicit operator bool() const { return m_ops != nullptr; }
+    void operator()() { m_ops->invoke(&m_storage); }
+
+    // 是否使用了堆分配（用于统计）
+    bool isHeapAllocated() const { return m_ops && m_ops->heap; }
+
+private:
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void* dst, void* src);  // 移动构造到 dst 并销毁 src
+        void (*destroy)(void*);
+        bool heap;
+    };
+
+    template <typename Fn>
+    struct InlineOps {
+        static void invoke(void* p) { (*static_cast<Fn*>(p))(); }
+        static void move(void* dst, void* src) {
+            new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        }
+        static void destroy(void* p) { static_cast<Fn*>(p)->~Fn(); }
+        static constexpr Ops ops{&invoke, &move, &destroy, false};
+    };
+
+    template <typename Fn>
+    struct HeapOps {
+        static void invoke(void* p) { (**static_cast<Fn**>(p))(); }
+        static void move(void* dst, void* src) {
+            *static_cast<Fn**>(dst) = *static_cast<Fn**>(src);
+        }
+        static void destroy(void* p) { delete *static_cast<Fn**>(p); }
+        static constexpr Ops ops{&invoke, &move, &destroy, true};
+    };
+
+    void moveFrom(PoolTask& other) noexcept {
+        m_ops = other.m_ops;
+        if (m_ops) {
+            m_ops->move(&m_storage, &other.m_storage);
+            other.m_ops = nullptr;
+        }
+    }
+
+    void reset() {
+        if (m_ops) {
+            m_ops->destroy(&m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+    std::aligned_storage_t<INLINE_SIZE, alignof(std::max_align_t)> m_storage;
+    const Ops* m_ops = nullptr;
+};
+
+// ============================================================================
+// 线程池 - 工作窃取，支持 future、优先级、异常处理
 // ============================================================================
 
 class COMMON_LIBRARY ThreadPool {
 public:
-    // 任务优先级
+    // 任务优先级（同一队列内高优先级先执行；跨队列窃取时同样优先窃取高优先级任务）
     enum class Priority { Low = 0, Normal = 1, High = 2 };
 
     // 统计信息
@@ -48,6 +149,8 @@ public:
         size_t failedTasks = 0;     // 失败任务数
         size_t pendingTasks = 0;    // 待处理任务数
         size_t activeThreads = 0;   // 活跃线程数
+        size_t stolenTasks = 0;     // 从其他线程队列窃取执行的任务数
+        size_t heapTasks = 0;       // 超出内联容量、需要堆分配的任务数
     };
 
     explicit ThreadPool(size_t threadCount = 0, const std::string& name = "ThreadPool");
@@ -57,6 +160,10 @@ public:
     ThreadPool(const ThreadPool&) = delete;
     ThreadPool& operator=(const ThreadPool&) = delete;
 
+    // 工作线程的 CPU 亲和性与调度优先级（须在 start 之前设置，各工作线程绑定到同一 CPU 集合）
+    void setWorkerPlacement(const ThreadPlacement& placement) { m_placement = placement; }
+    const ThreadPlacement& workerPlacement() const { return m_placement; }
+
     // 启动/停止
     void start();
     void stop();
@@ -72,14 +179,23 @@ public:
     auto submit(Priority priority, F&& f, Args&&... args)
         -> std::future<typename std::invoke_result<F, Args...>::type>;
 
-    // 提交任务（无返回值，简化版）
-    void enqueue(std::function<void()> task);
-    void enqueue(Priority priority, std::function<void()> task);
+    // 提交任务（无返回值，简化版；小 lambda 不产生堆分配）
+    template <typename F>
+    void enqueue(F&& task) { enqueue(Priority::Normal, std::forward<F>(task)); }
+    template <typename F>
+    void enqueue(Priority priority, F&& task);
+
+    // 在当前线程执行一个待处理任务（优先本线程队列，其次窃取），无任务时返回 false
+    // 用于等待方协助执行，避免嵌套并行时工作线程全部阻塞
+    bool runPendingTask();
+
+    // 当前线程是否为本线程池的工作线程
+    bool isWorkerThread() const;
 
     // 状态查询
     bool isRunning() const { return m_running.load(); }
     size_t threadCount() const { return m_workers.size(); }
-    size_t pendingTasks() const;
+    size_t pendingTasks() const { return m_queued.load(); }
     Stats stats() const;
 
     // 设置异常处理器
@@ -87,33 +203,105 @@ public:
     void setExceptionHandler(ExceptionHandler handler);
 
 private:
-    struct Task {
-        std::function<void()> func;
-        Priority priority = Priority::Normal;
+    friend class TaskGroup;
+    static constexpr int PRIORITY_LEVELS = 3;
 
-        bool operator<(const Task& other) const {
-            return static_cast<int>(priority) < static_cast<int>(other.priority);
-        }
+    // 每个工作线程一个队列，各自加锁，提交与取任务不再争用同一把锁
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<PoolTask> tasks[PRIORITY_LEVELS];
     };
 
+    bool push(Priority priority, PoolTask task);
+    bool popLocal(size_t index, PoolTask& task);
+    bool steal(size_t thief, PoolTask& task);
+    bool takeTask(PoolTask& task);
+    void runTask(PoolTask& task, const std::string& threadName);
     void workerLoop(size_t workerId);
 
     std::string m_name;
     std::vector<std::thread> m_workers;
-    std::priority_queue<Task> m_tasks;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
 
-    mutable std::mutex m_mutex;
+    // 仅用于空闲线程休眠/唤醒与 waitAll
+    std::mutex m_sleepMutex;
     std::condition_variable m_cv;
     std::condition_variable m_cvComplete;
+    std::atomic<size_t> m_sleepers{0};
 
     std::atomic<bool> m_running{false};
+    std::atomic<size_t> m_queued{0};       // 队列中的任务数
+    std::atomic<size_t> m_unfinished{0};   // 队列中 + 执行中的任务数
+    std::atomic<size_t> m_nextQueue{0};    // 外部线程提交时轮询分配队列
     std::atomic<size_t> m_activeCount{0};
     std::atomic<size_t> m_totalTasks{0};
     std::atomic<size_t> m_completedTasks{0};
     std::atomic<size_t> m_failedTasks{0};
+    std::atomic<size_t> m_stolenTasks{0};
+    std::atomic<size_t> m_heapTasks{0};
 
+    mutable std::mutex m_handlerMutex;
     ExceptionHandler m_exceptionHandler;
     size_t m_desiredThreadCount;
+    ThreadPlacement m_placement;
+};
+
+// ============================================================================
+// 任务组 - fork-join：run 派生子任务，wait 等待全部完成（等待期间只协助执行本组子任务）
+// ============================================================================
+
+class COMMON_LIBRARY TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) : m_pool(pool) {}
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // 派生子任务；线程池未运行时在当前线程直接执行
+    template <typename F>
+    void run(F&& f, ThreadPool::Priority priority = ThreadPool::Priority::High);
+
+    // 等待所有子任务完成，重新抛出首个子任务异常
+    // 等待方只从本组待执行列表中取任务执行，不会在栈上嵌套执行线程池中的其他任务（如整帧任务）
+    void wait();
+
+private:
+    // 本组待执行的子任务；线程池中只投递领取凭据，凭据执行时从此列表取一个子任务运行。
+    // 列表由凭据共享持有：任务组结束后残留的凭据取不到任务即直接返回
+    struct PendingList {
+        std::mutex mutex;
+        std::deque<PoolTask> tasks;
+    };
+
+    // 子任务包装：执行后通知任务组
+    template <typename Fn>
+    struct GroupTask {
+        TaskGroup* group;
+        Fn fn;
+
+        void operator()() {
+            try {
+                fn();
+            } catch (...) {
+                group->captureException();
+            }
+            group->finish();
+        }
+    };
+
+    // 从待执行列表取一个子任务执行（等待方取队尾，凭据取队首），列表为空时返回 false
+    static bool runOne(PendingList& list, bool newest);
+
+    void finish();
+    void captureException();
+
+    ThreadPool& m_pool;
+    std::shared_ptr<PendingList> m_list;
+    std::atomic<size_t> m_pending{0};
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::exception_ptr m_error;
 };
 
 // ============================================================================
@@ -131,23 +319,45 @@ auto ThreadPool::submit(Priority priority, F&& f, Args&&... args)
     -> std::future<typename std::invoke_result<F, Args...>::type> {
     using ReturnType = typename std::invoke_result<F, Args...>::type;
 
-    auto task = std::make_shared<std::packaged_task<ReturnType()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-    );
+    // packaged_task 直接移入任务对象，不再经 std::bind / shared_ptr 间接包装
+    std::packaged_task<ReturnType()> task(
+        [fn = std::forward<F>(f), tuple = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+            return std::apply(std::move(fn), std::move(tuple));
+        });
+    std::future<ReturnType> result = task.get_future();
 
-    std::future<ReturnType> result = task->get_future();
+    if (!push(priority, PoolTask([task = std::move(task)]() mutable { task(); }))) {
+        throw std::runtime_error("ThreadPool is not running");
+    }
+    return result;
+}
 
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (!m_running) {
-            throw std::runtime_error("ThreadPool is not running");
+template <typename F>
+void ThreadPool::enqueue(Priority priority, F&& task) {
+    push(priority, PoolTask(std::forward<F>(task)));
+}
+
+template <typename F>
+void TaskGroup::run(F&& f, ThreadPool::Priority priority) {
+    if (!m_pool.isRunning()) {
+        try {
+            f();
+        } catch (...) {
+            captureException();
         }
-        m_tasks.push(Task{[task]() { (*task)(); }, priority});
-        ++m_totalTasks;
+        return;
     }
 
-    m_cv.notify_one();
-    return result;
+    if (!m_list) {
+        m_list = std::make_shared<PendingList>();
+    }
+    m_pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(m_list->mutex);
+        m_list->tasks.emplace_back(GroupTask<std::decay_t<F>>{this, std::forward<F>(f)});
+    }
+    // 凭据投递失败（线程池恰好停止）时子任务仍留在列表中，由等待方自行执行
+    m_pool.push(priority, PoolTask([list = m_list] { runOne(*list, false); }));
 }
 
 // ============================================================================
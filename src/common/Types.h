@@ -8,7 +8,7 @@
  * 作者：Vere
  * 创建日期：2025年12月03日
  * 摘要：通用类型定义
- * 描述：定义项目中使用的通用数据结构：DetectResult检测结果、DefectRegion缺陷区域、
+ * 描述：定义项目中使用的通用数据结构：DetectResult检测结果、DefectInfo缺陷信息、
  *       SeverityLevel严重等级、PerfStats性能统计等
  *
  * 当前版本：1.0
@@ -16,16 +16,30 @@
 
 #ifndef TYPES_H
 #define TYPES_H
+#include "DefectFeatures.h"
 #include <QMetaType>
 #include <QString>
+#include <QVariantMap>
+#include <memory>
 #include <vector>
-#include <opencv2/core.hpp>  // 只需要 cv::Rect
+#include <opencv2/core.hpp>  // 只需要 cv::Rect / cv::Point
 // src/common/Types.h
 
-struct DefectRegion {
-  cv::Rect bbox;           // 缺陷边界框
-  double confidence;       // 置信度
-  int classId;             // 缺陷类别ID
+// 缺陷信息结构（检测器输出，并随 DetectResult 原样交给 UI、数据库与网络）
+struct DefectInfo {
+  cv::Rect bbox;              // 边界框
+  double confidence = 0.0;    // 置信度 [0, 1]
+  double severity = 0.0;      // 严重度 [0, 1]
+  int classId = 0;            // 类别ID
+  QString className;          // 类别名称
+  QString description;        // 描述信息
+  std::vector<cv::Point> contour;  // 轮廓点（可选）
+
+  // 类型化特征（长度、面积、检测方法等），复制不产生堆分配
+  DefectFeatures features;
+
+  // 特征的 QVariantMap 形式，仅供 UI 显示与 JSON 导出按需调用
+  QVariantMap attributes() const { return features.toVariantMap(); }
 };
 
 enum class SeverityLevel {
@@ -65,8 +79,7 @@ enum class UserRole {
 
 struct DetectResult {
   QString defectType;                    // 缺陷类型
-  std::vector<cv::Rect> regions;         // 检测到的缺陷框列表
-  std::vector<DefectRegion> defects;     // 带置信度的缺陷列表
+  std::vector<DefectInfo> defects;       // 缺陷列表（框、置信度、轮廓与特征）
   double severity = 0.0;                 // 严重度分数
   SeverityLevel level = SeverityLevel::OK; // 严重度等级
   double confidence = 0.0;               // 置信度 0-1
@@ -74,8 +87,19 @@ struct DetectResult {
   int cycleTimeMs = 0;                   // 单次检测耗时
   qint64 timestamp = 0;                  // 检测时间戳
   QString errorMsg;                      // 错误信息
+  quint64 sequence = 0;                  // 采集序号（按此顺序输出）
+  QString imagePath;                     // 对应图像路径
+  bool late = false;                     // 触发到出结果超过节拍上限
+  bool degraded = false;                 // 过载时以降低的分辨率检测
+  bool earlyExit = false;                // 致命缺陷提前判定 NG（其余检测器已取消）
 };
 
 Q_DECLARE_METATYPE(DetectResult);
 
+// 检测结果的共享只读句柄：流水线发出后不再修改，UI、数据库、网络等消费者
+// 经排队信号传递时只增加引用计数，不复制缺陷列表
+using DetectResultPtr = std::shared_ptr<const DetectResult>;
+
+Q_DECLARE_METATYPE(DetectResultPtr);
+
 #endif // TYPES_H
@@ -1,6 +1,6 @@
 # =============================================================================
 # common - 公共基础模块
-# 职责: 类型定义、日志、工具函数、线程池、无锁队列
+# 职责: 类型定义、日志、工具函数、线程池、无锁队列（SPSC/MPMC）
 # 依赖: 无（最底层模块）
 # =============================================================================
 
@@ -22,10 +22,18 @@ INCLUDEPATH += $$PWD/../../third_party/opencv/include
 HEADERS += \
     CircularBuffer.h \
     Constants.h \
+    DefectFeatures.h \
     ErrorCode.h \
+    FramePool.h \
     Logger.h \
+    MPMCQueue.h \
+    ParallelFor.h \
+    PooledMatAllocator.h \
+    ReorderBuffer.h \
     SPSCQueue.h \
     Singleton.h \
+    ThreadAffinity.h \
+    ThreadBudget.h \
     ThreadPool.h \
     Timer.h \
     Types.h \
@@ -37,8 +45,14 @@ HEADERS += \
 # ------------------ 源文件 ------------------
 SOURCES += \
     CircularBuffer.cpp \
+    DefectFeatures.cpp \
+    FramePool.cpp \
     Logger.cpp \
+    MPMCQueue.cpp \
+    PooledMatAllocator.cpp \
     SPSCQueue.cpp \
+    ThreadAffinity.cpp \
+    ThreadBudget.cpp \
     ThreadPool.cpp \
     Timer.cpp \
     Utils.cpp \
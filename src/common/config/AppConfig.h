@@ -21,6 +21,7 @@
 #include <QJsonObject>
 #include <QMetaProperty>
 #include <QString>
+#include <QVariantMap>
 
 // ============================================================================
 // 通用 JSON 序列化模板（基于 Q_GADGET 反射）
@@ -103,6 +104,7 @@ struct COMMON_LIBRARY ScratchDetectorConfig {
     Q_PROPERTY(int minLength MEMBER minLength)
     Q_PROPERTY(int maxWidth MEMBER maxWidth)
     Q_PROPERTY(int contrastThreshold MEMBER contrastThreshold)
+    Q_PROPERTY(int pyramidLevels MEMBER pyramidLevels)
 
 public:
     bool enabled = true;
@@ -110,6 +112,7 @@ public:
     int minLength = 10;
     int maxWidth = 5;
     int contrastThreshold = 30;
+    int pyramidLevels = 2;              // 多尺度层数 [1-3]：1 仅原图，2 加 1/2，3 再加 1/4
 
     QJsonObject toJson() const { return gadgetToJson(*this); }
     static ScratchDetectorConfig fromJson(const QJsonObject& json) {
@@ -130,6 +133,9 @@ struct COMMON_LIBRARY CrackDetectorConfig {
     Q_PROPERTY(int minArea MEMBER minArea)
     Q_PROPERTY(int morphKernelSize MEMBER morphKernelSize)
     Q_PROPERTY(int binaryThreshold MEMBER binaryThreshold)
+    Q_PROPERTY(int gaborOrientations MEMBER gaborOrientations)
+    Q_PROPERTY(QString gaborMethod MEMBER gaborMethod)
+    Q_PROPERTY(QString skeletonMethod MEMBER skeletonMethod)
 
 public:
     bool enabled = true;
@@ -137,6 +143,10 @@ public:
     int minArea = 20;
     int morphKernelSize = 3;
     int binaryThreshold = 128;
+    int gaborOrientations = 4;          // Gabor 方向数 [1-16]
+    QString gaborMethod = "auto";       // Gabor 卷积路径: auto/direct/separable/dft
+    // 骨架化: thinning（Zhang-Suen 细化，交叉数判定分支/端点）/ morphological（旧版形态学骨架，结果更碎）
+    QString skeletonMethod = "thinning";
 
     QJsonObject toJson() const { return gadgetToJson(*this); }
     static CrackDetectorConfig fromJson(const QJsonObject& json) {
@@ -242,6 +252,27 @@ struct COMMON_LIBRARY DetectionConfig {
     Q_PROPERTY(QString modelPath MEMBER modelPath)
     Q_PROPERTY(int batchSize MEMBER batchSize)
     Q_PROPERTY(bool useGPU MEMBER useGPU)
+    Q_PROPERTY(bool pipelined MEMBER pipelined)
+    Q_PROPERTY(int stageQueueCapacity MEMBER stageQueueCapacity)
+    Q_PROPERTY(int maxFramesInFlight MEMBER maxFramesInFlight)
+    Q_PROPERTY(QString overloadPolicy MEMBER overloadPolicy)
+    Q_PROPERTY(int lateThresholdMs MEMBER lateThresholdMs)
+    Q_PROPERTY(double degradeScale MEMBER degradeScale)
+    Q_PROPERTY(int maxDetectDim MEMBER maxDetectDim)
+    Q_PROPERTY(bool tiledDetection MEMBER tiledDetection)
+    Q_PROPERTY(int tileSize MEMBER tileSize)
+    Q_PROPERTY(int tileOverlap MEMBER tileOverlap)
+    Q_PROPERTY(bool coarseToFine MEMBER coarseToFine)
+    Q_PROPERTY(int refinePadding MEMBER refinePadding)
+    Q_PROPERTY(QString roiFile MEMBER roiFile)
+    Q_PROPERTY(bool earlyExit MEMBER earlyExit)
+    Q_PROPERTY(QString earlyExitClasses MEMBER earlyExitClasses)
+    Q_PROPERTY(double earlyExitSeverity MEMBER earlyExitSeverity)
+    Q_PROPERTY(int cpuBudget MEMBER cpuBudget)
+    Q_PROPERTY(int ioThreads MEMBER ioThreads)
+    Q_PROPERTY(QString parallelStrategy MEMBER parallelStrategy)
+    Q_PROPERTY(bool matPooling MEMBER matPooling)
+    Q_PROPERTY(int matPoolMaxMB MEMBER matPoolMaxMB)
 
 public:
     bool enabled = true;
@@ -249,6 +280,27 @@ public:
     QString modelPath = "./models/yolo.onnx";
     int batchSize = 1;
     bool useGPU = false;
+    bool pipelined = false;          // 分阶段流水线模式（采集/预处理/检测/后处理/输出各占一个线程）
+    int stageQueueCapacity = 4;      // 流水线各阶段输入队列容量
+    int maxFramesInFlight = 1;       // 串行模式下允许同时检测的最大帧数（结果按采集顺序输出）
+    QString overloadPolicy = "dropNewest"; // 过载策略: block/dropNewest/dropOldest/degrade
+    int lateThresholdMs = 0;         // 触发到出结果超过此值记为超时帧，0 表示取 2 倍采集间隔
+    double degradeScale = 0.5;       // degrade 策略下的降分辨率比例
+    int maxDetectDim = 1920;         // 检测前缩放的最大边长，0 表示保持原始分辨率
+    bool tiledDetection = false;     // 分块并行检测（大图按重叠分块，跨核并行后合并结果）
+    int tileSize = 1024;             // 分块边长（像素）
+    int tileOverlap = 64;            // 相邻分块重叠宽度（像素），应大于最大缺陷宽度
+    bool coarseToFine = false;       // 由粗到精：缩放图初筛，仅在候选区域用原始分辨率精检
+    int refinePadding = 32;          // 精检区域相对候选框的外扩像素（原始分辨率）
+    QString roiFile;                 // ROI 模板文件（JSON），为空时整帧检测
+    bool earlyExit = false;          // 提前退出：出现致命缺陷即取消其余检测器并判 NG
+    QString earlyExitClasses = "Crack"; // 致命缺陷类别（逗号分隔），出现即判定
+    double earlyExitSeverity = 0.9;  // 任意类别缺陷自身严重度 [0-1] 达到此值即判定（大于 1 关闭）
+    int cpuBudget = 0;               // 计算线程核数预算（线程池/OpenCV 共用），0 表示全部硬件线程
+    int ioThreads = 2;               // I/O 线程数（图像保存等 QtConcurrent 任务）
+    QString parallelStrategy = "auto"; // 检测器并行方式: auto/inter/intra
+    bool matPooling = false;         // 流水线线程的 cv::Mat 临时图像按尺寸级池化复用
+    int matPoolMaxMB = 256;          // 池中空闲图像内存上限（MB）
 
     QJsonObject toJson() const { return gadgetToJson(*this); }
     static DetectionConfig fromJson(const QJsonObject& json) {
@@ -333,6 +385,33 @@ public:
     }
 };
 
+// ============================================================================
+// 线程放置配置（CPU 亲和性与调度优先级）
+// ============================================================================
+
+struct COMMON_LIBRARY ThreadingConfig {
+    Q_GADGET
+    Q_PROPERTY(QString mainCpus MEMBER mainCpus)
+    Q_PROPERTY(QString poolCpus MEMBER poolCpus)
+    Q_PROPERTY(QString poolPolicy MEMBER poolPolicy)
+    Q_PROPERTY(int poolPriority MEMBER poolPriority)
+    Q_PROPERTY(QVariantMap stages MEMBER stages)
+
+public:
+    QString mainCpus;                // 主线程 CPU 集合（如 "0-1"），其后创建的日志/数据库/网络等线程继承，为空不绑定
+    QString poolCpus;                // 全局线程池工作线程 CPU 集合（如 "2-7"），为空不绑定
+    QString poolPolicy = "default";  // 调度策略: default/fifo/rr
+    int poolPriority = 0;            // default 时为 nice 值(-20~19)，fifo/rr 时为实时优先级(1~99)
+    QVariantMap stages;              // 流水线各阶段，如 {"detect": {"cpus": "2", "policy": "fifo", "priority": 50}}
+
+    QJsonObject toJson() const { return gadgetToJson(*this); }
+    static ThreadingConfig fromJson(const QJsonObject& json) {
+        ThreadingConfig cfg;
+        gadgetFromJson(cfg, json);
+        return cfg;
+    }
+};
+
 // ============================================================================
 // 总配置
 // ============================================================================
@@ -344,6 +423,7 @@ struct COMMON_LIBRARY AppConfig {
     UIConfig ui;
     DatabaseConfig database;
     LogConfig log;
+    ThreadingConfig threading;
 
     QJsonObject toJson() const {
         QJsonObject json;
@@ -353,6 +433,7 @@ struct COMMON_LIBRARY AppConfig {
         json["ui"] = ui.toJson();
         json["database"] = database.toJson();
         json["log"] = log.toJson();
+        json["threading"] = threading.toJson();
         return json;
     }
 
@@ -370,6 +451,8 @@ struct COMMON_LIBRARY AppConfig {
             cfg.database = DatabaseConfig::fromJson(json["database"].toObject());
         if (json.contains("log"))
             cfg.log = LogConfig::fromJson(json["log"].toObject());
+        if (json.contains("threading"))
+            cfg.threading = ThreadingConfig::fromJson(json["threading"].toObject());
         return cfg;
     }
 };
@@ -272,6 +272,19 @@ void ConfigManager::setLogConfig(const LogConfig& cfg, bool autoSave) {
     emitChanged("log", autoSave);
 }
 
+ThreadingConfig ConfigManager::threadingConfig() const {
+    QReadLocker locker(&m_lock);
+    return m_config.threading;
+}
+
+void ConfigManager::setThreadingConfig(const ThreadingConfig& cfg, bool autoSave) {
+    {
+        QWriteLocker locker(&m_lock);
+        m_config.threading = cfg;
+    }
+    emitChanged("threading", autoSave);
+}
+
 DetectorsConfig ConfigManager::detectorsConfig() const {
     QReadLocker locker(&m_lock);
     return m_config.detectors;
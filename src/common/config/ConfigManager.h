@@ -101,6 +101,9 @@ public:
     LogConfig logConfig() const;
     void setLogConfig(const LogConfig& cfg, bool autoSave = false);
 
+    ThreadingConfig threadingConfig() const;
+    void setThreadingConfig(const ThreadingConfig& cfg, bool autoSave = false);
+
 signals:
     void configLoaded(const QString& path);
     void configSaved(const QString& path);
@@ -186,6 +186,11 @@ bool DatabaseManager::executeSchema(const QString& schemaPath) {
 
   LOG_INFO("DatabaseManager: Schema executed successfully ({} statements): {}", 
            successCount, schemaPath);
+
+  // 已有数据库的表不会被 CREATE TABLE IF NOT EXISTS 更新，补齐新增列
+  if (m_defectRepo) {
+    m_defectRepo->ensureColumns();
+  }
   return true;
 }
 
@@ -0,0 +1,83 @@
+#include "InspectionWriter.h"
+#include "repositories/DefectRepository.h"
+#include "repositories/IRepository.h"
+#include "common/Types.h"
+#include "common/Logger.h"
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QThread>
+#include <QUuid>
+
+namespace {
+
+// 与界面线程的连接并发访问同一文件时，等待写锁而不是立即返回 SQLITE_BUSY
+const char* const CONNECT_OPTIONS = "QSQLITE_BUSY_TIMEOUT=5000";
+
+} // namespace
+
+InspectionWriter::InspectionWriter(const QString& dbPath)
+    : m_dbPath(dbPath)
+    , m_connectionPrefix(QStringLiteral("writer-") + QUuid::createUuid().toString(QUuid::Id128)) {}
+
+InspectionWriter::~InspectionWriter() {
+  close();
+}
+
+qint64 InspectionWriter::write(const DetectResult& result) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  QString connectionName;
+  DefectRepository* repo = repositoryForCurrentThread(connectionName);
+  if (!repo) {
+    return -1;
+  }
+
+  TransactionGuard transaction(connectionName);
+  const qint64 id = repo->insertFromResult(result, result.imagePath);
+  if (id < 0) {
+    return -1;
+  }
+  if (transaction.isActive() && !transaction.commit()) {
+    LOG_WARN("InspectionWriter: Failed to commit inspection: {}",
+             QSqlDatabase::database(connectionName, false).lastError().text());
+    return -1;
+  }
+  return id;
+}
+
+void InspectionWriter::close() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // 连接属于各写入线程，这里不再取连接对象，只移除（析构时关闭）
+  for (auto& [name, repo] : m_repositories) {
+    repo.reset();
+    QSqlDatabase::removeDatabase(name);
+  }
+  m_repositories.clear();
+}
+
+DefectRepository* InspectionWriter::repositoryForCurrentThread(QString& connectionName) {
+  const QString name = m_connectionPrefix + QLatin1Char('-') +
+                       QString::number(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+  connectionName = name;
+  auto it = m_repositories.find(name);
+  if (it != m_repositories.end()) {
+    return it->second.get();
+  }
+
+  {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", name);
+    db.setDatabaseName(m_dbPath);
+    db.setConnectOptions(CONNECT_OPTIONS);
+    if (!db.open()) {
+      LOG_ERROR("InspectionWriter: Failed to open database {}: {}", m_dbPath, db.lastError().text());
+      db = QSqlDatabase();
+      QSqlDatabase::removeDatabase(name);
+      return nullptr;
+    }
+  }
+
+  LOG_INFO("InspectionWriter: Opened connection {} to {}", name, m_dbPath);
+  auto repo = std::make_unique<DefectRepository>(name);
+  DefectRepository* raw = repo.get();
+  m_repositories.emplace(name, std::move(repo));
+  return raw;
+}
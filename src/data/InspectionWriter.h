@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * InspectionWriter.h
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：检测记录写入器接口定义
+ * 描述：供检测流水线输出阶段在工作线程上写入检测记录与缺陷详情。
+ *       QSqlDatabase 连接只能在创建它的线程使用，写入器为每个调用线程
+ *       打开一个到同一数据库文件的独立连接（首次写入时创建），写入串行化，
+ *       每条记录连同缺陷详情在一个事务内提交
+ *
+ * 当前版本：1.0
+ */
+
+#ifndef INSPECTIONWRITER_H
+#define INSPECTIONWRITER_H
+
+#include "data_global.h"
+#include <QString>
+#include <map>
+#include <memory>
+#include <mutex>
+
+class DefectRepository;
+struct DetectResult;
+
+class DATA_EXPORT InspectionWriter {
+public:
+  explicit InspectionWriter(const QString& dbPath);
+  ~InspectionWriter();
+
+  InspectionWriter(const InspectionWriter&) = delete;
+  InspectionWriter& operator=(const InspectionWriter&) = delete;
+
+  // 线程安全：写入一条检测记录，返回记录 ID，失败返回 -1
+  qint64 write(const DetectResult& result);
+
+  // 关闭全部连接（须在不再有线程调用 write 之后调用）
+  void close();
+
+  QString databasePath() const { return m_dbPath; }
+
+private:
+  // 当前线程的仓库（无连接时打开），调用方持有 m_mutex；connectionName 返回所用连接名
+  DefectRepository* repositoryForCurrentThread(QString& connectionName);
+
+  QString m_dbPath;
+  QString m_connectionPrefix;
+  std::mutex m_mutex;
+  std::map<QString, std::unique_ptr<DefectRepository>> m_repositories;  // 连接名 -> 仓库
+};
+
+#endif // INSPECTIONWRITER_H
@@ -17,6 +17,7 @@ INCLUDEPATH += $$PWD/../../config
 # ------------------ 头文件 ------------------
 HEADERS += \
     DatabaseManager.h \
+    InspectionWriter.h \
     data_global.h \
     export/CSVExporter.h \
     export/ExcelExporter.h \
@@ -33,6 +34,7 @@ HEADERS += \
 # ------------------ 源文件 ------------------
 SOURCES += \
     DatabaseManager.cpp \
+    InspectionWriter.cpp \
     export/CSVExporter.cpp \
     export/ExcelExporter.cpp \
     export/ReportGenerator.cpp \
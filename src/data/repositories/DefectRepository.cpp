@@ -5,6 +5,8 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 DefectRepository::DefectRepository(const QString& connectionName, QObject *parent)
     : QObject{parent}
@@ -25,6 +27,47 @@ int DefectRepository::totalCount() const {
   return 0;
 }
 
+bool DefectRepository::ensureColumns() {
+  QSqlDatabase db = getDatabase(m_connectionName);
+  if (!db.isOpen()) {
+    LOG_WARN("DefectRepository: Database not open, skip column migration");
+    return false;
+  }
+
+  // 检查并添加缺失的列（数据库迁移）
+  struct ColumnDef {
+    QString table;
+    QString name;
+    QString type;
+    QString defaultVal;
+  };
+  QVector<ColumnDef> requiredColumns = {
+      {"batches", "dropped_count", "INTEGER", "0"},
+      {"batches", "late_count", "INTEGER", "0"}
+  };
+
+  bool ok = true;
+  for (const auto& col : requiredColumns) {
+    QSqlQuery checkQuery(db);
+    checkQuery.exec(QString("SELECT %1 FROM %2 LIMIT 1").arg(col.name, col.table));
+    if (checkQuery.lastError().isValid()) {
+      QString alterSql = QString("ALTER TABLE %1 ADD COLUMN %2 %3").arg(col.table, col.name, col.type);
+      if (!col.defaultVal.isEmpty()) {
+        alterSql += QString(" DEFAULT %1").arg(col.defaultVal);
+      }
+      QSqlQuery alterQuery(db);
+      if (!alterQuery.exec(alterSql)) {
+        LOG_WARN("DefectRepository: Failed to add column {}.{}: {}",
+                 col.table, col.name, alterQuery.lastError().text());
+        ok = false;
+      } else {
+        LOG_INFO("DefectRepository: Added missing column: {}.{}", col.table, col.name);
+      }
+    }
+  }
+  return ok;
+}
+
 qint64 DefectRepository::insertInspection(const InspectionRecord& record) {
   QSqlDatabase db = QSqlDatabase::database(m_connectionName);
   if (!db.isOpen()) {
@@ -112,11 +155,15 @@ qint64 DefectRepository::insertFromResult(const DetectResult& result, const QStr
   for (const auto& defect : result.defects) {
     DefectRecord defectRecord;
     defectRecord.inspectionId = inspectionId;
-    defectRecord.defectType = result.defectType;
+    defectRecord.defectType = defect.className.isEmpty() ? result.defectType : defect.className;
     defectRecord.confidence = defect.confidence;
-    defectRecord.severityScore = result.severity;
+    defectRecord.severityScore = defect.severity > 0.0 ? defect.severity : result.severity;
     defectRecord.severityLevel = record.severityLevel;
     defectRecord.region = QRect(defect.bbox.x, defect.bbox.y, defect.bbox.width, defect.bbox.height);
+    if (!defect.features.empty()) {
+      defectRecord.features = QString::fromUtf8(
+          QJsonDocument(QJsonObject::fromVariantMap(defect.attributes())).toJson(QJsonDocument::Compact));
+    }
 
     if (!insertDefect(defectRecord)) {
       LOG_WARN("DefectRepository: Failed to insert defect for inspection {}", inspectionId);
@@ -126,6 +173,60 @@ qint64 DefectRepository::insertFromResult(const DetectResult& result, const QStr
   return inspectionId;
 }
 
+qint64 DefectRepository::insertBatch(BatchRecord& batch) {
+  QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+  if (!db.isOpen()) {
+    LOG_ERROR("DefectRepository: Database not open");
+    return -1;
+  }
+
+  // 批次号冲突（同一时刻多次启停）时追加序号，避免插入失败丢失该批次统计
+  QSqlQuery exists(db);
+  exists.prepare("SELECT 1 FROM batches WHERE batch_no = ?");
+  const QString baseNo = batch.batchNo;
+  for (int suffix = 2;; ++suffix) {
+    exists.bindValue(0, batch.batchNo);
+    if (!exists.exec()) {
+      LOG_ERROR("DefectRepository: Failed to check batch no: {}", exists.lastError().text());
+      return -1;
+    }
+    if (!exists.next()) {
+      break;
+    }
+    batch.batchNo = QString("%1-%2").arg(baseNo).arg(suffix);
+  }
+  exists.finish();
+
+  QSqlQuery query(db);
+  query.prepare(
+    "INSERT INTO batches ("
+    "batch_no, product_type, start_time, end_time, actual_count, "
+    "ok_count, ng_count, dropped_count, late_count, yield_rate, status"
+    ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"
+  );
+
+  query.addBindValue(batch.batchNo);
+  query.addBindValue(batch.productType);
+  query.addBindValue(batch.startTime.isValid() ? batch.startTime : QDateTime::currentDateTime());
+  query.addBindValue(batch.endTime.isValid() ? batch.endTime : QVariant());
+  query.addBindValue(batch.actualCount);
+  query.addBindValue(batch.okCount);
+  query.addBindValue(batch.ngCount);
+  query.addBindValue(batch.droppedCount);
+  query.addBindValue(batch.lateCount);
+  query.addBindValue(batch.yieldRate);
+  query.addBindValue(batch.status.isEmpty() ? QString("completed") : batch.status);
+
+  if (!query.exec()) {
+    LOG_ERROR("DefectRepository: Failed to insert batch: {}", query.lastError().text());
+    return -1;
+  }
+
+  qint64 id = query.lastInsertId().toLongLong();
+  LOG_DEBUG("DefectRepository: Inserted batch id={}, no={}", id, batch.batchNo);
+  return id;
+}
+
 bool DefectRepository::insertDefect(const DefectRecord& defect) {
   QSqlDatabase db = QSqlDatabase::database(m_connectionName);
   if (!db.isOpen()) {
@@ -59,6 +59,22 @@ struct DATA_EXPORT DefectRecord {
   QDateTime createdAt;
 };
 
+// 批次统计结构（对应 batches 表）
+struct DATA_EXPORT BatchRecord {
+  qint64 id = 0;
+  QString batchNo;          // 批次号
+  QString productType;
+  QDateTime startTime;
+  QDateTime endTime;
+  int actualCount = 0;      // 实际检测数
+  int okCount = 0;
+  int ngCount = 0;
+  int droppedCount = 0;     // 过载丢弃（未检测）数
+  int lateCount = 0;        // 超时完成数
+  double yieldRate = 0.0;   // 良率 %
+  QString status;           // running/completed/paused
+};
+
 // 查询过滤条件
 struct DATA_EXPORT InspectionFilter {
   QDateTime startTime;
@@ -84,12 +100,19 @@ public:
   bool isReady() const override;
   int totalCount() const override;
 
+  // 检查并添加旧数据库缺失的列（CREATE TABLE IF NOT EXISTS 不会修改已有表）
+  bool ensureColumns();
+
   // 插入检测记录，返回新记录ID，失败返回-1
   qint64 insertInspection(const InspectionRecord& record);
 
   // 从 DetectResult 插入（便捷方法）
   qint64 insertFromResult(const DetectResult& result, const QString& imagePath = QString());
 
+  // 插入批次统计，返回新记录ID，失败返回-1
+  // batch_no 唯一：已存在时依次追加 -2、-3… 直至不冲突，实际写入的批次号回写到 batch.batchNo
+  qint64 insertBatch(BatchRecord& batch);
+
   // 插入缺陷详情
   bool insertDefect(const DefectRecord& defect);
 
@@ -36,6 +36,32 @@ bool FileCamera::open(const CameraConfig &cfg) {
 }
 
 bool FileCamera::grab(cv::Mat &frame) {
+  QString path;
+  QByteArray data;
+  if (!readNext(path, data)) {
+    return false;
+  }
+  return decode(data, path, frame);
+}
+
+bool FileCamera::grab(FrameBuffer &frame, FramePool &pool) {
+  QString path;
+  QByteArray data;
+  if (!readNext(path, data)) {
+    return false;
+  }
+
+  // 按上一帧尺寸借出缓冲，尺寸一致时 imdecode 直接写入池化内存
+  frame = m_lastSize.empty() ? FrameBuffer(cv::Mat()) : pool.acquire(m_lastSize, CV_8UC3);
+  if (!decode(data, path, frame.mat())) {
+    frame.reset();
+    return false;
+  }
+  m_lastSize = frame.mat().size();
+  return true;
+}
+
+bool FileCamera::readNext(QString &path, QByteArray &data) {
   if (!m_opened || m_imagePaths.isEmpty()) {
     return false;
   }
@@ -51,40 +77,48 @@ bool FileCamera::grab(cv::Mat &frame) {
     }
   }
 
-  const QString &path = m_imagePaths.at(idx);
+  path = m_imagePaths.at(idx);
   m_lastImagePath = path;
+  m_currentIndex.fetch_add(1);
 
   // 使用 Qt 读取文件，避免 OpenCV 对特殊字符路径的兼容性问题
   QFile file(path);
   if (!file.open(QIODevice::ReadOnly)) {
     LOG_WARN("FileCamera: Failed to open image {}", path);
-    m_currentIndex.fetch_add(1);
     return false;
   }
-  QByteArray data = file.readAll();
+  data = file.readAll();
   file.close();
 
   if (data.isEmpty()) {
     LOG_WARN("FileCamera: Empty file {}", path);
-    m_currentIndex.fetch_add(1);
     return false;
   }
+  return true;
+}
 
-  std::vector<uchar> buffer(data.begin(), data.end());
-  frame = cv::imdecode(buffer, cv::IMREAD_COLOR);
-  if (frame.empty()) {
+bool FileCamera::decode(const QByteArray &data, const QString &path, cv::Mat &frame) {
+  // 直接引用文件数据，无需拷贝到 std::vector
+  const cv::Mat buffer(1, data.size(), CV_8UC1, const_cast<char *>(data.constData()));
+
+  // 传入目标 Mat，尺寸类型一致时解码器复用其内存；失败时返回空 Mat，frame 内容不可用
+  bool decoded = !cv::imdecode(buffer, cv::IMREAD_COLOR, &frame).empty();
+  if (!decoded) {
     // 尝试其他解码标志
-    frame = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
-    if (!frame.empty()) {
-      if (frame.channels() == 4) {
-        cv::cvtColor(frame, frame, cv::COLOR_BGRA2BGR);
-      } else if (frame.channels() == 1) {
-        cv::cvtColor(frame, frame, cv::COLOR_GRAY2BGR);
+    cv::Mat raw = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+    if (!raw.empty()) {
+      if (raw.channels() == 4) {
+        cv::cvtColor(raw, frame, cv::COLOR_BGRA2BGR);
+      } else if (raw.channels() == 1) {
+        cv::cvtColor(raw, frame, cv::COLOR_GRAY2BGR);
+      } else {
+        frame = raw;
       }
+      decoded = !frame.empty();
     }
   }
 
-  if (frame.empty()) {
+  if (!decoded) {
     // 只在解码失败时打印详细信息
     QString header;
     for (int i = 0; i < qMin(8, data.size()); ++i) {
@@ -92,11 +126,9 @@ bool FileCamera::grab(cv::Mat &frame) {
     }
     LOG_WARN("FileCamera: Failed to decode {} (size={}bytes, header={})", 
              QFileInfo(path).fileName().toStdString(), data.size(), header.toStdString());
-    m_currentIndex.fetch_add(1);
     return false;
   }
 
-  m_currentIndex.fetch_add(1);
   return true;
 }
 
@@ -18,6 +18,7 @@
 
 #include "ICamera.h"
 #include "hal_global.h"
+#include <QByteArray>
 #include <QStringList>
 #include <atomic>
 
@@ -27,6 +28,7 @@ public:
 
   bool open(const CameraConfig &cfg) override;
   bool grab(cv::Mat &frame) override;
+  bool grab(FrameBuffer &frame, FramePool &pool) override;
   void close() override;
   QString currentImagePath() const override { return m_lastImagePath; }
 
@@ -36,10 +38,13 @@ public:
 
 private:
   bool scanImages(const QString &dir);
+  bool readNext(QString &path, QByteArray &data);
+  bool decode(const QByteArray &data, const QString &path, cv::Mat &frame);
 
   QStringList m_imagePaths;
   std::atomic<int> m_currentIndex{0};
   QString m_lastImagePath;
+  cv::Size m_lastSize;   // 上一帧尺寸，用于按尺寸借出池化缓冲
   bool m_loop = true;
   bool m_opened = false;
 };
@@ -19,6 +19,7 @@
 
 #include <QString>
 #include <opencv2/core.hpp>  // 只需要 cv::Mat
+#include "common/FramePool.h"
 #include "hal_global.h"
 
 struct HAL_EXPORT CameraConfig {
@@ -38,6 +39,18 @@ public:
 
   virtual bool open(const CameraConfig &cfg) = 0;
   virtual bool grab(cv::Mat &frame) = 0;
+
+  // 从帧缓冲池取图；默认包装 grab(cv::Mat&) 的结果（不拷贝、不入池），
+  // 能直接写入池化内存的相机应重写此接口
+  virtual bool grab(FrameBuffer &frame, FramePool &pool) {
+    Q_UNUSED(pool);
+    cv::Mat mat;
+    if (!grab(mat)) {
+      return false;
+    }
+    frame = FrameBuffer(mat);
+    return true;
+  }
   virtual void close() = 0;
 
   // 获取当前图片路径（主要用于 FileCamera）
@@ -2,40 +2,98 @@
 #include "hal/camera/CameraFactory.h"
 #include "hal/camera/ICamera.h"
 #include "DetectorManager.h"
+#include "DetectorGraph.h"
+#include "FrameContext.h"
 #include "preprocess/ImagePreprocessor.h"
+#include "preprocess/ROIManager.h"
 #include "postprocess/NMSFilter.h"
 #include "scoring/DefectScorer.h"
 #include "common/Logger.h"
+#include "common/SPSCQueue.h"
+#include "common/FramePool.h"
+#include "common/ThreadBudget.h"
+#include "common/ThreadPool.h"
 #include <opencv2/imgproc.hpp>  // for resize
 
+#include <algorithm>
+#include <thread>
+
 #include <QMetaType>
+#include <QCoreApplication>
 #include <QTimer>
 #include <QDateTime>
 #include <QFileInfo>
-#include <QtConcurrent/QtConcurrent>
+
+// ============================================================================
+// 流水线内部结构
+// ============================================================================
+
+namespace {
+
+// 阻塞策略下最多挂起的触发数，超出后仍需丢帧
+constexpr size_t MAX_HELD_FRAMES = 64;
+
+// 降分辨率检测的结果换算回正常分辨率坐标
+void rescaleDefects(std::vector<DefectInfo>& defects, double factor) {
+  for (auto& defect : defects) {
+    defect.bbox = cv::Rect(cvRound(defect.bbox.x * factor), cvRound(defect.bbox.y * factor),
+                           cvRound(defect.bbox.width * factor), cvRound(defect.bbox.height * factor));
+    for (auto& pt : defect.contour) {
+      pt = cv::Point(cvRound(pt.x * factor), cvRound(pt.y * factor));
+    }
+    defect.features.scale(factor);
+  }
+}
+
+} // namespace
+
+// 单帧在流水线中的上下文，由各阶段依次填充
+struct DetectPipeline::FrameTask {
+  quint64 sequence = 0;        // 采集序号，取图成功时在相机锁内分配
+  bool sequenced = false;      // 已分配采集序号（未取图的帧不占序号）
+  Timer latency;               // 触发到输出的端到端耗时
+  std::atomic<bool> claimed{false};  // 取图阶段与 dropOldest 取消竞争，先到者得
+  bool cancelled = false;      // 已被 dropOldest 取消（仅 GUI 线程访问）
+  double scale = 1.0;          // degrade 策略下的降分辨率比例
+  double workMs = 0.0;         // 预处理+检测+后处理的实际处理耗时
+  QString imagePath;
+  FrameBuffer frame;           // 原始图像（池化）
+  FrameBuffer displayFrame;    // 缩小后的显示图像（池化）
+  FrameBuffer resized;         // 检测分辨率图像（池化）
+  cv::Mat processed;           // 预处理后的图像
+  std::vector<DefectInfo> defects;
+  bool earlyExit = false;      // 检测阶段因致命缺陷提前退出
+  DetectResult result;
+};
+
+// 流水线阶段：一个工作线程 + 一个有界输入队列
+struct DetectPipeline::Stage {
+  using Handler = bool (DetectPipeline::*)(FrameTask&);
+
+  QString name;
+  Handler handler = nullptr;
+  std::unique_ptr<BlockingSPSCQueue<FrameTaskPtr>> input;
+  std::thread thread;
+  ThreadPlacement placement;
+  Timer uptime;
+  std::atomic<quint64> processed{0};
+  std::atomic<quint64> busyNs{0};
+};
 
 DetectPipeline::DetectPipeline(QObject* parent) : QObject(parent) {
   qRegisterMetaType<DetectResult>("DetectResult");
+  qRegisterMetaType<DetectResultPtr>("DetectResultPtr");
   qRegisterMetaType<cv::Mat>("cv::Mat");
 
   m_captureTimer = new QTimer(this);
   connect(m_captureTimer, &QTimer::timeout, this, &DetectPipeline::onCaptureTimeout);
 
-  // 连接异步检测完成信号
-  connect(&m_detectWatcher, &QFutureWatcher<DetectResult>::finished,
-          this, &DetectPipeline::onDetectionFinished);
-
   initDetectors();
 }
 
 DetectPipeline::~DetectPipeline() {
   stop();
-  
-  // 等待异步检测完成
-  if (m_detectWatcher.isRunning()) {
-    m_detectWatcher.waitForFinished();
-  }
-  
+
   if (m_detectorManager) {
     m_detectorManager->release();
   }
@@ -56,6 +114,7 @@ bool DetectPipeline::initDetectors() {
   m_nmsFilter->setConfidenceThreshold(0.3);
 
   m_scorer = std::make_unique<DefectScorer>();
+  m_roiManager = std::make_unique<ROIManager>();
 
   LOG_INFO("DetectPipeline: Detection components initialized, useRealDetection={}", m_useRealDetection);
   return true;
@@ -72,6 +131,86 @@ void DetectPipeline::setCaptureInterval(int ms) {
   }
 }
 
+void DetectPipeline::setStageQueueCapacity(int capacity) {
+  m_stageQueueCapacity = std::max(1, capacity);
+}
+
+void DetectPipeline::setMaxFramesInFlight(int count) {
+  m_maxFramesInFlight = std::max(1, count);
+}
+
+void DetectPipeline::setCoarseToFine(bool enabled, int padding) {
+  m_coarseToFine = enabled;
+  m_refinePadding = std::max(0, padding);
+}
+
+void DetectPipeline::setEarlyExit(bool enabled, const QString& classes, double minSeverity) {
+  m_earlyExit = enabled;
+  if (!enabled) {
+    m_detectorManager->setEarlyExit(nullptr);
+    return;
+  }
+  // 判定在检测线程中并发执行，规则按值捕获
+  const CriticalDefectRule rule = CriticalDefectRule::fromConfig(classes, minSeverity);
+  m_detectorManager->setEarlyExit([rule](const DefectInfo& defect) { return rule.matches(defect); });
+  LOG_INFO("DetectPipeline: Early exit enabled for classes [{}] or severity >= {:.2f}",
+           rule.classes.join(",").toStdString(), minSeverity);
+}
+
+void DetectPipeline::setParallelStrategy(const QString& strategy) {
+  m_detectorManager->setParallelStrategy(DetectorManager::parallelStrategyFromString(strategy));
+}
+
+void DetectPipeline::setMatPooling(bool enabled, int maxPooledMB) {
+  m_matPooling = enabled;
+  m_matPoolMaxBytes = static_cast<size_t>(std::max(0, maxPooledMB)) * 1024 * 1024;
+}
+
+void DetectPipeline::setDetectorParameters(const QString& detector, const QVariantMap& params) {
+  if (!m_detectorManager) {
+    return;
+  }
+  // "enabled" 是检测器开关而非算法参数，直接作用于检测器（下一帧生效）
+  QVariantMap changed = params;
+  if (changed.contains("enabled")) {
+    const bool enabled = changed.take("enabled").toBool();
+    m_detectorManager->setDetectorEnabled(detector, enabled);
+    LOG_INFO("DetectPipeline: Detector {} {}", detector.toStdString(), enabled ? "enabled" : "disabled");
+  }
+  if (changed.isEmpty()) {
+    return;
+  }
+
+  // 参数面板只提供部分键，其余保持配置加载时的值
+  QVariantMap merged = m_detectorManager->getDetectorParameters(detector);
+  for (auto it = changed.cbegin(); it != changed.cend(); ++it) {
+    merged.insert(it.key(), it.value());
+  }
+  m_detectorManager->setDetectorParameters(detector, merged);
+  LOG_DEBUG("DetectPipeline: Parameters of detector {} updated ({} keys)", detector.toStdString(), changed.size());
+}
+
+void DetectPipeline::setStagePlacement(const QString& stage, const ThreadPlacement& placement) {
+  m_stagePlacements[stage] = placement;
+}
+
+bool DetectPipeline::loadROI(const QString& path) {
+  return m_roiManager->loadFromFile(path);
+}
+
+void DetectPipeline::setTiledDetection(bool enabled, int tileSize, int overlap) {
+  m_tiledDetection = enabled;
+  m_tileSize = std::max(128, tileSize);
+  m_tileOverlap = std::clamp(overlap, 0, m_tileSize / 2 - 1);
+}
+
+DetectPipeline::OverloadPolicy DetectPipeline::overloadPolicyFromString(const QString& name) {
+  if (name.compare("block", Qt::CaseInsensitive) == 0) return OverloadPolicy::Block;
+  if (name.compare("dropOldest", Qt::CaseInsensitive) == 0) return OverloadPolicy::DropOldest;
+  if (name.compare("degrade", Qt::CaseInsensitive) == 0) return OverloadPolicy::Degrade;
+  return OverloadPolicy::DropNewest;
+}
+
 bool DetectPipeline::isRunning() const {
   return m_running;
 }
@@ -87,9 +226,31 @@ void DetectPipeline::start() {
     return;
   }
 
+  m_captureSequence = 0;
+  m_reorderBuffer.reset(0);
+  m_runStats = RunStats();
+  m_runStats.startTime = QDateTime::currentMSecsSinceEpoch();
+  m_latencyStats.reset();
+
+  // 流水线模式只有一个检测阶段；否则最多 m_maxFramesInFlight 帧同时检测，核数预算在各帧间平分
+  ThreadBudget::instance().setConcurrentFrames(m_pipelined ? 1 : m_maxFramesInFlight);
+
+  // 池化分配器安装后只对启用了池化的线程生效，其他线程仍走 OpenCV 标准分配器
+  if (m_matPooling) {
+    PooledMatAllocator& allocator = globalMatAllocator();
+    allocator.setMaxPooledBytes(m_matPoolMaxBytes);
+    allocator.install();
+    allocator.resetStats();
+  }
+
+  if (m_pipelined) {
+    startStages();
+  }
+
   m_running = true;
   m_captureTimer->start(m_captureIntervalMs);
-  LOG_INFO("DetectPipeline started, interval={}ms", m_captureIntervalMs);
+  LOG_INFO("DetectPipeline started, interval={}ms, pipelined={}, maxFramesInFlight={}",
+           m_captureIntervalMs, m_pipelined, m_maxFramesInFlight);
   emit started();
 }
 
@@ -99,16 +260,39 @@ void DetectPipeline::stop() {
   }
 
   m_captureTimer->stop();
-  
-  // 等待异步检测完成
-  if (m_detectWatcher.isRunning()) {
-    m_detectWatcher.waitForFinished();
+
+  // 挂起的触发不会再被检测，计入丢帧
+  if (!m_heldFrames.empty()) {
+    dropFrames(m_heldFrames.size(), "pending on stop");
+    m_heldFrames.clear();
   }
-  m_detecting.store(false);
-  
+
+  stopStages();
+
+  // 等待异步检测完成，并在 stopped 之前发出已完成帧的结果
+  for (auto& future : m_detectFutures) {
+    future.wait();
+  }
+  m_detectFutures.clear();
+  flushFrames();
+
+  m_waitingFrames.clear();
+  m_runStats.endTime = QDateTime::currentMSecsSinceEpoch();
+
   releaseCamera();
   m_running = false;
-  LOG_INFO("DetectPipeline stopped");
+  LOG_INFO("DetectPipeline stopped: triggered={}, inspected={}, dropped={}, failed={}, late={}, degraded={}, "
+           "earlyExits={}, latency avg={:.1f}ms max={:.1f}ms",
+           m_runStats.triggered, m_runStats.inspected, m_runStats.dropped, m_runStats.failed,
+           m_runStats.late, m_runStats.degraded, m_runStats.earlyExits,
+           m_latencyStats.avg(), m_latencyStats.max());
+  if (m_matPooling) {
+    const auto pool = globalMatAllocator().stats();
+    LOG_INFO("DetectPipeline: mat pool allocations={}, hitRate={:.1f}%, misses={}, evictions={}, "
+             "allocated={}MB, peak={}MB, pooled={}MB",
+             pool.allocations, pool.hitRate() * 100.0, pool.misses, pool.evictions,
+             pool.bytesAllocated >> 20, pool.peakBytesInUse >> 20, pool.pooledBytes >> 20);
+  }
   emit stopped();
 }
 
@@ -130,7 +314,10 @@ void DetectPipeline::singleShot() {
     m_currentImagePath = m_camera->currentImagePath();
     emit frameReady(frame);
     DetectResult result = runDetection(frame);
-    emit resultReady(result);
+    if (m_resultRecorder) {
+      m_resultRecorder(result);
+    }
+    emit resultReady(std::make_shared<const DetectResult>(std::move(result)));
   } else {
     emit error("camera", "Failed to grab frame");
   }
@@ -141,51 +328,138 @@ void DetectPipeline::onCaptureTimeout() {
     return;
   }
 
-  // 如果上一次检测还未完成，跳过本次
-  if (m_detecting.load()) {
+  ++m_runStats.triggered;
+  auto task = std::make_shared<FrameTask>();
+  task->latency.start();
+
+  // 先补发之前挂起的触发，保证按触发顺序检测
+  releaseHeldFrames();
+
+  if (m_heldFrames.empty() && admissionLoad() < admissionLimit()) {
+    // degrade 策略下流水线队列过半即开始降分辨率
+    if (m_overloadPolicy == OverloadPolicy::Degrade && m_stagesRunning.load() &&
+        admissionLoad() * 2 >= admissionLimit()) {
+      task->scale = m_degradeScale;
+    }
+    submitFrame(task);
     return;
   }
 
-  m_detecting.store(true);
-  
-  // 整个抓取+检测流程都在后台线程执行
-  QFuture<DetectResult> future = QtConcurrent::run([this]() {
-    cv::Mat frame;
-    if (!m_camera || !m_camera->grab(frame) || frame.empty()) {
-      DetectResult result;
-      result.isOK = true;
-      return result;
+  // 过载：检测跟不上触发节拍
+  switch (m_overloadPolicy) {
+    case OverloadPolicy::Block:
+      if (m_heldFrames.size() < MAX_HELD_FRAMES) {
+        m_heldFrames.push_back(task);
+        return;
+      }
+      dropFrames(1, "held trigger limit reached");
+      return;
+
+    case OverloadPolicy::DropOldest:
+      // 被取消的帧完成占位后释放名额，本次触发挂起等待补发
+      if (cancelOldestFrame()) {
+        m_heldFrames.push_back(task);
+        return;
+      }
+      dropFrames(1, "no cancellable frame");
+      return;
+
+    case OverloadPolicy::Degrade:
+      // 串行模式允许降分辨率超发至 2 倍并发上限；流水线队列满时无法再投递
+      if (!m_stagesRunning.load() && admissionLoad() < admissionLimit() * 2) {
+        task->scale = m_degradeScale;
+        submitFrame(task);
+        return;
+      }
+      dropFrames(1, "degrade limit reached");
+      return;
+
+    case OverloadPolicy::DropNewest:
+      dropFrames(1, "overload");
+      return;
+  }
+}
+
+size_t DetectPipeline::admissionLoad() const {
+  if (m_stagesRunning.load()) {
+    return m_stages.front()->input->size();
+  }
+  return static_cast<size_t>(std::max(0, m_framesInFlight.load()));
+}
+
+size_t DetectPipeline::admissionLimit() const {
+  if (m_stagesRunning.load()) {
+    return m_stages.front()->input->capacity();
+  }
+  return static_cast<size_t>(m_maxFramesInFlight);
+}
+
+void DetectPipeline::submitFrame(const FrameTaskPtr& task) {
+  if (m_stagesRunning.load()) {
+    // 流水线模式：只负责投递采集任务，取图由采集阶段完成
+    if (!m_stages.front()->input->tryPush(task)) {
+      dropFrames(1, "acquire queue full");
+      return;
     }
-    
-    m_currentImagePath = m_camera->currentImagePath();
-    
-    // 缩小图片用于显示，避免大图阻塞UI
-    cv::Mat displayFrame = frame;
-    const int MAX_DISPLAY = 1280;
-    if (frame.cols > MAX_DISPLAY || frame.rows > MAX_DISPLAY) {
-      double scale = std::min(static_cast<double>(MAX_DISPLAY) / frame.cols,
-                              static_cast<double>(MAX_DISPLAY) / frame.rows);
-      cv::resize(frame, displayFrame, cv::Size(), scale, scale, cv::INTER_AREA);
+  } else {
+    // 清理已完成的任务句柄
+    m_detectFutures.erase(std::remove_if(m_detectFutures.begin(), m_detectFutures.end(),
+                                         [](const std::future<void>& f) {
+                                           return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                                         }),
+                          m_detectFutures.end());
+
+    // 整个抓取+检测流程都在工作窃取线程池中执行，每帧上下文独立；
+    // 帧内检测的并行子任务优先进入本线程队列，空闲线程再窃取
+    m_detectFutures.push_back(globalThreadPool().submit([this, task]() { runFrame(task); }));
+  }
+
+  m_framesInFlight.fetch_add(1);
+  if (m_overloadPolicy == OverloadPolicy::DropOldest) {
+    // 剔除已开始取图或已完成的帧，只保留可取消的候选
+    while (!m_waitingFrames.empty()) {
+      FrameTaskPtr front = m_waitingFrames.front().lock();
+      if (front && !front->claimed.load()) break;
+      m_waitingFrames.pop_front();
     }
-    m_pendingFrame = displayFrame;
-    
-    return runDetection(frame);
-  });
-  m_detectWatcher.setFuture(future);
+    m_waitingFrames.push_back(task);
+  }
 }
 
-void DetectPipeline::onDetectionFinished() {
-  m_detecting.store(false);
-  
-  if (m_detectWatcher.future().isValid()) {
-    // 发射缩小后的图片用于显示
-    if (!m_pendingFrame.empty()) {
-      emit frameReady(m_pendingFrame);
+void DetectPipeline::releaseHeldFrames() {
+  while (!m_heldFrames.empty() && admissionLoad() < admissionLimit()) {
+    FrameTaskPtr task = m_heldFrames.front();
+    m_heldFrames.pop_front();
+    submitFrame(task);
+  }
+}
+
+bool DetectPipeline::cancelOldestFrame() {
+  while (!m_waitingFrames.empty()) {
+    FrameTaskPtr task = m_waitingFrames.front().lock();
+    m_waitingFrames.pop_front();
+
+    // 已开始取图的帧无法取消
+    if (task && !task->claimed.exchange(true)) {
+      task->cancelled = true;
+      dropFrames(1, "cancelled by newer frame");
+      return true;
     }
-    
-    DetectResult result = m_detectWatcher.result();
-    emit resultReady(result);
   }
+  return false;
+}
+
+void DetectPipeline::dropFrames(quint64 count, const char* reason) {
+  m_runStats.dropped += count;
+  if (m_dropLogThrottle.check()) {
+    LOG_WARN("DetectPipeline: frame dropped ({}), total dropped={}, inFlight={}",
+             reason, m_runStats.dropped, m_framesInFlight.load());
+  }
+  emit frameDropped(m_runStats.dropped);
+}
+
+double DetectPipeline::lateThresholdMs() const {
+  return m_lateThresholdMs > 0 ? m_lateThresholdMs : 2.0 * m_captureIntervalMs;
 }
 
 bool DetectPipeline::initCamera() {
@@ -216,36 +490,209 @@ void DetectPipeline::releaseCamera() {
 }
 
 DetectResult DetectPipeline::runDetection(const cv::Mat& frame) {
-  // 开始计时
-  m_detectTimer.restart();
+  Timer timer;
+  timer.start();
+
+  std::vector<DefectInfo> defects;
+  bool earlyExit = false;
+  if (m_useRealDetection && m_detectorManager) {
+    FrameBuffer resized;
+    defects = detectDefects(prepareFrame(frame, 1.0, resized), frame, &earlyExit);
+  }
+  DetectResult result = evaluateDefects(std::move(defects), frame.size(), earlyExit);
+
+  timer.stop();
+  result.imagePath = m_currentImagePath;
+  finishResult(result, timer.elapsedMs(), m_currentImagePath);
+  return result;
+}
+
+cv::Mat DetectPipeline::prepareFrame(const cv::Mat& frame, double scale, FrameBuffer& buffer) {
+  // 0. 缩放大图以避免处理过慢（scale < 1 时在此基础上进一步降分辨率）
+  cv::Mat resized = frame;
+  const int maxDim = m_maxDetectDim;  // 最大边长限制（0 不限制）
+  if (maxDim > 0 && (frame.cols > maxDim || frame.rows > maxDim)) {
+    scale *= std::min(static_cast<double>(maxDim) / frame.cols,
+                      static_cast<double>(maxDim) / frame.rows);
+  }
+  if (scale < 1.0) {
+    // 缩放结果写入池化缓冲，buffer 需在检测完成前保持有效
+    cv::Size dsize(cvRound(frame.cols * scale), cvRound(frame.rows * scale));
+    buffer = globalFramePool().acquire(dsize, frame.type());
+    cv::resize(frame, buffer.mat(), dsize, 0, 0, cv::INTER_AREA);
+    resized = buffer.mat();
+    LOG_DEBUG("DetectPipeline: Resized image from {}x{} to {}x{}",
+              frame.cols, frame.rows, resized.cols, resized.rows);
+  }
+
+  // 1. 预处理
+  return m_preprocessor ? m_preprocessor->process(resized) : resized;
+}
+
+std::vector<DefectInfo> DetectPipeline::detectDefects(const cv::Mat& processed, const cv::Mat& frame,
+                                                      bool* earlyExit) {
+  // ROI 按检测分辨率编译（带缓存），ROI 外像素不参与检测
+  const double coarseScale = frame.empty() ? 1.0 : static_cast<double>(processed.cols) / frame.cols;
+  const auto roi = m_roiManager->compile(processed.size(), coarseScale);
+  if (roi && roi->empty()) {
+    return {};
+  }
+
+  // 2. 执行检测（并行；分块模式下按分块跨核并行）
+  DetectorManager::CombinedResult detectResult;
+  if (m_tiledDetection) {
+    DetectorManager::TileOptions options;
+    options.tileSize = m_tileSize;
+    options.overlap = m_tileOverlap;
+    detectResult = m_detectorManager->detectTiled(processed, options, roi.get());
+  } else if (roi) {
+    detectResult = m_detectorManager->detectInROI(processed, *roi);
+  } else {
+    detectResult = m_detectorManager->detectAllParallel(processed);
+  }
+
+  if (earlyExit) {
+    *earlyExit = detectResult.earlyExit;
+  }
+
+  // 2.5 由粗到精：低分辨率结果仅作为候选，在原图对应区域重新精检（已提前判定 NG 时跳过）
+  if (m_coarseToFine && !detectResult.earlyExit && coarseScale < 1.0 && !detectResult.allDefects.empty()) {
+    return refineDefects(detectResult.allDefects, detectResult.defectSources, frame, coarseScale);
+  }
+  return std::move(detectResult.allDefects);
+}
+
+std::vector<DefectInfo> DetectPipeline::refineDefects(std::vector<DefectInfo>& coarseDefects,
+                                                      const std::vector<QString>& sources,
+                                                      const cv::Mat& frame, double coarseScale) {
+  Timer timer;
+  timer.start();
 
+  // 精检任务：某个检测器在原图某个区域上重新检测
+  struct RefineJob {
+    QString detector;
+    cv::Rect region;                      // 原图坐标
+    std::vector<size_t> candidates;       // 该区域内的粗检结果在 coarseDefects 中的下标
+    DetectionResult refined;
+  };
+
+  // 按检测器分组粗检结果
+  std::map<QString, std::vector<size_t>> bySource;
+  for (size_t i = 0; i < coarseDefects.size() && i < sources.size(); ++i) {
+    bySource[sources[i]].push_back(i);
+  }
+
+  const cv::Rect frameRect(0, 0, frame.cols, frame.rows);
+  std::vector<DefectInfo> defects;
+  std::vector<RefineJob> jobs;
+  for (const auto& [name, indices] : bySource) {
+    // 整件测量类检测器（尺寸测量）需要完整工件轮廓，且标定系数对应检测分辨率，
+    // 在原图裁剪上重跑会得到错误的测量值，直接保留粗检结果
+    const DetectorPtr detector = m_detectorManager->getDetector(name);
+    if (detector && !detector->supportsTiling()) {
+      for (size_t index : indices) {
+        defects.push_back(std::move(coarseDefects[index]));
+      }
+      continue;
+    }
+
+    // 候选框换算到原图并外扩，重叠区域合并，避免同一区域重复精检
+    std::vector<RefineJob> regions;
+    for (size_t index : indices) {
+      const DefectInfo& defect = coarseDefects[index];
+      cv::Rect region(cvFloor(defect.bbox.x / coarseScale) - m_refinePadding,
+                      cvFloor(defect.bbox.y / coarseScale) - m_refinePadding,
+                      cvCeil(defect.bbox.width / coarseScale) + 2 * m_refinePadding,
+                      cvCeil(defect.bbox.height / coarseScale) + 2 * m_refinePadding);
+      region &= frameRect;
+      if (region.empty()) {
+        continue;
+      }
+      RefineJob job;
+      job.detector = name;
+      job.region = region;
+      job.candidates.push_back(index);
+      for (bool merged = true; merged; ) {
+        merged = false;
+        for (auto it = regions.begin(); it != regions.end(); ++it) {
+          if ((it->region & job.region).area() > 0) {
+            job.region |= it->region;
+            job.candidates.insert(job.candidates.end(), it->candidates.begin(), it->candidates.end());
+            regions.erase(it);
+            merged = true;
+            break;
+          }
+        }
+      }
+      regions.push_back(std::move(job));
+    }
+    jobs.insert(jobs.end(), std::make_move_iterator(regions.begin()),
+                std::make_move_iterator(regions.end()));
+  }
+
+  // 各区域并行精检（原图裁剪为视图，不拷贝像素；ROI 掩膜按原图分辨率裁剪）
+  const auto roi = m_roiManager->compile(frame.size(), 1.0);
+  const cv::Mat roiMask = roi ? roi->mask : cv::Mat();
+  DetectorGraph graph;
+  for (auto& job : jobs) {
+    graph.addNode(job.detector, [this, &job, &frame, &roiMask]() {
+      cv::Mat crop = frame(job.region);
+      cv::Mat processed = m_preprocessor ? m_preprocessor->process(crop) : crop;
+      FrameContext ctx(processed, roiMask.empty() ? cv::Mat() : roiMask(job.region));
+      job.refined = m_detectorManager->detectWith(job.detector, ctx);
+    }, static_cast<double>(job.region.area()));
+  }
+  ThreadBudget& budget = ThreadBudget::instance();
+  budget.applyOpenCV();
+  graph.run(budget.perFrameParallelism());
+
+  // 精检结果映射回检测分辨率坐标；精检失败时保留粗检结果
+  size_t candidateCount = 0;
+  size_t refinedArea = 0;
+  for (auto& job : jobs) {
+    candidateCount += job.candidates.size();
+    refinedArea += static_cast<size_t>(job.region.area());
+    if (!job.refined.success) {
+      LOG_WARN("DetectPipeline: Refinement by {} failed: {}, keeping coarse result",
+               job.detector.toStdString(), job.refined.errorMessage.toStdString());
+      for (size_t index : job.candidates) {
+        defects.push_back(std::move(coarseDefects[index]));
+      }
+      continue;
+    }
+    const cv::Point offset = job.region.tl();
+    for (auto& defect : job.refined.defects) {
+      defect.bbox += offset;
+      for (auto& pt : defect.contour) {
+        pt += offset;
+      }
+    }
+    rescaleDefects(job.refined.defects, coarseScale);
+    defects.insert(defects.end(), std::make_move_iterator(job.refined.defects.begin()),
+                   std::make_move_iterator(job.refined.defects.end()));
+  }
+
+  timer.stop();
+  LOG_DEBUG("DetectPipeline: Refined {} candidates in {} regions ({:.1f}% of frame) -> {} defects, {:.1f}ms",
+            candidateCount, jobs.size(), 100.0 * refinedArea / std::max(1, frameRect.area()),
+            defects.size(), timer.elapsedMs());
+  return defects;
+}
+
+DetectResult DetectPipeline::evaluateDefects(std::vector<DefectInfo> defects, const cv::Size& frameSize,
+                                             bool earlyExit) {
   DetectResult result;
   result.timestamp = QDateTime::currentDateTime().toMSecsSinceEpoch();
+  result.earlyExit = earlyExit;
 
   if (m_useRealDetection && m_detectorManager) {
     // 使用真实检测
-    
-    // 0. 缩放大图以避免处理过慢
-    cv::Mat resized = frame;
-    const int MAX_DIM = 1920;  // 最大边长限制
-    if (frame.cols > MAX_DIM || frame.rows > MAX_DIM) {
-      double scale = std::min(static_cast<double>(MAX_DIM) / frame.cols,
-                              static_cast<double>(MAX_DIM) / frame.rows);
-      cv::resize(frame, resized, cv::Size(), scale, scale, cv::INTER_AREA);
-      LOG_DEBUG("DetectPipeline: Resized image from {}x{} to {}x{}",
-                frame.cols, frame.rows, resized.cols, resized.rows);
-    }
-    
-    // 1. 预处理
-    cv::Mat processed = m_preprocessor ? m_preprocessor->process(resized) : resized;
 
-    // 2. 执行检测（并行）
-    auto detectResult = m_detectorManager->detectAllParallel(processed);
-
-    // 3. NMS 去重
-    std::vector<DefectInfo> filteredDefects = detectResult.allDefects;
-    if (m_nmsFilter && !filteredDefects.empty()) {
-      filteredDefects = m_nmsFilter->filterByClass(filteredDefects);
+    // 3. NMS 去重（提前退出时结果不完整且已判定 NG，跳过）
+    const size_t rawCount = defects.size();
+    std::vector<DefectInfo> filteredDefects = std::move(defects);
+    if (m_nmsFilter && !filteredDefects.empty() && !earlyExit) {
+      filteredDefects = m_nmsFilter->filterByClass(std::move(filteredDefects));
     }
 
     // 3.5 限制缺陷数量，避免过多缺陷导致性能问题
@@ -258,7 +705,7 @@ DetectResult DetectPipeline::runDetection(const cv::Mat& frame) {
                 });
       filteredDefects.resize(MAX_DEFECTS);
       LOG_WARN("DetectPipeline: Too many defects ({}), keeping top {}", 
-               detectResult.allDefects.size(), MAX_DEFECTS);
+               rawCount, MAX_DEFECTS);
     }
 
     // 4. 评分
@@ -294,18 +741,12 @@ DetectResult DetectPipeline::runDetection(const cv::Mat& frame) {
           maxSeverity = defect.severity;
           result.defectType = defect.className;
         }
-
-        // 转换为 DefectRegion
-        DefectRegion region;
-        region.bbox = defect.bbox;
-        region.confidence = defect.confidence;
-        region.classId = defect.classId;
-        result.defects.push_back(region);
-        result.regions.push_back(defect.bbox);
       }
 
       result.severity = maxSeverity;
       result.confidence = filteredDefects[0].confidence;
+      // 缺陷原样移入结果（含轮廓与特征），不再转换为仅含框的精简结构
+      result.defects = std::move(filteredDefects);
     } else {
       result.level = SeverityLevel::OK;
       result.severity = 0.0;
@@ -334,17 +775,18 @@ DetectResult DetectPipeline::runDetection(const cv::Mat& frame) {
 
       int numDefects = 1 + rand() % 3;
       for (int i = 0; i < numDefects; ++i) {
-        DefectRegion defect;
+        DefectInfo defect;
         defect.bbox = cv::Rect(
-          rand() % std::max(1, frame.cols - 100),
-          rand() % std::max(1, frame.rows - 100),
+          rand() % std::max(1, frameSize.width - 100),
+          rand() % std::max(1, frameSize.height - 100),
           50 + rand() % 100,
           50 + rand() % 100
         );
         defect.confidence = 0.75 + (rand() % 25) / 100.0;
         defect.classId = rand() % 4;
-        result.defects.push_back(defect);
-        result.regions.push_back(defect.bbox);
+        defect.className = defectTypes[defect.classId];
+        defect.severity = result.severity;
+        result.defects.push_back(std::move(defect));
       }
       result.confidence = 0.75 + (rand() % 25) / 100.0;
     } else {
@@ -354,16 +796,18 @@ DetectResult DetectPipeline::runDetection(const cv::Mat& frame) {
     }
   }
 
+  return result;
+}
+
+void DetectPipeline::finishResult(DetectResult& result, double elapsedMs, const QString& imagePath) {
   // 记录检测耗时
-  m_detectTimer.stop();
-  double detectTimeMs = m_detectTimer.elapsedMs();
-  m_detectStats.record(detectTimeMs);
-  result.cycleTimeMs = static_cast<int>(detectTimeMs);
+  m_detectStats.record(elapsedMs);
+  result.cycleTimeMs = static_cast<int>(elapsedMs);
   
   // 详细日志
   if (result.isOK) {
     LOG_INFO("DetectPipeline: OK - image={}, time={:.1f}ms (avg:{:.1f}ms, max:{:.1f}ms)",
-             m_currentImagePath.toStdString(), detectTimeMs, m_detectStats.avg(), m_detectStats.max());
+             imagePath.toStdString(), elapsedMs, m_detectStats.avg(), m_detectStats.max());
   } else {
     // 统计各类缺陷数量
     std::map<int, int> defectCounts;
@@ -377,9 +821,322 @@ DetectResult DetectPipeline::runDetection(const cv::Mat& frame) {
     }
     
     LOG_WARN("DetectPipeline: NG - image={}, type={}, severity={:.2f}, defects={} [{}], time={:.1f}ms",
-             m_currentImagePath.toStdString(), result.defectType.toStdString(), 
-             result.severity, result.defects.size(), countStr, detectTimeMs);
+             imagePath.toStdString(), result.defectType.toStdString(), 
+             result.severity, result.defects.size(), countStr, elapsedMs);
   }
+}
 
-  return result;
+// ============================================================================
+// 帧完成与按序输出
+// ============================================================================
+
+void DetectPipeline::runFrame(const FrameTaskPtr& task) {
+  ScopedMatPooling pooling(m_matPooling);
+  bool ok = false;
+  try {
+    ok = acquireStage(*task) && preprocessStage(*task) && detectStage(*task) &&
+         postprocessStage(*task) && outputStage(*task);
+  } catch (const std::exception& e) {
+    LOG_ERROR("DetectPipeline: frame #{} failed: {}", task->sequence, e.what());
+  }
+  completeFrame(task, ok);
+}
+
+void DetectPipeline::completeFrame(const FrameTaskPtr& task, bool ok) {
+  // 回到 GUI 线程处理，重排缓冲区与统计都只在 GUI 线程访问
+  if (!m_completions.push(FrameCompletion{task, ok})) {
+    QMetaObject::invokeMethod(this, [this, task, ok]() {
+      deliverFrame(task, ok);
+    }, Qt::QueuedConnection);
+    return;
+  }
+  // 已有待处理批次时由其一并取出，不再逐帧投递事件
+  if (!m_completionDrainPending.exchange(true)) {
+    QMetaObject::invokeMethod(this, [this]() { drainCompletions(); }, Qt::QueuedConnection);
+  }
+}
+
+void DetectPipeline::drainCompletions() {
+  // 先清除标记再取：清除之后入队的帧会重新投递事件，不会遗漏
+  m_completionDrainPending.store(false);
+  FrameCompletion completion;
+  while (m_completions.pop(completion)) {
+    deliverFrame(completion.task, completion.ok);
+    completion.task.reset();
+  }
+}
+
+void DetectPipeline::deliverFrame(const FrameTaskPtr& task, bool ok) {
+  m_framesInFlight.fetch_sub(1);
+
+  // 已取图但后续失败的帧也要占位，否则后续帧会一直等待该序号；
+  // 取图前被取消或取图失败的帧没有序号，不占位
+  if (ok) {
+    m_reorderBuffer.push(task->sequence, task);
+  } else {
+    if (!task->cancelled) {
+      ++m_runStats.failed;
+    }
+    if (task->sequenced) {
+      m_reorderBuffer.skip(task->sequence);
+    }
+  }
+
+  FrameTaskPtr ready;
+  while (m_reorderBuffer.pop(ready)) {
+    DetectResult result = std::move(ready->result);
+
+    // 端到端延迟包含排队与重排等待
+    const double latencyMs = ready->latency.elapsedMs();
+    m_latencyStats.record(latencyMs);
+    result.late = latencyMs > lateThresholdMs();
+
+    ++m_runStats.inspected;
+    if (result.isOK) ++m_runStats.okCount; else ++m_runStats.ngCount;
+    if (result.late) ++m_runStats.late;
+    if (result.degraded) ++m_runStats.degraded;
+    if (result.earlyExit) ++m_runStats.earlyExits;
+    m_currentImagePath = ready->imagePath;
+    finishResult(result, ready->workMs, ready->imagePath);
+
+    // 发射缩小后的图片用于显示
+    if (!ready->displayFrame.empty()) {
+      emit frameReady(ready->displayFrame.mat());
+    }
+    emit resultReady(std::make_shared<const DetectResult>(std::move(result)));
+  }
+
+  // 名额释放后补发挂起的触发
+  if (m_running) {
+    releaseHeldFrames();
+  }
+}
+
+void DetectPipeline::flushFrames() {
+  // 处理工作线程已投递但尚未执行的完成回调
+  QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+
+  // 停止时被丢弃于队列中（未完成）或滞留在重排缓冲区（等待前序帧）的帧计入丢帧
+  const quint64 lost = static_cast<quint64>(std::max(0, m_framesInFlight.load())) +
+                       m_reorderBuffer.pendingCount();
+  if (lost > 0) {
+    LOG_WARN("DetectPipeline: {} frames discarded on stop, next sequence={}",
+             lost, m_reorderBuffer.nextSequence());
+    dropFrames(lost, "discarded on stop");
+  }
+  {
+    // 工作线程均已结束，加锁只为与取图侧的访问约定一致
+    QMutexLocker locker(&m_cameraMutex);
+    m_reorderBuffer.reset(m_captureSequence);
+  }
+  m_framesInFlight.store(0);
+}
+
+// ============================================================================
+// 流水线模式
+// ============================================================================
+
+void DetectPipeline::startStages() {
+  if (m_stagesRunning.load()) {
+    return;
+  }
+
+  // BlockingSPSCQueue 停止后不可复用，每次启动重新创建各阶段
+  const std::pair<const char*, Stage::Handler> layout[] = {
+    {"acquire",     &DetectPipeline::acquireStage},
+    {"preprocess",  &DetectPipeline::preprocessStage},
+    {"detect",      &DetectPipeline::detectStage},
+    {"postprocess", &DetectPipeline::postprocessStage},
+    {"output",      &DetectPipeline::outputStage},
+  };
+
+  m_stages.clear();
+  for (const auto& [name, handler] : layout) {
+    auto stage = std::make_unique<Stage>();
+    stage->name = name;
+    stage->handler = handler;
+    auto placement = m_stagePlacements.find(stage->name);
+    if (placement != m_stagePlacements.end()) {
+      stage->placement = placement->second;
+    }
+    stage->input = std::make_unique<BlockingSPSCQueue<FrameTaskPtr>>(
+        static_cast<size_t>(m_stageQueueCapacity));
+    m_stages.push_back(std::move(stage));
+  }
+
+  m_stagesRunning.store(true);
+  for (size_t i = 0; i < m_stages.size(); ++i) {
+    m_stages[i]->uptime.start();
+    m_stages[i]->thread = std::thread(&DetectPipeline::runStage, this, i);
+  }
+
+  LOG_INFO("DetectPipeline: {} stages started, queueCapacity={}",
+           m_stages.size(), m_stageQueueCapacity);
+}
+
+void DetectPipeline::stopStages() {
+  if (!m_stagesRunning.exchange(false)) {
+    return;
+  }
+
+  // 先停止全部队列，解除阻塞在 push/pop 上的阶段线程
+  for (auto& stage : m_stages) {
+    stage->input->stop();
+  }
+  for (auto& stage : m_stages) {
+    if (stage->thread.joinable()) {
+      stage->thread.join();
+    }
+    stage->uptime.stop();
+  }
+
+  for (const auto& status : stageStatus()) {
+    LOG_INFO("DetectPipeline: stage {} processed={}, avg={:.1f}ms, busy={:.0f}%",
+             status.name.toStdString(), status.processed, status.avgMs, status.busyRatio * 100.0);
+  }
+}
+
+void DetectPipeline::runStage(size_t index) {
+  Stage& stage = *m_stages[index];
+  Stage* next = index + 1 < m_stages.size() ? m_stages[index + 1].get() : nullptr;
+  ThreadAffinity::applyToCurrentThread(stage.placement, "DetectPipeline." + stage.name.toStdString());
+  ScopedMatPooling pooling(m_matPooling);
+
+  while (m_stagesRunning.load()) {
+    FrameTaskPtr task;
+    if (!stage.input->tryPopFor(task, std::chrono::milliseconds(50))) {
+      continue;
+    }
+
+    Timer timer;
+    timer.start();
+    bool forward = false;
+    try {
+      forward = (this->*stage.handler)(*task);
+    } catch (const std::exception& e) {
+      LOG_ERROR("DetectPipeline: stage {} failed on frame #{}: {}",
+                stage.name.toStdString(), task->sequence, e.what());
+    }
+    timer.stop();
+
+    stage.busyNs.fetch_add(static_cast<quint64>(timer.elapsedNs()));
+    stage.processed.fetch_add(1);
+
+    // 下游队列满时阻塞，形成背压，最终体现为采集队列满而跳帧
+    if (!forward) {
+      completeFrame(task, false);
+    } else if (next) {
+      next->input->push(std::move(task));
+    } else {
+      completeFrame(task, true);
+    }
+  }
+}
+
+bool DetectPipeline::acquireStage(FrameTask& task) {
+  // 已被 dropOldest 取消
+  if (task.claimed.exchange(true)) {
+    return false;
+  }
+
+  {
+    // 序号与图像路径在取图的同一临界区内分配：多帧并发取图时输出顺序即实际采集顺序
+    QMutexLocker locker(&m_cameraMutex);
+    if (!m_camera || !m_camera->grab(task.frame, globalFramePool()) || task.frame.empty()) {
+      return false;
+    }
+    task.imagePath = m_camera->currentImagePath();
+    task.sequence = m_captureSequence++;
+    task.sequenced = true;
+  }
+
+  // 缩小图片用于显示，避免大图阻塞UI
+  const cv::Mat& frame = task.frame.mat();
+  task.displayFrame = task.frame;
+  const int MAX_DISPLAY = 1280;
+  if (frame.cols > MAX_DISPLAY || frame.rows > MAX_DISPLAY) {
+    double scale = std::min(static_cast<double>(MAX_DISPLAY) / frame.cols,
+                            static_cast<double>(MAX_DISPLAY) / frame.rows);
+    cv::Size dsize(cvRound(frame.cols * scale), cvRound(frame.rows * scale));
+    task.displayFrame = globalFramePool().acquire(dsize, frame.type());
+    cv::resize(frame, task.displayFrame.mat(), dsize, 0, 0, cv::INTER_AREA);
+  }
+  return true;
+}
+
+bool DetectPipeline::preprocessStage(FrameTask& task) {
+  Timer timer;
+  timer.start();
+  if (m_useRealDetection && m_detectorManager) {
+    task.processed = prepareFrame(task.frame.mat(), task.scale, task.resized);
+  }
+  timer.stop();
+  task.workMs += timer.elapsedMs();
+  return true;
+}
+
+bool DetectPipeline::detectStage(FrameTask& task) {
+  Timer timer;
+  timer.start();
+  if (m_useRealDetection && m_detectorManager) {
+    task.defects = detectDefects(task.processed, task.frame.mat(), &task.earlyExit);
+    if (task.scale < 1.0) {
+      rescaleDefects(task.defects, 1.0 / task.scale);
+    }
+  }
+  task.processed.release();
+  task.resized.reset();
+  timer.stop();
+  task.workMs += timer.elapsedMs();
+  return true;
+}
+
+bool DetectPipeline::postprocessStage(FrameTask& task) {
+  Timer timer;
+  timer.start();
+  task.result = evaluateDefects(std::move(task.defects), task.frame.mat().size(), task.earlyExit);
+  task.frame.reset();
+  timer.stop();
+  task.workMs += timer.elapsedMs();
+  return true;
+}
+
+bool DetectPipeline::outputStage(FrameTask& task) {
+  // 持久化前补齐帧信息（超时标记依赖重排等待，在 GUI 线程输出时才确定，不入库）
+  task.result.sequence = task.sequence;
+  task.result.imagePath = task.imagePath;
+  task.result.degraded = task.scale < 1.0;
+  task.result.cycleTimeMs = static_cast<int>(task.workMs);
+
+  Timer timer;
+  timer.start();
+  if (m_resultRecorder) {
+    m_resultRecorder(task.result);
+  }
+  timer.stop();
+
+  LOG_DEBUG("DetectPipeline: frame #{} latency={:.1f}ms, work={:.1f}ms, record={:.1f}ms",
+            task.sequence, task.latency.elapsedMs(), task.workMs, timer.elapsedMs());
+  return true;
+}
+
+std::vector<DetectPipeline::StageStatus> DetectPipeline::stageStatus() const {
+  std::vector<StageStatus> statuses;
+  statuses.reserve(m_stages.size());
+  for (const auto& stage : m_stages) {
+    StageStatus status;
+    status.name = stage->name;
+    status.queueDepth = stage->input->size();
+    status.queueCapacity = stage->input->capacity();
+    status.occupancy = status.queueCapacity > 0
+        ? static_cast<double>(status.queueDepth) / status.queueCapacity : 0.0;
+    status.processed = stage->processed.load();
+
+    const double busyNs = static_cast<double>(stage->busyNs.load());
+    status.avgMs = status.processed > 0 ? busyNs / status.processed / 1e6 : 0.0;
+    const double uptimeNs = stage->uptime.elapsedNs();
+    status.busyRatio = uptimeNs > 0 ? std::min(1.0, busyNs / uptimeNs) : 0.0;
+    statuses.push_back(status);
+  }
+  return statuses;
 }
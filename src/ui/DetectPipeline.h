@@ -9,7 +9,8 @@
  * 创建日期：2025年12月03日
  * 摘要：检测流水线模块接口定义
  * 描述：检测流程控制器，协调相机采集、图像预处理、缺陷检测、
- *       结果评分等步骤，支持连续检测和单次检测模式
+ *       结果评分等步骤，支持连续检测和单次检测模式；
+ *       流水线模式下各步骤由独立线程执行，经 SPSC 队列串联
  *
  * 当前版本：1.0
  */
@@ -18,12 +19,21 @@
 #define DETECTPIPELINE_H
 
 #include <QObject>
-#include <QFutureWatcher>
 #include <QMutex>
 #include <memory>
+#include <algorithm>
 #include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <vector>
 #include "Types.h"
+#include "PooledMatAllocator.h"
+#include "ThreadAffinity.h"
 #include "Timer.h"
+#include "MPMCQueue.h"
+#include "ReorderBuffer.h"
 #include "ui_global.h"
 #include <opencv2/core.hpp>  // 只需要 cv::Mat
 
@@ -33,7 +43,12 @@ class DetectorManager;
 class ImagePreprocessor;
 class NMSFilter;
 class DefectScorer;
+class ROIManager;
 struct CameraConfig;
+struct DefectInfo;
+struct DetectionResult;
+enum class SeverityGrade;
+class FrameBuffer;
 
 class UI_LIBRARY DetectPipeline : public QObject {
   Q_OBJECT
@@ -46,6 +61,102 @@ public:
   bool isRunning() const;
   QString currentImagePath() const { return m_currentImagePath; }
 
+  // 串行模式下允许同时检测的最大帧数，结果按采集顺序发出
+  void setMaxFramesInFlight(int count);
+  int maxFramesInFlight() const { return m_maxFramesInFlight; }
+  int framesInFlight() const { return m_framesInFlight.load(); }
+
+  // 过载策略：检测跟不上触发节拍时如何处理新的触发
+  enum class OverloadPolicy {
+    Block,       // 挂起触发，有空闲时按序补发（不丢帧，延迟增加）
+    DropNewest,  // 丢弃本次触发
+    DropOldest,  // 取消最早一个尚未取图的帧，为本次触发让位
+    Degrade      // 以降低的分辨率继续检测，追赶节拍
+  };
+  static OverloadPolicy overloadPolicyFromString(const QString& name);
+  void setOverloadPolicy(OverloadPolicy policy) { m_overloadPolicy = policy; }
+  OverloadPolicy overloadPolicy() const { return m_overloadPolicy; }
+  void setLateThresholdMs(int ms) { m_lateThresholdMs = std::max(0, ms); }
+  void setDegradeScale(double scale) { m_degradeScale = std::clamp(scale, 0.1, 1.0); }
+
+  // 检测分辨率策略：maxDim 为检测前缩放的最大边长（0 表示保持原始分辨率）；
+  // 分块模式下整帧按重叠分块跨核并行检测，适合高分辨率相机保留细小缺陷
+  void setMaxDetectDim(int maxDim) { m_maxDetectDim = std::max(0, maxDim); }
+  int maxDetectDim() const { return m_maxDetectDim; }
+  void setTiledDetection(bool enabled, int tileSize, int overlap);
+  bool isTiledDetection() const { return m_tiledDetection; }
+
+  // 由粗到精：先在缩放后的图像上初筛，仅对候选区域（外扩 padding 像素）
+  // 在原始分辨率上重新执行对应检测器的精细分析；无候选的干净帧只付出初筛代价
+  void setCoarseToFine(bool enabled, int padding);
+  bool isCoarseToFine() const { return m_coarseToFine; }
+
+  // 检测区域（ROI）：坐标为相机原始分辨率，检测器只处理 ROI 内像素；
+  // 未定义任何形状时整帧检测
+  bool loadROI(const QString& path);
+  ROIManager* roiManager() const { return m_roiManager.get(); }
+
+  // 提前退出：任一检测器报告致命缺陷（类别属于 classes（逗号分隔），或自身严重度不低于
+  // minSeverity）时，取消本帧其余检测器并跳过 NMS 立即输出 NG，缩短剔除信号延迟
+  void setEarlyExit(bool enabled, const QString& classes, double minSeverity);
+  bool isEarlyExit() const { return m_earlyExit; }
+
+  // 检测器并行方式：auto（按实测耗时自动选择）/ inter（检测器间并行）/ intra（检测器内部并行）
+  void setParallelStrategy(const QString& strategy);
+
+  // 流水线阶段线程的 CPU 亲和性与调度优先级（stage 为 acquire/preprocess/detect/postprocess/output，
+  // 下次启动流水线时生效）
+  void setStagePlacement(const QString& stage, const ThreadPlacement& placement);
+
+  // 流水线线程（阶段线程、帧任务及其检测协助任务）的 cv::Mat 池化分配，
+  // maxPooledMB 为空闲内存上限（下次启动流水线时生效）
+  void setMatPooling(bool enabled, int maxPooledMB);
+  bool isMatPooling() const { return m_matPooling; }
+  // 池化分配统计（启动时清零计数）
+  PooledMatAllocator::Stats matPoolStats() const { return globalMatAllocator().stats(); }
+
+  // 检测记录持久化（数据库写入等）：由输出阶段在其工作线程上调用，耗时计入输出阶段，
+  // 不占用界面线程。流水线模式下在输出阶段线程按采集顺序调用；串行模式下在帧任务所在的
+  // 线程池线程调用，可能并发、不保证顺序；单次检测在调用线程执行。须在 start 之前设置
+  using ResultRecorder = std::function<void(const DetectResult&)>;
+  void setResultRecorder(ResultRecorder recorder) { m_resultRecorder = std::move(recorder); }
+
+  // 本次运行的帧统计（start 时清零）
+  struct RunStats {
+    qint64 startTime = 0;
+    qint64 endTime = 0;
+    quint64 triggered = 0;      // 触发次数
+    quint64 inspected = 0;      // 已输出结果帧数
+    quint64 okCount = 0;
+    quint64 ngCount = 0;
+    quint64 dropped = 0;        // 过载丢弃（未检测）帧数
+    quint64 failed = 0;         // 取图或处理失败帧数
+    quint64 late = 0;           // 触发到出结果超过节拍上限的帧数
+    quint64 degraded = 0;       // 降分辨率检测帧数
+    quint64 earlyExits = 0;     // 提前退出帧数
+  };
+  const RunStats& runStats() const { return m_runStats; }
+  const PerfStats& latencyStats() const { return m_latencyStats; }
+
+  // 流水线模式：采集/预处理/检测/后处理/输出分阶段并行执行
+  // 吞吐量受限于最慢阶段而非各阶段耗时之和（运行中切换在下次 start 生效）
+  void setPipelinedMode(bool enabled) { m_pipelined = enabled; }
+  bool isPipelinedMode() const { return m_pipelined; }
+  void setStageQueueCapacity(int capacity);
+  int stageQueueCapacity() const { return m_stageQueueCapacity; }
+
+  // 流水线阶段状态（用于定位产线瓶颈）
+  struct StageStatus {
+    QString name;               // 阶段名称
+    size_t queueDepth = 0;      // 输入队列当前深度
+    size_t queueCapacity = 0;   // 输入队列容量
+    double occupancy = 0.0;     // 队列占用率 [0-1]
+    quint64 processed = 0;      // 已处理帧数
+    double avgMs = 0.0;         // 平均单帧处理耗时
+    double busyRatio = 0.0;     // 忙碌时间占比 [0-1]
+  };
+  std::vector<StageStatus> stageStatus() const;
+
   // 性能统计
   const PerfStats& detectStats() const { return m_detectStats; }
   double lastDetectTimeMs() const { return m_detectStats.last(); }
@@ -56,29 +167,83 @@ public slots:
   void stop();
   void singleShot();
 
+  // 检测参数热更新（参数面板修改时调用）：与现有参数合并后发布新快照，
+  // 运行中无需停机，下一帧生效；"enabled" 键切换检测器开关，不作为算法参数
+  void setDetectorParameters(const QString& detector, const QVariantMap& params);
+
 signals:
-  void resultReady(const DetectResult& result);
+  // 结果发出后只读，各消费者共享同一份（排队连接只复制句柄）
+  void resultReady(const DetectResultPtr& result);
   void frameReady(const cv::Mat& frame);
   void error(const QString& module, const QString& message);
+  void frameDropped(quint64 totalDropped);
 
   void started();
   void stopped();
 
 private slots:
   void onCaptureTimeout();
-  void onDetectionFinished();
 
 private:
+  struct FrameTask;
+  struct Stage;
+  using FrameTaskPtr = std::shared_ptr<FrameTask>;
+
+  // 已完成的帧（工作线程/各阶段线程汇聚到 GUI 线程）
+  struct FrameCompletion {
+    FrameTaskPtr task;
+    bool ok = false;
+  };
+
   bool initCamera();
   void releaseCamera();
   bool initDetectors();
   DetectResult runDetection(const cv::Mat& frame);
 
+  // 检测步骤拆分（串行模式与流水线模式共用）
+  cv::Mat prepareFrame(const cv::Mat& frame, double scale, FrameBuffer& buffer);
+  std::vector<DefectInfo> detectDefects(const cv::Mat& processed, const cv::Mat& frame,
+                                        bool* earlyExit = nullptr);
+  // coarseDefects 与 sources 一一对应（检出缺陷的检测器），精检失败时移出对应粗检结果
+  std::vector<DefectInfo> refineDefects(std::vector<DefectInfo>& coarseDefects,
+                                        const std::vector<QString>& sources,
+                                        const cv::Mat& frame, double coarseScale);
+  DetectResult evaluateDefects(std::vector<DefectInfo> defects, const cv::Size& frameSize,
+                               bool earlyExit = false);
+  void finishResult(DetectResult& result, double elapsedMs, const QString& imagePath);
+
+  // 帧完成后回到 GUI 线程，经重排缓冲区按采集序号发出
+  void runFrame(const FrameTaskPtr& task);
+  void completeFrame(const FrameTaskPtr& task, bool ok);
+  void drainCompletions();
+  void deliverFrame(const FrameTaskPtr& task, bool ok);
+  void flushFrames();
+
+  // 过载处理（仅在 GUI 线程调用）
+  size_t admissionLoad() const;
+  size_t admissionLimit() const;
+  void submitFrame(const FrameTaskPtr& task);
+  void releaseHeldFrames();
+  bool cancelOldestFrame();
+  void dropFrames(quint64 count, const char* reason);
+  double lateThresholdMs() const;
+
+  // 流水线模式
+  void startStages();
+  void stopStages();
+  void runStage(size_t index);
+  bool acquireStage(FrameTask& task);
+  bool preprocessStage(FrameTask& task);
+  bool detectStage(FrameTask& task);
+  bool postprocessStage(FrameTask& task);
+  bool outputStage(FrameTask& task);
+
   std::unique_ptr<ICamera> m_camera;
   std::unique_ptr<DetectorManager> m_detectorManager;
   std::unique_ptr<ImagePreprocessor> m_preprocessor;
   std::unique_ptr<NMSFilter> m_nmsFilter;
   std::unique_ptr<DefectScorer> m_scorer;
+  std::unique_ptr<ROIManager> m_roiManager;
 
   QTimer* m_captureTimer = nullptr;
   QString m_imageDir;
@@ -87,15 +252,54 @@ private:
   bool m_running = false;
   bool m_useRealDetection = true;
 
-  // 异步检测
-  QFutureWatcher<DetectResult> m_detectWatcher;
-  std::atomic<bool> m_detecting{false};
-  QMutex m_detectMutex;
-  cv::Mat m_pendingFrame;
+  // 异步检测（多帧并发）
+  int m_maxFramesInFlight = 1;
+  std::atomic<int> m_framesInFlight{0};
+  std::vector<std::future<void>> m_detectFutures;
+  QMutex m_cameraMutex;                       // 相机非线程安全，并发取图需串行化
+  quint64 m_captureSequence = 0;              // 下一个采集序号（m_cameraMutex 保护，取图成功时分配）
+
+  // 过载处理
+  OverloadPolicy m_overloadPolicy = OverloadPolicy::DropNewest;
+  int m_lateThresholdMs = 0;
+  double m_degradeScale = 0.5;
+
+  // 检测分辨率
+  int m_maxDetectDim = 1920;
+  bool m_tiledDetection = false;
+  int m_tileSize = 1024;
+  int m_tileOverlap = 64;
+  bool m_coarseToFine = false;
+  int m_refinePadding = 32;
+  bool m_earlyExit = false;
+  std::deque<FrameTaskPtr> m_heldFrames;                  // block 策略挂起的触发
+  std::deque<std::weak_ptr<FrameTask>> m_waitingFrames;   // 已提交但尚未取图的帧
+  RunStats m_runStats;
+  PerfStats m_latencyStats{"Latency"};
+  Throttle m_dropLogThrottle{1000.0};
+
+  // 按采集序号重排输出（仅在 GUI 线程访问）
+  ReorderBuffer<FrameTaskPtr> m_reorderBuffer;
+
+  // 帧完成汇聚：多个工作线程无锁入队，GUI 线程批量取出；
+  // 仅在没有待处理批次时投递一次事件，队列满时退回逐帧投递
+  static constexpr size_t COMPLETION_QUEUE_CAPACITY = 256;
+  MPMCQueue<FrameCompletion> m_completions{COMPLETION_QUEUE_CAPACITY};
+  std::atomic<bool> m_completionDrainPending{false};
+
+  ResultRecorder m_resultRecorder;
+
+  // 流水线模式
+  bool m_pipelined = false;
+  int m_stageQueueCapacity = 4;
+  std::map<QString, ThreadPlacement> m_stagePlacements;
+  bool m_matPooling = false;
+  size_t m_matPoolMaxBytes = 256 * 1024 * 1024;
+  std::atomic<bool> m_stagesRunning{false};
+  std::vector<std::unique_ptr<Stage>> m_stages;
 
   // 性能统计
   PerfStats m_detectStats{"Detection"};
-  Timer m_detectTimer;
 };
 
 #endif // DETECTPIPELINE_H
@@ -16,6 +16,7 @@
 #include "config/ConfigManager.h"
 #include "data/DatabaseManager.h"
 #include "data/repositories/DefectRepository.h"
+#include "data/InspectionWriter.h"
 #include "Logger.h"
 #include <spdlog/spdlog.h>
 #include <QHBoxLayout>
@@ -100,6 +101,11 @@ MainWindow::MainWindow(QWidget *parent) : FramelessMainWindow(parent) {
 
 MainWindow::~MainWindow()
 {
+  // 写入器的连接随本窗口释放（流水线此时已停止）
+  if (m_pipeline) {
+    m_pipeline->setResultRecorder(nullptr);
+  }
+
   // 保存统计数据
   saveStatistics();
 }
@@ -113,6 +119,26 @@ void MainWindow::setPipeline(DetectPipeline* pipeline)
   connect(m_pipeline, &DetectPipeline::frameReady, this, &MainWindow::onFrameReady);
   connect(m_pipeline, &DetectPipeline::resultReady, this, &MainWindow::onResultReady);
   connect(m_pipeline, &DetectPipeline::error, this, &MainWindow::onError);
+
+  // 检测记录在流水线输出阶段的工作线程上落库（独立连接），不阻塞界面线程
+  if (m_dbManager && m_dbManager->isOpen()) {
+    m_inspectionWriter = std::make_shared<InspectionWriter>(m_dbManager->databasePath());
+    std::weak_ptr<InspectionWriter> writer = m_inspectionWriter;
+    m_pipeline->setResultRecorder([writer](const DetectResult& result) {
+      if (auto w = writer.lock()) {
+        const qint64 id = w->write(result);
+        if (id > 0) {
+          LOG_DEBUG("Inspection saved to database, id={}", id);
+        } else {
+          LOG_WARN("Failed to save inspection to database");
+        }
+      }
+    });
+  }
+  // 参数面板修改即时下发到检测器（检测线程读取参数快照，无需停机）
+  if (m_paramPanel) {
+    connect(m_paramPanel, &ParamPanel::paramsChanged, m_pipeline, &DetectPipeline::setDetectorParameters);
+  }
   connect(m_pipeline, &DetectPipeline::started, this, [this]() {
     m_actionStart->setEnabled(false);
     m_actionStop->setEnabled(true);
@@ -123,6 +149,7 @@ void MainWindow::setPipeline(DetectPipeline* pipeline)
     m_actionStart->setEnabled(true);
     m_actionStop->setEnabled(false);
     m_actionSingleShot->setEnabled(true);
+    saveBatchStatistics();
     statusBar()->showMessage(tr("检测已停止"), 2000);
   });
 }
@@ -226,8 +253,13 @@ void MainWindow::onHistoryClicked()
     dialog.exec();
 }
 
-void MainWindow::onResultReady(const DetectResult &result)
+void MainWindow::onResultReady(const DetectResultPtr &resultPtr)
 {
+    if (!resultPtr) {
+      return;
+    }
+    const DetectResult& result = *resultPtr;
+
     ++m_totalCount;
     if (result.isOK) {
         ++m_okCount;
@@ -260,7 +292,7 @@ void MainWindow::onResultReady(const DetectResult &result)
         for (const auto& defect : result.defects) {
           DetectionBox box;
           box.rect = defect.bbox;
-          box.label = result.defectType;
+          box.label = defect.className.isEmpty() ? result.defectType : defect.className;
           box.confidence = defect.confidence;
 
           if (result.level == SeverityLevel::Minor) {
@@ -278,19 +310,7 @@ void MainWindow::onResultReady(const DetectResult &result)
       }
     }
 
-    // 保存检测结果到数据库
-    if (m_dbManager && m_dbManager->isOpen()) {
-      auto* repo = m_dbManager->defectRepository();
-      if (repo) {
-        QString imagePath = m_pipeline ? m_pipeline->currentImagePath() : QString();
-        qint64 id = repo->insertFromResult(result, imagePath);
-        if (id > 0) {
-          LOG_DEBUG("Inspection saved to database, id={}", id);
-        } else {
-          LOG_WARN("Failed to save inspection to database");
-        }
-      }
-    }
+    // 检测记录已由流水线输出阶段落库（见 setPipeline）
 
     statusBar()->showMessage(result.isOK ? tr("最近一次结果: OK") : tr("最近一次结果: NG"), 2000);
 }
@@ -387,6 +407,44 @@ void MainWindow::saveStatistics()
              m_totalCount, m_okCount, m_ngCount);
 }
 
+void MainWindow::saveBatchStatistics()
+{
+    if (!m_pipeline || !m_dbManager || !m_dbManager->isOpen()) {
+        return;
+    }
+
+    // 每次启停作为一个批次，连同丢帧/超时帧数一起落库
+    const auto& stats = m_pipeline->runStats();
+    if (stats.triggered == 0) {
+        return;
+    }
+
+    auto* repo = m_dbManager->defectRepository();
+    if (!repo) {
+        return;
+    }
+
+    BatchRecord batch;
+    batch.startTime = QDateTime::fromMSecsSinceEpoch(stats.startTime);
+    batch.endTime = QDateTime::fromMSecsSinceEpoch(stats.endTime);
+    batch.batchNo = QStringLiteral("BATCH-") + batch.startTime.toString(QStringLiteral("yyyyMMdd-HHmmss-zzz"));
+    batch.productType = QStringLiteral("default");
+    batch.actualCount = static_cast<int>(stats.inspected);
+    batch.okCount = static_cast<int>(stats.okCount);
+    batch.ngCount = static_cast<int>(stats.ngCount);
+    batch.droppedCount = static_cast<int>(stats.dropped);
+    batch.lateCount = static_cast<int>(stats.late);
+    batch.yieldRate = stats.inspected > 0 ? 100.0 * stats.okCount / stats.inspected : 0.0;
+    batch.status = QStringLiteral("completed");
+
+    if (repo->insertBatch(batch) < 0) {
+        LOG_WARN("Failed to save batch statistics: {}", batch.batchNo.toStdString());
+    } else {
+        LOG_INFO("Batch saved: {}, inspected={}, dropped={}, late={}",
+                 batch.batchNo.toStdString(), batch.actualCount, batch.droppedCount, batch.lateCount);
+    }
+}
+
 void MainWindow::resetStatistics()
 {
     m_totalCount = 0;
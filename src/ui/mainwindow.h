@@ -22,6 +22,7 @@
 #include "ui_global.h"
 #include "Timer.h"
 #include <opencv2/core.hpp>  // 只需要 cv::Mat
+#include <memory>
 
 class QLabel;
 class QAction;
@@ -29,10 +30,10 @@ class QTableView;
 class ImageView;
 class ResultCard;
 class ParamPanel;
-class DetectResult;
 class AnnotationPanel;
 class DetectPipeline;
 class DatabaseManager;
+class InspectionWriter;
 class DefectTableModel;
 
 class UI_LIBRARY MainWindow : public FramelessMainWindow {
@@ -59,7 +60,7 @@ private slots:
   void onChangePasswordClicked();
   void onLogoutClicked();
 public slots:
-  void onResultReady(const DetectResult& result);
+  void onResultReady(const DetectResultPtr& resultPtr);
   void onFrameReady(const cv::Mat& frame);
   void onError(const QString& module, const QString& message);
 
@@ -80,6 +81,7 @@ private:
   void loadStatistics();
   void saveStatistics();
   void resetStatistics();
+  void saveBatchStatistics();
 
   // UI 组件
   QWidget* m_centralWidget;
@@ -131,6 +133,8 @@ private:
 
   // 数据库管理器
   DatabaseManager* m_dbManager = nullptr;
+  // 检测记录写入器（由流水线输出阶段在工作线程上调用）
+  std::shared_ptr<InspectionWriter> m_inspectionWriter;
 
   // 缺陷列表模型和视图
   DefectTableModel* m_defectModel = nullptr;
@@ -18,12 +18,14 @@ const QVector<QColor> DefectTableModel::s_defaultColors = {
     QColor("#d81b60"),  // 粉色
 };
 
-DefectItem::DefectItem(const DefectRegion& region, int idx) {
+DefectItem::DefectItem(const DefectInfo& defect, int idx) {
     id = idx;
-    classId = region.classId;
-    bbox = QRect(region.bbox.x, region.bbox.y, region.bbox.width, region.bbox.height);
-    confidence = region.confidence;
-    area = region.bbox.width * region.bbox.height;
+    classId = defect.classId;
+    className = defect.className;
+    bbox = QRect(defect.bbox.x, defect.bbox.y, defect.bbox.width, defect.bbox.height);
+    confidence = defect.confidence;
+    // 优先使用检测器测得的面积，缺失时以外接框面积近似
+    area = defect.features.get(DefectFeatures::Area, defect.bbox.width * defect.bbox.height);
     
     // 根据置信度设置严重度
     if (confidence >= 0.9) {
@@ -51,16 +53,18 @@ DefectTableModel::DefectTableModel(QObject *parent)
     m_classNames[7] = tr("凸起");
 }
 
-void DefectTableModel::setDefects(const std::vector<DefectRegion>& defects) {
+void DefectTableModel::setDefects(const std::vector<DefectInfo>& defects) {
     beginResetModel();
     m_defects.clear();
     m_defects.reserve(static_cast<int>(defects.size()));
     
     int idx = 1;
-    for (const auto& region : defects) {
-        DefectItem item(region, idx++);
-        item.className = className(region.classId);
-        item.color = classColor(region.classId);
+    for (const auto& defect : defects) {
+        DefectItem item(defect, idx++);
+        if (item.className.isEmpty()) {
+            item.className = className(defect.classId);
+        }
+        item.color = classColor(defect.classId);
         m_defects.append(item);
     }
     
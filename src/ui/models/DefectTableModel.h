@@ -24,7 +24,7 @@
 #include "ui_global.h"
 #include "common/Types.h"
 
-// 缺陷详情结构（扩展 DefectRegion）
+// 缺陷详情结构（由 DefectInfo 转换的表格行）
 struct DefectItem {
   int id = 0;                    // 缺陷ID
   QString className;             // 缺陷类别名称
@@ -36,7 +36,7 @@ struct DefectItem {
   QColor color;                  // 显示颜色
   
   DefectItem() = default;
-  DefectItem(const DefectRegion& region, int idx = 0);
+  DefectItem(const DefectInfo& defect, int idx = 0);
 };
 
 class UI_LIBRARY DefectTableModel : public QAbstractTableModel {
@@ -56,7 +56,7 @@ public:
   explicit DefectTableModel(QObject *parent = nullptr);
 
   // 数据操作
-  void setDefects(const std::vector<DefectRegion>& defects);
+  void setDefects(const std::vector<DefectInfo>& defects);
   void setDefects(const QVector<DefectItem>& defects);
   void addDefect(const DefectItem& defect);
   void removeDefect(int row);
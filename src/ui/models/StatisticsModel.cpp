@@ -17,6 +17,7 @@
 #include "common/Logger.h"
 #include <QBrush>
 #include <algorithm>
+#include <iterator>
 #include <cmath>
 
 // 默认颜色调色板
@@ -547,28 +548,67 @@ QMap<QString, QPair<double, double>> StatisticsModel::getThisMonthVsLastMonth()
 
 void StatisticsModel::addRealtimePoint(const QString& seriesName, const TimeSeriesPoint& point)
 {
-    m_realtimeData[seriesName].append(point);
+    auto it = m_realtimeData.find(seriesName);
+    if (it == m_realtimeData.end()) {
+        it = m_realtimeData.insert(seriesName,
+            RealtimeSeries(realtimeCapacity(), RealtimeSeries::OverflowPolicy::OverwriteOldest));
+    }
     trimRealtimeData();
+
+    // 过期点已移除仍然满：保留窗口内的点数超出容量，扩容而不是覆盖窗口内的历史
+    if (it->full()) {
+        if (it->capacity() < MAX_REALTIME_POINTS) {
+            resizeSeries(*it, std::min(it->capacity() * 2, MAX_REALTIME_POINTS));
+        } else if (!m_realtimeCapWarned.contains(seriesName)) {
+            m_realtimeCapWarned.insert(seriesName);
+            LOG_WARN("StatisticsModel: Realtime series '{}' reached {} points within {}s retention, "
+                     "oldest points are overwritten", seriesName.toStdString(), MAX_REALTIME_POINTS,
+                     m_realtimeRetentionSeconds);
+        }
+    }
+    it->push(point);
     emit realtimeDataUpdated(seriesName);
 }
 
 QVector<TimeSeriesPoint> StatisticsModel::getRealtimeSeries(const QString& seriesName) const
 {
-    return m_realtimeData.value(seriesName);
+    QVector<TimeSeriesPoint> points;
+    auto it = m_realtimeData.constFind(seriesName);
+    if (it != m_realtimeData.constEnd()) {
+        points.reserve(static_cast<int>(it->size()));
+        it->copyTo(std::back_inserter(points));
+    }
+    return points;
 }
 
 void StatisticsModel::clearRealtimeData(const QString& seriesName)
 {
     if (seriesName.isEmpty()) {
         m_realtimeData.clear();
+        m_realtimeCapWarned.clear();
     } else {
         m_realtimeData.remove(seriesName);
+        m_realtimeCapWarned.remove(seriesName);
     }
 }
 
 void StatisticsModel::setRealtimeRetention(int seconds)
 {
     m_realtimeRetentionSeconds = seconds;
+
+    // 只扩容；缩短保留时长后多余的点由 trimRealtimeData 按时间移除
+    const size_t capacity = realtimeCapacity();
+    for (auto& series : m_realtimeData) {
+        if (series.capacity() < capacity) {
+            resizeSeries(series, capacity);
+        }
+    }
+}
+
+void StatisticsModel::setRealtimeRate(double pointsPerSecond)
+{
+    m_realtimePointRate = std::max(0.0, pointsPerSecond);
+    setRealtimeRetention(m_realtimeRetentionSeconds);
 }
 
 QVariantMap StatisticsModel::getTodaySummary()
@@ -751,10 +791,30 @@ void StatisticsModel::trimRealtimeData()
     QDateTime cutoff = QDateTime::currentDateTime().addSecs(-m_realtimeRetentionSeconds);
     
     for (auto& series : m_realtimeData) {
-        while (!series.isEmpty() && series.first().timestamp < cutoff) {
-            series.removeFirst();
+        size_t expired = 0;
+        while (expired < series.size() && series[expired].timestamp < cutoff) {
+            ++expired;
         }
+        series.consume(expired);
+    }
+}
+
+size_t StatisticsModel::realtimeCapacity() const
+{
+    const double expected = std::ceil(std::max(0, m_realtimeRetentionSeconds) * m_realtimePointRate);
+    return static_cast<size_t>(std::clamp(expected, static_cast<double>(MIN_REALTIME_POINTS),
+                                          static_cast<double>(MAX_REALTIME_POINTS)));
+}
+
+void StatisticsModel::resizeSeries(RealtimeSeries& series, size_t capacity)
+{
+    // 按时间顺序搬移到新缓冲区，超出新容量时保留最新的点
+    RealtimeSeries resized(capacity, RealtimeSeries::OverflowPolicy::OverwriteOldest);
+    const size_t skip = series.size() > capacity ? series.size() - capacity : 0;
+    for (size_t i = skip; i < series.size(); ++i) {
+        resized.push(std::move(series[i]));
     }
+    series = std::move(resized);
 }
 
 // ==================== StatisticsTableModel ====================
@@ -22,10 +22,12 @@
 #include <QDateTime>
 #include <QVector>
 #include <QMap>
+#include <QSet>
 #include <QVariant>
 #include <QPair>
 #include <QColor>
 #include "ui_global.h"
+#include "CircularBuffer.h"
 
 /**
  * @brief 时间粒度
@@ -219,9 +221,17 @@ public:
 
     /**
      * @brief 设置实时数据保留时长（秒）
+     *
+     * 缓冲区按 保留时长 × 预估点速率 预分配；保留窗口内的点数超出容量时翻倍扩容，
+     * 达到 MAX_REALTIME_POINTS 后才覆盖最旧点（每个系列记录一次警告）
      */
     void setRealtimeRetention(int seconds);
 
+    /**
+     * @brief 设置每个实时系列的预估点速率（点/秒），用于预分配缓冲区
+     */
+    void setRealtimeRate(double pointsPerSecond);
+
     // ======================== 汇总统计 ========================
 
     /**
@@ -275,12 +285,20 @@ private:
     QDateTime truncateTime(const QDateTime& dt, TimeGranularity granularity) const;
     void calculatePercentages(QVector<CategoryDataPoint>& data) const;
     void trimRealtimeData();
+    size_t realtimeCapacity() const;
+    static void resizeSeries(CircularBuffer<TimeSeriesPoint>& series, size_t capacity);
 
     class DefectRepository* m_repo = nullptr;
     
-    // 实时数据缓存
-    QMap<QString, QVector<TimeSeriesPoint>> m_realtimeData;
+    // 实时数据缓存（每个系列一个环形缓冲区，追加不再逐点分配）
+    // 容量按保留时长 × 预估点速率预分配，保留窗口内点数超出时扩容，上限为 MAX_REALTIME_POINTS
+    using RealtimeSeries = CircularBuffer<TimeSeriesPoint>;
+    static constexpr size_t MIN_REALTIME_POINTS = 1024;
+    static constexpr size_t MAX_REALTIME_POINTS = 262144;
+    QMap<QString, RealtimeSeries> m_realtimeData;
+    QSet<QString> m_realtimeCapWarned;         // 已因达到上限而覆盖窗口内数据的系列
     int m_realtimeRetentionSeconds = 3600;  // 默认保留1小时
+    double m_realtimePointRate = 2.0;       // 预估每个系列每秒点数
     
     // 默认颜色
     static const QVector<QColor> s_defaultColors;
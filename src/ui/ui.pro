@@ -9,7 +9,7 @@ include($$PWD/../../config/config.pri)
 TEMPLATE = lib
 TARGET = ui
 
-QT += core gui widgets charts sql concurrent
+QT += core gui widgets charts sql
 
 DEFINES += UI_LIBRARY_BUILD
 
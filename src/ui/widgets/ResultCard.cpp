@@ -170,7 +170,7 @@ void ResultCard::clearDefectList()
   }
 }
 
-void ResultCard::rebuildDefectList(const QString& typeName, const std::vector<DefectRegion>& defects)
+void ResultCard::rebuildDefectList(const QString& typeName, const std::vector<DefectInfo>& defects)
 {
   clearDefectList();
 
@@ -191,8 +191,10 @@ void ResultCard::rebuildDefectList(const QString& typeName, const std::vector<De
     entryLayout->setContentsMargins(12, 8, 12, 8);
     entryLayout->setSpacing(4);
 
+    // 优先使用检测器给出的类别名称，缺失时回退到整体缺陷类型
+    const QString& name = defect.className.isEmpty() ? typeName : defect.className;
     const QString displayName =
-        typeName.isEmpty() ? tr("缺陷 #%1").arg(i + 1) : QStringLiteral("%1 #%2").arg(typeName).arg(i + 1);
+        name.isEmpty() ? tr("缺陷 #%1").arg(i + 1) : QStringLiteral("%1 #%2").arg(name).arg(i + 1);
 
     auto* nameLabel = new QLabel(displayName, entry);
     nameLabel->setObjectName(QStringLiteral("ResultsDefectName"));
@@ -208,7 +210,7 @@ void ResultCard::rebuildDefectList(const QString& typeName, const std::vector<De
   }
 }
 
-QString ResultCard::calculateSeverityLevel(const std::vector<DefectRegion>& defects)
+QString ResultCard::calculateSeverityLevel(const std::vector<DefectInfo>& defects)
 {
   if (defects.empty()) {
     return QStringLiteral("OK");
@@ -39,8 +39,8 @@ private:
   void setupUI();
   void updateStatus(bool isOk);
   void clearDefectList();
-  void rebuildDefectList(const QString& typeName, const std::vector<DefectRegion>& defects);
-  QString calculateSeverityLevel(const std::vector<DefectRegion>& defects);
+  void rebuildDefectList(const QString& typeName, const std::vector<DefectInfo>& defects);
+  QString calculateSeverityLevel(const std::vector<DefectInfo>& defects);
 
   QLabel* m_titleLabel = nullptr;
   QLabel* m_statusIcon = nullptr;
@@ -0,0 +1,12 @@
+# =============================================================================
+# bench_gabor - Gabor 滤波器组三条卷积路径在 2 MP 与 12 MP 下的耗时、auto 选择与核频谱缓存
+# =============================================================================
+
+include($$PWD/../../tests.pri)
+
+TARGET = bench_gabor
+
+LIBS += -lalgorithm
+
+SOURCES += \
+    bench_gabor.cpp
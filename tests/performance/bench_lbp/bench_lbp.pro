@@ -0,0 +1,12 @@
+# =============================================================================
+# bench_lbp - 异物检测纹理分析内核（LBP / 块统计）在 2 MP 与 12 MP 下的耗时对比
+# =============================================================================
+
+include($$PWD/../../tests.pri)
+
+TARGET = bench_lbp
+
+LIBS += -lalgorithm
+
+SOURCES += \
+    bench_lbp.cpp
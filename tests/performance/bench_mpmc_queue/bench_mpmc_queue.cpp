@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * bench_mpmc_queue.cpp
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：MPMC 队列竞争基准
+ * 描述：N 个生产者与 N 个消费者（N = 1/2/4/8/16）经同一有界队列传递整数，
+ *       对比 MPMCQueue / BlockingMPMCQueue 与互斥锁（+条件变量）队列的吞吐，
+ *       并校验全部元素恰好被取出一次
+ *
+ *       用法：bench_mpmc_queue [每个生产者的元素数，默认 200000] [队列容量，默认 1024]
+ *
+ * 当前版本：1.0
+ */
+
+#include "MPMCQueue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// ============================================================================
+// 对照组：互斥锁保护的有界环形队列（与 MPMCQueue 相同的非阻塞接口）
+// ============================================================================
+
+class MutexQueue {
+public:
+  explicit MutexQueue(size_t capacity) : m_buffer(capacity) {}
+
+  bool push(uint64_t value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_size == m_buffer.size()) {
+      return false;
+    }
+    m_buffer[(m_head + m_size) % m_buffer.size()] = value;
+    ++m_size;
+    return true;
+  }
+
+  bool pop(uint64_t& value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_size == 0) {
+      return false;
+    }
+    value = m_buffer[m_head];
+    m_head = (m_head + 1) % m_buffer.size();
+    --m_size;
+    return true;
+  }
+
+private:
+  std::mutex m_mutex;
+  std::vector<uint64_t> m_buffer;
+  size_t m_head = 0;
+  size_t m_size = 0;
+};
+
+// 对照组：互斥锁 + 条件变量的阻塞队列（与 BlockingMPMCQueue 相同的阻塞接口）
+class BlockingMutexQueue {
+public:
+  explicit BlockingMutexQueue(size_t capacity) : m_buffer(capacity) {}
+
+  void push(uint64_t value) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock, [this] { return m_size < m_buffer.size(); });
+    m_buffer[(m_head + m_size) % m_buffer.size()] = value;
+    ++m_size;
+    lock.unlock();
+    m_notEmpty.notify_one();
+  }
+
+  uint64_t pop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notEmpty.wait(lock, [this] { return m_size > 0; });
+    const uint64_t value = m_buffer[m_head];
+    m_head = (m_head + 1) % m_buffer.size();
+    --m_size;
+    lock.unlock();
+    m_notFull.notify_one();
+    return value;
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_notEmpty;
+  std::condition_variable m_notFull;
+  std::vector<uint64_t> m_buffer;
+  size_t m_head = 0;
+  size_t m_size = 0;
+};
+
+struct RunResult {
+  double seconds = 0.0;
+  bool valid = false;
+};
+
+// 非阻塞接口：满/空时让出 CPU 后重试
+template <typename Queue>
+RunResult runNonBlocking(Queue& queue, int threads, uint64_t perProducer) {
+  const uint64_t total = perProducer * threads;
+  std::atomic<uint64_t> consumed{0};
+  std::atomic<uint64_t> sum{0};
+  std::atomic<bool> start{false};
+  std::vector<std::thread> workers;
+
+  for (int p = 0; p < threads; ++p) {
+    workers.emplace_back([&, p] {
+      while (!start.load()) {
+        std::this_thread::yield();
+      }
+      for (uint64_t i = 0; i < perProducer; ++i) {
+        const uint64_t value = p * perProducer + i + 1;
+        while (!queue.push(value)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (int c = 0; c < threads; ++c) {
+    workers.emplace_back([&] {
+      while (!start.load()) {
+        std::this_thread::yield();
+      }
+      uint64_t localSum = 0;
+      uint64_t value = 0;
+      while (consumed.load(std::memory_order_relaxed) < total) {
+        if (queue.pop(value)) {
+          localSum += value;
+          consumed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+      sum.fetch_add(localSum);
+    });
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  start.store(true);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  RunResult result;
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  result.valid = consumed.load() == total && sum.load() == total * (total + 1) / 2;
+  return result;
+}
+
+// 阻塞接口：各消费者按配额取，取完即退出（不依赖停止信号）
+template <typename Queue>
+RunResult runBlocking(Queue& queue, int threads, uint64_t perProducer) {
+  const uint64_t total = perProducer * threads;
+  std::atomic<uint64_t> sum{0};
+  std::atomic<bool> start{false};
+  std::vector<std::thread> workers;
+
+  for (int p = 0; p < threads; ++p) {
+    workers.emplace_back([&, p] {
+      while (!start.load()) {
+        std::this_thread::yield();
+      }
+      for (uint64_t i = 0; i < perProducer; ++i) {
+        queue.push(p * perProducer + i + 1);
+      }
+    });
+  }
+  for (int c = 0; c < threads; ++c) {
+    workers.emplace_back([&] {
+      while (!start.load()) {
+        std::this_thread::yield();
+      }
+      uint64_t localSum = 0;
+      for (uint64_t i = 0; i < perProducer; ++i) {
+        localSum += queue.pop();
+      }
+      sum.fetch_add(localSum);
+    });
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  start.store(true);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  RunResult result;
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  result.valid = sum.load() == total * (total + 1) / 2;
+  return result;
+}
+
+void report(const char* name, int threads, uint64_t total, const RunResult& result, double baselineSeconds) {
+  std::printf("%-22s %3d x %-3d %10.2f Mops/s %9.1f ms  x%.2f%s\n", name, threads, threads,
+              total / result.seconds / 1e6, result.seconds * 1e3, baselineSeconds / result.seconds,
+              result.valid ? "" : "  [INVALID]");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const uint64_t perProducer = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+  const size_t capacity = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+  const int threadCounts[] = {1, 2, 4, 8, 16};
+
+  std::printf("MPMC queue contention: %llu items per producer, capacity %zu, %u hardware threads\n",
+              static_cast<unsigned long long>(perProducer), capacity, std::thread::hardware_concurrency());
+  std::printf("%-22s %-9s %17s %12s  %s\n", "queue", "prod/cons", "throughput", "time", "vs mutex");
+
+  bool allValid = true;
+  for (int threads : threadCounts) {
+    const uint64_t total = perProducer * threads;
+
+    MutexQueue mutexQueue(capacity);
+    const RunResult mutexResult = runNonBlocking(mutexQueue, threads, perProducer);
+    MPMCQueue<uint64_t> lockFreeQueue(capacity);
+    const RunResult lockFreeResult = runNonBlocking(lockFreeQueue, threads, perProducer);
+    report("mutex (try)", threads, total, mutexResult, mutexResult.seconds);
+    report("MPMCQueue (try)", threads, total, lockFreeResult, mutexResult.seconds);
+
+    BlockingMutexQueue blockingMutexQueue(capacity);
+    const RunResult blockingMutexResult = runBlocking(blockingMutexQueue, threads, perProducer);
+    BlockingMPMCQueue<uint64_t> blockingQueue(capacity);
+    const RunResult blockingResult = runBlocking(blockingQueue, threads, perProducer);
+    report("mutex+condvar", threads, total, blockingMutexResult, blockingMutexResult.seconds);
+    report("BlockingMPMCQueue", threads, total, blockingResult, blockingMutexResult.seconds);
+
+    allValid = allValid && mutexResult.valid && lockFreeResult.valid &&
+               blockingMutexResult.valid && blockingResult.valid;
+  }
+  return allValid ? 0 : 1;
+}
@@ -0,0 +1,10 @@
+# =============================================================================
+# bench_mpmc_queue - MPMCQueue 与互斥锁队列在 1~16 个生产者/消费者下的吞吐对比
+# =============================================================================
+
+include($$PWD/../../tests.pri)
+
+TARGET = bench_mpmc_queue
+
+SOURCES += \
+    bench_mpmc_queue.cpp
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * bench_result_allocations.cpp
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：检测结果路径每帧堆分配次数基准
+ * 描述：4 个检测器，每个检测器两组候选（24 点轮廓），各组经检测器内 NMS 与置信度过滤，
+ *       再经管理器合并、流水线按类别 NMS，统计每帧 operator new 次数与耗时：
+ *       - before：复制式结果路径（按值复制的 makeSuccessResult / filterByConfidence、
+ *         复制输入再排序的 NMS、管理器复制到 detectorResults 与 allDefects、流水线再复制一次）
+ *       - after：当前实现（BaseDetector 辅助方法、NMSFilter、DetectorManager::detectAll）
+ *       两条路径输入相同，保留的缺陷数必须一致，否则以非零退出码结束
+ *
+ *       计数依赖全局 operator new 替换对动态库同样生效（Linux）；
+ *       Windows 下各 DLL 的分配不经过本程序的替换函数，计数偏小
+ *
+ *       用法：bench_result_allocations [帧数，默认 200]
+ *
+ * 当前版本：1.0
+ */
+
+#include "BaseDetector.h"
+#include "DetectorManager.h"
+#include "postprocess/NMSFilter.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <new>
+#include <random>
+
+// ============================================================================
+// 分配计数：替换全局 operator new（delete 不计数）
+// ============================================================================
+
+namespace {
+std::atomic<unsigned long long> g_allocations{0};
+
+void* countedAlloc(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* countedAlignedAlloc(std::size_t size, std::align_val_t align) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  const std::size_t alignment = static_cast<std::size_t>(align);
+  void* p = nullptr;
+#ifdef _WIN32
+  p = _aligned_malloc(size ? size : 1, alignment);
+#else
+  if (posix_memalign(&p, std::max(alignment, sizeof(void*)), size ? size : 1) != 0) {
+    p = nullptr;
+  }
+#endif
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void alignedFree(void* p) {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  std::free(p);
+#endif
+}
+} // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+
+namespace {
+
+const int DETECTOR_COUNT = 4;
+const int CONTOUR_POINTS = 24;
+const size_t MAX_DEFECTS_PER_DETECTOR = 100;  // 与 DetectorManager 的截断上限一致
+
+// 一组候选：框聚集在若干簇内，使 NMS 有实际抑制；同一 seed 生成完全相同的候选
+std::vector<DefectInfo> makeCandidates(unsigned seed, int count, int classId) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> cluster(0, 15);
+  std::uniform_int_distribution<int> jitter(-12, 12);
+  std::uniform_int_distribution<int> extent(20, 60);
+  std::uniform_real_distribution<double> score(0.1, 1.0);
+
+  std::vector<DefectInfo> candidates;
+  candidates.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    const int c = cluster(rng);
+    DefectInfo defect;
+    defect.bbox = cv::Rect(100 + (c % 4) * 200 + jitter(rng), 100 + (c / 4) * 200 + jitter(rng),
+                           extent(rng), extent(rng));
+    defect.confidence = score(rng);
+    defect.severity = score(rng);
+    defect.classId = classId;
+    defect.className = QStringLiteral("Class%1").arg(classId);
+    defect.contour.reserve(CONTOUR_POINTS);
+    for (int p = 0; p < CONTOUR_POINTS; ++p) {
+      defect.contour.emplace_back(defect.bbox.x + p % defect.bbox.width, defect.bbox.y + p);
+    }
+    defect.features.set(DefectFeatures::Length, defect.bbox.width);
+    defect.features.set(DefectFeatures::Area, defect.bbox.area());
+    candidates.push_back(std::move(defect));
+  }
+  return candidates;
+}
+
+// ============================================================================
+// before：复制式结果路径（改造前的实现）
+// ============================================================================
+
+namespace legacy {
+
+double computeIoU(const cv::Rect& a, const cv::Rect& b) { return NMSFilter::computeIoU(a, b); }
+
+std::vector<DefectInfo> nmsFilter(const std::vector<DefectInfo>& defects, double iouThreshold,
+                                  double confThreshold) {
+  if (defects.empty()) {
+    return {};
+  }
+  std::vector<DefectInfo> sorted = defects;
+  std::sort(sorted.begin(), sorted.end(), [](const DefectInfo& a, const DefectInfo& b) {
+    return a.confidence > b.confidence;
+  });
+  std::vector<bool> suppressed(sorted.size(), false);
+  std::vector<DefectInfo> result;
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    if (suppressed[i] || sorted[i].confidence < confThreshold) {
+      continue;
+    }
+    result.push_back(sorted[i]);
+    for (size_t j = i + 1; j < sorted.size(); ++j) {
+      if (!suppressed[j] && computeIoU(sorted[i].bbox, sorted[j].bbox) > iouThreshold) {
+        suppressed[j] = true;
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<DefectInfo> nmsFilterByClass(const std::vector<DefectInfo>& defects, double iouThreshold,
+                                         double confThreshold) {
+  std::map<int, std::vector<DefectInfo>> byClass;
+  for (const auto& d : defects) {
+    byClass[d.classId].push_back(d);
+  }
+  std::vector<DefectInfo> result;
+  for (auto& pair : byClass) {
+    auto filtered = nmsFilter(pair.second, iouThreshold, confThreshold);
+    result.insert(result.end(), filtered.begin(), filtered.end());
+  }
+  return result;
+}
+
+std::vector<DefectInfo> filterByConfidence(const std::vector<DefectInfo>& defects, double threshold) {
+  std::vector<DefectInfo> filtered;
+  for (const auto& d : defects) {
+    if (d.confidence >= threshold) {
+      filtered.push_back(d);
+    }
+  }
+  return filtered;
+}
+
+DetectionResult makeSuccessResult(const std::vector<DefectInfo>& defects, double timeMs) {
+  DetectionResult result;
+  result.success = true;
+  result.defects = defects;
+  result.processingTimeMs = timeMs;
+  return result;
+}
+
+DetectionResult detect(int index, int perDetector, double confThreshold) {
+  NMSFilter settings;
+  std::vector<DefectInfo> all;
+  for (int group = 0; group < 2; ++group) {
+    const std::vector<DefectInfo> candidates = makeCandidates(index * 2 + group, perDetector / 2, index);
+    const std::vector<DefectInfo> kept =
+        nmsFilter(candidates, settings.iouThreshold(), settings.confidenceThreshold());
+    all.insert(all.end(), kept.begin(), kept.end());
+  }
+  return makeSuccessResult(filterByConfidence(all, confThreshold), 0.0);
+}
+
+size_t runFrame(int perDetector, double confThreshold) {
+  // 管理器：结果复制进 detectorResults，缺陷再逐个复制进 allDefects
+  std::map<QString, DetectionResult> detectorResults;
+  std::vector<DefectInfo> allDefects;
+  for (int d = 0; d < DETECTOR_COUNT; ++d) {
+    DetectionResult detResult = detect(d, perDetector, confThreshold);
+    detectorResults[QStringLiteral("det%1").arg(d)] = detResult;
+    const size_t count = std::min(detResult.defects.size(), MAX_DEFECTS_PER_DETECTOR);
+    for (size_t i = 0; i < count; ++i) {
+      allDefects.push_back(detResult.defects[i]);
+    }
+  }
+
+  // 流水线：复制合并结果后按类别 NMS
+  NMSFilter settings;
+  std::vector<DefectInfo> defects = allDefects;
+  return nmsFilterByClass(defects, settings.iouThreshold(), settings.confidenceThreshold()).size();
+}
+
+} // namespace legacy
+
+// ============================================================================
+// after：当前实现
+// ============================================================================
+
+class SyntheticDetector : public BaseDetector {
+public:
+  SyntheticDetector(int index, int perDetector) : m_index(index), m_perDetector(perDetector) {}
+
+  QString name() const override { return QStringLiteral("det%1").arg(m_index); }
+  QString type() const override { return "synthetic"; }
+  bool initialize() override { m_initialized = true; return true; }
+  void release() override { m_initialized = false; }
+
+  DetectionResult detect(const cv::Mat& /*image*/) override {
+    std::vector<DefectInfo> all;
+    for (int group = 0; group < 2; ++group) {
+      std::vector<DefectInfo> kept = m_nms.filter(makeCandidates(m_index * 2 + group, m_perDetector / 2, m_index));
+      all.insert(all.end(), std::make_move_iterator(kept.begin()), std::make_move_iterator(kept.end()));
+    }
+    return makeSuccessResult(filterByConfidence(std::move(all)), 0.0);
+  }
+
+private:
+  int m_index;
+  int m_perDetector;
+  NMSFilter m_nms;
+};
+
+struct Measurement {
+  double allocationsPerFrame = 0.0;
+  double msPerFrame = 0.0;
+  size_t kept = 0;
+};
+
+template <typename Frame>
+Measurement measure(int frames, Frame&& frame) {
+  frame();  // 预热（静态对象、日志等一次性分配不计入）
+  Measurement m;
+  const unsigned long long before = g_allocations.load();
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; ++i) {
+    m.kept = frame();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  m.allocationsPerFrame = static_cast<double>(g_allocations.load() - before) / frames;
+  m.msPerFrame = seconds * 1e3 / frames;
+  return m;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+  const int candidateCounts[] = {50, 200, 1000};
+
+  std::printf("Result path allocations: %d detectors x 2 groups, %d-point contours, %d frames\n",
+              DETECTOR_COUNT, CONTOUR_POINTS, frames);
+  std::printf("%-12s %24s %22s %8s\n", "cand/det", "allocs/frame before->after", "ms/frame before->after",
+              "kept");
+
+  bool consistent = true;
+  const cv::Mat image = cv::Mat::zeros(64, 64, CV_8UC1);
+  for (int perDetector : candidateCounts) {
+    DetectorManager manager;
+    for (int d = 0; d < DETECTOR_COUNT; ++d) {
+      manager.addDetector(QStringLiteral("det%1").arg(d), std::make_shared<SyntheticDetector>(d, perDetector));
+    }
+    const double confThreshold = manager.getDetector("det0")->confidenceThreshold();
+    NMSFilter pipelineNms;
+
+    const Measurement before = measure(frames, [&] { return legacy::runFrame(perDetector, confThreshold); });
+    const Measurement after = measure(frames, [&] {
+      DetectorManager::CombinedResult combined = manager.detectAll(image);
+      return pipelineNms.filterByClass(std::move(combined.allDefects)).size();
+    });
+
+    std::printf("%-12d %11.0f -> %-10.0f %9.3f -> %-9.3f %4zu%s\n", perDetector, before.allocationsPerFrame,
+                after.allocationsPerFrame, before.msPerFrame, after.msPerFrame, after.kept,
+                before.kept == after.kept ? "" : "  [MISMATCH]");
+    consistent = consistent && before.kept == after.kept;
+  }
+  return consistent ? 0 : 1;
+}
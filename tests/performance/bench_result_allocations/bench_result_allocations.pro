@@ -0,0 +1,12 @@
+# =============================================================================
+# bench_result_allocations - 检测结果路径（检测器 → NMS → 管理器 → 流水线）每帧堆分配次数
+# =============================================================================
+
+include($$PWD/../../tests.pri)
+
+TARGET = bench_result_allocations
+
+LIBS += -lalgorithm
+
+SOURCES += \
+    bench_result_allocations.cpp
@@ -0,0 +1,10 @@
+# =============================================================================
+# performance - 性能基准（独立控制台程序，手动运行，输出对比数据）
+# =============================================================================
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    bench_gabor \
+    bench_lbp \
+    bench_mpmc_queue \
+    bench_result_allocations
@@ -0,0 +1,33 @@
+# =============================================================================
+# 测试公共配置 - 所有测试/基准程序共享
+# 控制台程序，链接 bin 目录下的模块动态库
+# =============================================================================
+
+include($$PWD/../config/config.pri)
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+QT += core
+QT -= gui
+
+INCLUDEPATH += $$PWD/../config
+INCLUDEPATH += $$PWD/../third_party
+INCLUDEPATH += $$PWD/../third_party/opencv/include
+INCLUDEPATH += $$SRC_DIR/common
+INCLUDEPATH += $$SRC_DIR/algorithm
+
+DEPENDPATH += $$SRC_DIR/common
+DEPENDPATH += $$SRC_DIR/algorithm
+
+# 所有库都在 bin 目录
+LIBS += -L$$BIN_DIR -lcommon
+
+# OpenCV 链接（MinGW）
+win32-g++ {
+    OPENCV_LIB_DIR = $$PWD/../third_party/opencv/x64/mingw/lib
+    LIBS += -L$$OPENCV_LIB_DIR -lopencv_world460
+    QMAKE_LIBDIR += $$OPENCV_LIB_DIR
+    QMAKE_LIBS += -lopencv_world460
+}
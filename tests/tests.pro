@@ -0,0 +1,11 @@
+# =============================================================================
+# tests - 单元测试与性能基准
+# 单元测试（unit/test_*）基于 Qt Test，make check 运行；
+# 性能基准（performance/bench_*）为独立控制台程序，手动运行并输出对比数据
+# 依赖: 全部被测模块（需先构建 src）
+# =============================================================================
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    unit \
+    performance
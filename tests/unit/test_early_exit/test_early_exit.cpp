@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * test_early_exit.cpp
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：提前退出单元测试
+ * 描述：验证致命缺陷规则（类别/自身严重度）的判定，以及按随仓库发布的
+ *       config/app.json 配置时，致命类别缺陷确实取消本帧其余检测器
+ *
+ * 当前版本：1.0
+ */
+
+#include "BaseDetector.h"
+#include "DetectorManager.h"
+#include "scoring/DefectScorer.h"
+#include "config/AppConfig.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QtTest>
+
+namespace {
+
+// 每帧报告一个固定类别与严重度的缺陷
+class FixedDefectDetector : public BaseDetector {
+public:
+  FixedDefectDetector(const QString& className, double severity)
+      : m_className(className), m_severity(severity) {}
+
+  QString name() const override { return "fixed"; }
+  QString type() const override { return "fixed"; }
+  bool initialize() override { m_initialized = true; return true; }
+  void release() override { m_initialized = false; }
+
+  DetectionResult detect(const cv::Mat& /*image*/) override {
+    DefectInfo defect;
+    defect.bbox = cv::Rect(8, 8, 24, 4);
+    defect.confidence = 0.9;
+    defect.severity = m_severity;
+    defect.className = m_className;
+    std::vector<DefectInfo> defects;
+    defects.push_back(std::move(defect));
+    return makeSuccessResult(std::move(defects), 0.0);
+  }
+
+private:
+  QString m_className;
+  double m_severity;
+};
+
+// 记录是否真正执行了检测（已取消时返回取消结果）
+class ProbeDetector : public BaseDetector {
+public:
+  QString name() const override { return "probe"; }
+  QString type() const override { return "probe"; }
+  bool initialize() override { m_initialized = true; return true; }
+  void release() override { m_initialized = false; }
+
+  DetectionResult detect(const cv::Mat& /*image*/) override {
+    m_runs.fetch_add(1);
+    return makeSuccessResult({}, 0.0);
+  }
+  DetectionResult detect(const FrameContext& ctx) override {
+    if (ctx.isCancelled()) {
+      return makeCancelledResult(0.0);
+    }
+    return detect(ctx.image());
+  }
+
+  int runs() const { return m_runs.load(); }
+
+private:
+  std::atomic<int> m_runs{0};
+};
+
+DefectInfo makeDefect(const QString& className, double severity) {
+  DefectInfo defect;
+  defect.className = className;
+  defect.severity = severity;
+  defect.confidence = 1.0;
+  return defect;
+}
+
+// 随仓库发布的检测配置
+DetectionConfig shippedDetectionConfig() {
+  QFile file(QStringLiteral(TEST_CONFIG_DIR "/app.json"));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return DetectionConfig();
+  }
+  const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  return DetectionConfig::fromJson(root.value("detection").toObject());
+}
+
+} // namespace
+
+class TestEarlyExit : public QObject {
+  Q_OBJECT
+
+private slots:
+  void ruleMatchesCriticalClassAtAnySeverity() {
+    const CriticalDefectRule rule = CriticalDefectRule::fromConfig(" Crack , Dimension", 0.9);
+    QCOMPARE(rule.classes, QStringList({"Crack", "Dimension"}));
+    QVERIFY(rule.matches(makeDefect("Crack", 0.05)));
+    QVERIFY(rule.matches(makeDefect("Dimension", 0.0)));
+    QVERIFY(!rule.matches(makeDefect("Scratch", 0.5)));
+  }
+
+  void ruleMatchesSeverityOfAnyClass() {
+    const CriticalDefectRule rule = CriticalDefectRule::fromConfig("", 0.9);
+    QVERIFY(rule.matches(makeDefect("Scratch", 0.95)));
+    QVERIFY(!rule.matches(makeDefect("Scratch", 0.85)));
+
+    const CriticalDefectRule classesOnly = CriticalDefectRule::fromConfig("Crack", 1.5);
+    QVERIFY(!classesOnly.matches(makeDefect("Scratch", 1.0)));
+  }
+
+  // 按发布配置，单个致命类别缺陷必须能触发提前退出
+  void shippedConfigReachesEarlyExit() {
+    const DetectionConfig cfg = shippedDetectionConfig();
+    const CriticalDefectRule rule = CriticalDefectRule::fromConfig(cfg.earlyExitClasses, cfg.earlyExitSeverity);
+    QVERIFY2(!rule.classes.isEmpty() || rule.minSeverity <= 1.0,
+             "shipped early-exit rule can never match a defect");
+    const QString className = rule.classes.isEmpty() ? QString("Scratch") : rule.classes.front();
+    QVERIFY(rule.matches(makeDefect(className, std::min(1.0, rule.minSeverity))));
+  }
+
+  // 串行检测：致命缺陷之后的检测器不再执行
+  void criticalDefectCancelsFrameSerial() {
+    const DetectionConfig cfg = shippedDetectionConfig();
+    const CriticalDefectRule rule = CriticalDefectRule::fromConfig(cfg.earlyExitClasses, cfg.earlyExitSeverity);
+    QVERIFY(!rule.classes.isEmpty());
+
+    DetectorManager manager;
+    auto probe = std::make_shared<ProbeDetector>();
+    manager.addDetector("a_critical", std::make_shared<FixedDefectDetector>(rule.classes.front(), 0.2));
+    manager.addDetector("b_probe", probe);
+    manager.setEarlyExit([rule](const DefectInfo& defect) { return rule.matches(defect); });
+
+    const DetectorManager::CombinedResult result = manager.detectAll(cv::Mat::zeros(64, 64, CV_8UC1));
+    QVERIFY(result.earlyExit);
+    QCOMPARE(result.earlyExitDetector, QString("a_critical"));
+    QCOMPARE(probe->runs(), 0);
+    QVERIFY(result.detectorResults.at("b_probe").cancelled);
+    QCOMPARE(result.allDefects.size(), size_t(1));
+  }
+
+  // 并行检测：触发者被记录，未开始的检测器被取消
+  void criticalDefectCancelsFrameParallel() {
+    const CriticalDefectRule rule = CriticalDefectRule::fromConfig("Crack", 0.9);
+
+    DetectorManager manager;
+    auto probe = std::make_shared<ProbeDetector>();
+    manager.addDetector("a_critical", std::make_shared<FixedDefectDetector>("Crack", 0.2));
+    manager.addDetector("b_probe", probe);
+    manager.setEarlyExit([rule](const DefectInfo& defect) { return rule.matches(defect); });
+
+    const DetectorManager::CombinedResult result = manager.detectAllParallel(cv::Mat::zeros(64, 64, CV_8UC1));
+    QVERIFY(result.earlyExit);
+    QCOMPARE(result.earlyExitDetector, QString("a_critical"));
+    const DetectionResult& probeResult = result.detectorResults.at("b_probe");
+    QVERIFY(probeResult.cancelled || probe->runs() == 1);
+  }
+
+  void nonCriticalDefectDoesNotCancel() {
+    const CriticalDefectRule rule = CriticalDefectRule::fromConfig("Crack", 0.9);
+
+    DetectorManager manager;
+    auto probe = std::make_shared<ProbeDetector>();
+    manager.addDetector("a_minor", std::make_shared<FixedDefectDetector>("Scratch", 0.5));
+    manager.addDetector("b_probe", probe);
+    manager.setEarlyExit([rule](const DefectInfo& defect) { return rule.matches(defect); });
+
+    const DetectorManager::CombinedResult result = manager.detectAll(cv::Mat::zeros(64, 64, CV_8UC1));
+    QVERIFY(!result.earlyExit);
+    QCOMPARE(probe->runs(), 1);
+    QVERIFY(!result.detectorResults.at("b_probe").cancelled);
+  }
+};
+
+QTEST_GUILESS_MAIN(TestEarlyExit)
+#include "test_early_exit.moc"
@@ -0,0 +1,17 @@
+# =============================================================================
+# test_early_exit - 致命缺陷提前退出：规则判定与本帧其余检测器取消
+# =============================================================================
+
+include($$PWD/../../tests.pri)
+
+TARGET = test_early_exit
+QT += testlib
+CONFIG += testcase
+
+LIBS += -lalgorithm
+
+SOURCES += \
+    test_early_exit.cpp
+
+# 读取随仓库发布的配置文件
+DEFINES += TEST_CONFIG_DIR=\\\"$$PWD/../../../config\\\"
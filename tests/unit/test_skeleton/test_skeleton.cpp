@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2025.12
+ * All rights reserved.
+ *
+ * test_skeleton.cpp
+ *
+ * 初始版本：1.0
+ * 作者：Vere
+ * 创建日期：2025年12月03日
+ * 摘要：裂纹骨架化回归测试
+ * 描述：CrackDetector 默认骨架化由形态学骨架改为 Zhang-Suen 细化，统计由逐外接矩形扫描
+ *       改为按连通域单遍统计（分支/端点按交叉数判定），结果与旧版不逐像素一致。本测试固定：
+ *       - 细化与教科书 Zhang-Suen 整图迭代实现逐像素一致（容差 0）
+ *       - 旧版模式（skeletonMethod = morphological）的统计与改造前实现逐项一致（容差 0）
+ *       - 合成裂纹场景下新旧两条路径的差异在显式容差内：
+ *         细长裂纹（外接矩形长边 >= 40 px）一个不丢；按输入连通域统计的骨架总长度之比（新/旧）
+ *         在 [0.75, 1.25] 内；骨架连通域数与分支点数不多于旧版（旧版骨架碎片化）
+ *       - 直线/十字/T 形上的端点与分支点数
+ *
+ * 当前版本：1.0
+ */
+
+#include "detectors/CrackDetector.h"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <QtTest>
+
+namespace {
+
+// 新旧骨架总长度之比的容差（细化骨架不含形态学骨架的毛刺，总长度偏短约 5%~15%）
+const double LENGTH_RATIO_MIN = 0.75;
+const double LENGTH_RATIO_MAX = 1.25;
+// 细长裂纹：输入连通域外接矩形长边下限；骨架少于 MIN_SKELETON_PIXELS 视为丢失（与 analyzeSkeleton 一致）
+const int ELONGATED_EXTENT = 40;
+const int MIN_SKELETON_PIXELS = 10;
+
+// 合成裂纹场景：粗细不等的折线裂纹（部分带分支）与圆形斑点，按种子确定
+cv::Mat makeCrackScene(int width, int height, unsigned seed, int density) {
+  cv::Mat image = cv::Mat::zeros(height, width, CV_8UC1);
+  std::mt19937 rng(seed);
+  auto disc = [&](double cx, double cy, double radius) {
+    const int x0 = std::max(0, static_cast<int>(cx - radius));
+    const int x1 = std::min(width - 1, static_cast<int>(cx + radius));
+    const int y0 = std::max(0, static_cast<int>(cy - radius));
+    const int y1 = std::min(height - 1, static_cast<int>(cy + radius));
+    for (int y = y0; y <= y1; ++y) {
+      for (int x = x0; x <= x1; ++x) {
+        if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= radius * radius) {
+          image.at<uchar>(y, x) = 255;
+        }
+      }
+    }
+  };
+
+  const int cracks = density * width * height / 1000000;
+  for (int c = 0; c < cracks; ++c) {
+    double x = rng() % width;
+    double y = rng() % height;
+    double angle = (rng() % 360) * CV_PI / 180;
+    const double radius = 0.5 + (rng() % 50) / 10.0;
+    const int segments = 3 + rng() % 8;
+    for (int s = 0; s < segments; ++s) {
+      angle += (static_cast<int>(rng() % 61) - 30) * CV_PI / 180;
+      const int length = 10 + rng() % 60;
+      for (int k = 0; k < length; ++k) {
+        x += std::cos(angle);
+        y += std::sin(angle);
+        disc(x, y, radius);
+      }
+      if (rng() % 3 == 0) {
+        double bx = x;
+        double by = y;
+        const double branchAngle = angle + ((rng() & 1) ? 1 : -1) * (0.5 + (rng() % 10) / 10.0);
+        for (int k = 0; k < 30; ++k) {
+          bx += std::cos(branchAngle);
+          by += std::sin(branchAngle);
+          disc(bx, by, std::max(0.5, radius * 0.6));
+        }
+      }
+    }
+  }
+  for (int b = 0; b < cracks / 2; ++b) {
+    disc(rng() % width, rng() % height, 2 + rng() % 8);
+  }
+  return image;
+}
+
+// 教科书 Zhang-Suen：整图迭代，逐像素直接判定删除条件
+cv::Mat referenceZhangSuen(const cv::Mat& binary) {
+  cv::Mat img;
+  cv::copyMakeBorder(binary, img, 1, 1, 1, 1, cv::BORDER_CONSTANT, 0);
+  img = img > 0;
+  img /= 255;
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int pass = 0; pass < 2; ++pass) {
+      std::vector<cv::Point> removed;
+      for (int y = 1; y < img.rows - 1; ++y) {
+        for (int x = 1; x < img.cols - 1; ++x) {
+          if (img.at<uchar>(y, x) == 0) continue;
+          const int p2 = img.at<uchar>(y - 1, x), p3 = img.at<uchar>(y - 1, x + 1);
+          const int p4 = img.at<uchar>(y, x + 1), p5 = img.at<uchar>(y + 1, x + 1);
+          const int p6 = img.at<uchar>(y + 1, x), p7 = img.at<uchar>(y + 1, x - 1);
+          const int p8 = img.at<uchar>(y, x - 1), p9 = img.at<uchar>(y - 1, x - 1);
+          const int b = p2 + p3 + p4 + p5 + p6 + p7 + p8 + p9;
+          const int a = (!p2 && p3) + (!p3 && p4) + (!p4 && p5) + (!p5 && p6) +
+                        (!p6 && p7) + (!p7 && p8) + (!p8 && p9) + (!p9 && p2);
+          const bool side = pass == 0 ? (p2 * p4 * p6 == 0 && p4 * p6 * p8 == 0)
+                                      : (p2 * p4 * p8 == 0 && p2 * p6 * p8 == 0);
+          if (b >= 2 && b <= 6 && a == 1 && side) {
+            removed.emplace_back(x, y);
+          }
+        }
+      }
+      for (const cv::Point& p : removed) {
+        img.at<uchar>(p) = 0;
+      }
+      changed = changed || !removed.empty();
+    }
+  }
+  return img(cv::Rect(1, 1, binary.cols, binary.rows)) * 255;
+}
+
+// 改造前的逐外接矩形统计（边框一圈不计）
+int legacyBranchPoints(const cv::Mat& skeleton, const cv::Rect& roi) {
+  const cv::Mat region = skeleton(roi);
+  int branchPoints = 0;
+  for (int y = 1; y < region.rows - 1; ++y) {
+    for (int x = 1; x < region.cols - 1; ++x) {
+      if (region.at<uchar>(y, x) == 0) continue;
+      int neighbors = 0;
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          if ((dx || dy) && region.at<uchar>(y + dy, x + dx) > 0) {
+            neighbors++;
+          }
+        }
+      }
+      if (neighbors >= 3) {
+        branchPoints++;
+      }
+    }
+  }
+  return branchPoints;
+}
+
+double legacyLength(const cv::Mat& skeleton, const cv::Rect& roi) {
+  const cv::Mat region = skeleton(roi);
+  double length = 0;
+  for (int y = 1; y < region.rows - 1; ++y) {
+    for (int x = 1; x < region.cols - 1; ++x) {
+      if (region.at<uchar>(y, x) == 0) continue;
+      const bool diagonal = region.at<uchar>(y - 1, x - 1) > 0 || region.at<uchar>(y - 1, x + 1) > 0 ||
+                            region.at<uchar>(y + 1, x - 1) > 0 || region.at<uchar>(y + 1, x + 1) > 0;
+      const bool orthogonal = region.at<uchar>(y - 1, x) > 0 || region.at<uchar>(y + 1, x) > 0 ||
+                              region.at<uchar>(y, x - 1) > 0 || region.at<uchar>(y, x + 1) > 0;
+      if (diagonal && !orthogonal) {
+        length += std::sqrt(2.0) / 2.0;
+      } else if (!diagonal && orthogonal) {
+        length += 0.5;
+      } else {
+        length += 0.75;
+      }
+    }
+  }
+  return std::max(length, static_cast<double>(cv::countNonZero(region)) * 0.8);
+}
+
+// 骨架整体统计（只计像素数 >= MIN_SKELETON_PIXELS 的连通域，与 analyzeSkeleton 一致）
+struct SceneSummary {
+  int components = 0;
+  int branchPoints = 0;
+};
+
+SceneSummary summarize(const cv::Mat& skeleton, bool legacy) {
+  cv::Mat labels, stats, centroids;
+  const int numLabels = cv::connectedComponentsWithStats(skeleton, labels, stats, centroids, 8, CV_32S);
+  const std::vector<CrackDetector::SkeletonStats> measured =
+      legacy ? CrackDetector::measureSkeletonsByBox(skeleton, stats, numLabels)
+             : CrackDetector::measureSkeletons(skeleton, labels, numLabels);
+  SceneSummary summary;
+  for (int i = 1; i < numLabels; ++i) {
+    if (stats.at<int>(i, cv::CC_STAT_AREA) < MIN_SKELETON_PIXELS) continue;
+    summary.components++;
+    summary.branchPoints += measured[i].branchPoints;
+  }
+  return summary;
+}
+
+// 单个骨架图（只含一个输入连通域内的骨架）上各连通域统计
+std::vector<CrackDetector::SkeletonStats> measureThinned(const cv::Mat& skeleton) {
+  cv::Mat labels;
+  const int numLabels = cv::connectedComponents(skeleton, labels, 8, CV_32S);
+  return CrackDetector::measureSkeletons(skeleton, labels, numLabels);
+}
+
+} // namespace
+
+class TestSkeleton : public QObject {
+  Q_OBJECT
+
+private slots:
+  // 细化结果与教科书实现逐像素一致
+  void thinningMatchesReferenceZhangSuen() {
+    const CancellationToken cancel;
+    for (unsigned seed = 1; seed <= 40; ++seed) {
+      const cv::Mat scene = makeCrackScene(64 + seed * 13 % 400, 48 + seed * 29 % 300, seed, 400 + seed * 50);
+      const cv::Mat skeleton = CrackDetector::skeletonize(scene, cancel);
+      QCOMPARE(skeleton.size(), scene.size());
+      QCOMPARE(cv::countNonZero(skeleton != referenceZhangSuen(scene)), 0);
+      // 骨架是输入前景的子集
+      QCOMPARE(cv::countNonZero(skeleton & ~scene), 0);
+    }
+  }
+
+  // 旧版模式的统计与改造前实现逐项一致
+  void legacyStatsMatchPreviousImplementation() {
+    const CancellationToken cancel;
+    for (unsigned seed = 200; seed < 204; ++seed) {
+      const cv::Mat scene = makeCrackScene(640, 480, seed, 150);
+      const cv::Mat skeleton = CrackDetector::skeletonizeMorphological(scene, cancel);
+      QVERIFY(!skeleton.empty());
+
+      cv::Mat labels, stats, centroids;
+      const int numLabels = cv::connectedComponentsWithStats(skeleton, labels, stats, centroids, 8, CV_32S);
+      const std::vector<CrackDetector::SkeletonStats> measured =
+          CrackDetector::measureSkeletonsByBox(skeleton, stats, numLabels);
+      QCOMPARE(static_cast<int>(measured.size()), numLabels);
+      for (int i = 1; i < numLabels; ++i) {
+        const cv::Rect bbox(stats.at<int>(i, cv::CC_STAT_LEFT), stats.at<int>(i, cv::CC_STAT_TOP),
+                            stats.at<int>(i, cv::CC_STAT_WIDTH), stats.at<int>(i, cv::CC_STAT_HEIGHT));
+        QCOMPARE(measured[i].branchPoints, legacyBranchPoints(skeleton, bbox));
+        QCOMPARE(measured[i].length, legacyLength(skeleton, bbox));
+        QCOMPARE(measured[i].endPoints, 0);
+      }
+    }
+  }
+
+  // 新旧两条路径在合成裂纹场景上的差异不超过显式容差
+  void thinningStaysWithinToleranceOfMorphological() {
+    const CancellationToken cancel;
+    const struct {
+      unsigned seed;
+      cv::Size size;
+      int density;
+    } scenes[] = {{100, {1000, 800}, 60}, {101, {1000, 800}, 60}, {102, {1000, 800}, 60},
+                  {103, {1000, 800}, 60}, {104, {400, 300}, 200}, {105, {400, 300}, 200},
+                  {106, {400, 300}, 200}, {107, {400, 300}, 200}, {108, {400, 300}, 200}};
+
+    for (const auto& s : scenes) {
+      const cv::Mat scene = makeCrackScene(s.size.width, s.size.height, s.seed, s.density);
+      const cv::Mat legacy = CrackDetector::skeletonizeMorphological(scene, cancel);
+      const cv::Mat thinned = CrackDetector::skeletonize(scene, cancel);
+
+      // 按输入连通域分别比较：细长裂纹不丢失，长度之和在容差内
+      cv::Mat inputLabels, inputStats, centroids;
+      const int numInputs = cv::connectedComponentsWithStats(scene, inputLabels, inputStats, centroids, 8, CV_32S);
+      double legacyTotal = 0.0;
+      double thinnedTotal = 0.0;
+      int elongated = 0;
+      for (int i = 1; i < numInputs; ++i) {
+        const cv::Rect bbox(inputStats.at<int>(i, cv::CC_STAT_LEFT), inputStats.at<int>(i, cv::CC_STAT_TOP),
+                            inputStats.at<int>(i, cv::CC_STAT_WIDTH), inputStats.at<int>(i, cv::CC_STAT_HEIGHT));
+        if (std::max(bbox.width, bbox.height) < ELONGATED_EXTENT) continue;
+        elongated++;
+
+        const cv::Mat mask = inputLabels == i;
+        const cv::Mat legacyPart = legacy & mask;
+        const cv::Mat thinnedPart = thinned & mask;
+        QVERIFY2(cv::countNonZero(thinnedPart) >= MIN_SKELETON_PIXELS,
+                 qPrintable(QString("seed %1: elongated crack at (%2,%3) lost by thinning")
+                                .arg(s.seed).arg(bbox.x).arg(bbox.y)));
+
+        legacyTotal += legacyLength(legacyPart, bbox);
+        for (const CrackDetector::SkeletonStats& part : measureThinned(thinnedPart)) {
+          thinnedTotal += part.length;
+        }
+      }
+      QVERIFY(elongated > 0);
+      const double ratio = thinnedTotal / legacyTotal;
+      QVERIFY2(ratio >= LENGTH_RATIO_MIN && ratio <= LENGTH_RATIO_MAX,
+               qPrintable(QString("seed %1: skeleton length ratio %2 outside [%3, %4]")
+                              .arg(s.seed).arg(ratio).arg(LENGTH_RATIO_MIN).arg(LENGTH_RATIO_MAX)));
+
+      // 整图：细化骨架不比形态学骨架更碎，分支点不更多
+      const SceneSummary before = summarize(legacy, true);
+      const SceneSummary after = summarize(thinned, false);
+      QVERIFY(after.components <= before.components);
+      QVERIFY(after.branchPoints <= before.branchPoints);
+    }
+  }
+
+  // 简单形状上的端点与分支点
+  void endpointsAndBranchesOnSimpleShapes() {
+    const CancellationToken cancel;
+    for (int thickness : {1, 3, 5}) {
+      cv::Mat bar = cv::Mat::zeros(40, 240, CV_8UC1);
+      bar(cv::Rect(20, 20 - thickness / 2, 200, thickness)).setTo(255);
+      const std::vector<CrackDetector::SkeletonStats> barStats =
+          measureThinned(CrackDetector::skeletonize(bar, cancel));
+      QCOMPARE(static_cast<int>(barStats.size()), 2);
+      QCOMPARE(barStats[1].endPoints, 2);
+      QCOMPARE(barStats[1].branchPoints, 0);
+      QVERIFY(barStats[1].length >= 0.75 * 200 && barStats[1].length <= 200);
+
+      cv::Mat cross = cv::Mat::zeros(160, 160, CV_8UC1);
+      cross(cv::Rect(20, 80 - thickness / 2, 120, thickness)).setTo(255);
+      cross(cv::Rect(80 - thickness / 2, 20, thickness, 120)).setTo(255);
+      const std::vector<CrackDetector::SkeletonStats> crossStats =
+          measureThinned(CrackDetector::skeletonize(cross, cancel));
+      QCOMPARE(static_cast<int>(crossStats.size()), 2);
+      QCOMPARE(crossStats[1].endPoints, 4);
+      QVERIFY(crossStats[1].branchPoints >= 1);
+
+      cv::Mat tee = cv::Mat::zeros(160, 160, CV_8UC1);
+      tee(cv::Rect(20, 80 - thickness / 2, 120, thickness)).setTo(255);
+      tee(cv::Rect(80 - thickness / 2, 80, thickness, 60)).setTo(255);
+      const std::vector<CrackDetector::SkeletonStats> teeStats =
+          measureThinned(CrackDetector::skeletonize(tee, cancel));
+      QCOMPARE(static_cast<int>(teeStats.size()), 2);
+      QCOMPARE(teeStats[1].endPoints, 3);
+      QVERIFY(teeStats[1].branchPoints >= 1);
+    }
+  }
+};
+
+QTEST_GUILESS_MAIN(TestSkeleton)
+#include "test_skeleton.moc"
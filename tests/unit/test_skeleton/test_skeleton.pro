@@ -0,0 +1,14 @@
+# =============================================================================
+# test_skeleton - 裂纹骨架化回归：细化与参考实现一致，新旧骨架差异在显式容差内
+# =============================================================================
+
+include($$PWD/../../tests.pri)
+
+TARGET = test_skeleton
+QT += testlib
+CONFIG += testcase
+
+LIBS += -lalgorithm
+
+SOURCES += \
+    test_skeleton.cpp
@@ -0,0 +1,8 @@
+# =============================================================================
+# unit - 单元测试（Qt Test），make check 运行全部用例
+# =============================================================================
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    test_early_exit \
+    test_skeleton